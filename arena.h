@@ -0,0 +1,335 @@
+#ifndef ARENA_H_INCLUDED
+#define ARENA_H_INCLUDED
+
+/**********************************************************************************
+* Arena (bump) allocator
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* arena.h */
+
+/* defines:
+
+  struct arena                          - arena: chain of memory chunks and the free space in the current chunk,
+  struct arena_mark                     - checkpoint of the arena,
+
+  arena_init(a, chunk_size)             - initialize empty arena, no memory is allocated,
+                                          chunk_size - min size of chunks, 0 - default ARENA_CHUNK_SIZE,
+  arena_destroy(a)                      - free all chunks of the arena,
+  arena_reset(a)                        - free all allocated objects, keep the current chunk for reuse,
+  arena_alloc(a, size, align)           - allocate size bytes aligned on align (power of 2), NULL if out of memory,
+  arena_strdup(a, s)                    - copy '\0'-terminated string to the arena, NULL if out of memory,
+  arena_mark(a, m)                      - remember the state of the arena,
+  arena_release(a, m)                   - free objects allocated after the mark, chunks allocated after the mark
+                                          are returned to the system,
+
+  ARENA_NEW(a, type)                    - allocate an object of given type, not initialized,
+  ARENA_NEW_ARRAY(a, type, n)           - allocate an array of n objects, NULL if out of memory or n is too big,
+
+  ARENA_CHUNK_SIZE                      - default min size of chunks, 64K,
+  ARENA_HUGE_PAGES                      - if defined, chunks are allocated in huge pages (2M by default),
+  ARENA_ALLOC_CHUNK(size)               - allocate memory for a chunk,
+  ARENA_FREE_CHUNK(p, size)             - free memory of a chunk.
+
+  Objects allocated in the arena are not freed separately: they are freed all at once by arena_reset(),
+  arena_release() or arena_destroy().
+*/
+
+/* usage:
+
+struct arena req_arena;
+arena_init(&req_arena, 0);
+
+for (;;) {
+	// parse request
+	struct header *const h = ARENA_NEW(&req_arena, struct header);
+	h->name = arena_strdup(&req_arena, name);
+	...
+	// nested scope: free temporary data
+	struct arena_mark m;
+	arena_mark(&req_arena, &m);
+	char *const tmp = (char*)arena_alloc(&req_arena, len, 1);
+	...
+	arena_release(&req_arena, &m);
+	...
+	// request is done: free all its data
+	arena_reset(&req_arena);
+}
+
+arena_destroy(&req_arena);
+*/
+
+/* Implementation notes:
+
+  1) an allocation is an increment of the pointer to the free space of the current chunk,
+    adjusted for the alignment - only when the chunk is exhausted, a new chunk is allocated,
+  2) chunks are linked to the previous ones, so all chunks are freed in O(number of chunks),
+  3) a request bigger than chunk_size gets its own chunk, the rest of the current chunk is not used,
+  4) a mark is the pair of the current chunk and the position in it, arena_release() frees newer chunks
+    and restores the position - the marks must be released in reverse order,
+  5) arena_reset() keeps one (the current) chunk, so an arena reused for similar requests does not
+    allocate memory at all; marks taken before arena_reset() become invalid,
+  6) with ARENA_HUGE_PAGES, chunk sizes are rounded up to ARENA_HUGE_PAGE_SIZE: on Linux, chunks are
+    mapped on the huge page boundary and madvise(MADV_HUGEPAGE) is called, on Windows, large pages
+    are used if the process has the privilege, otherwise normal pages are used. */
+
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc() */
+#include <string.h> /* for strlen(), memcpy() */
+#include "tagged_ptr.h" /* for ALIGNOF_TYPE(), ptr_get_tags_() */
+#include "asserts.h"
+
+#ifndef ARENA_CHUNK_SIZE
+#define ARENA_CHUNK_SIZE 65536
+#endif
+
+#ifdef ARENA_HUGE_PAGES
+#ifndef ARENA_HUGE_PAGE_SIZE
+#define ARENA_HUGE_PAGE_SIZE (2*1024*1024)
+#endif
+#ifndef ARENA_ALLOC_CHUNK
+#ifdef _WIN32
+#include <windows.h>
+#define ARENA_ALLOC_CHUNK(size) arena_win_alloc_(size)
+#define ARENA_FREE_CHUNK(p, size) ((void)(size), (void)VirtualFree(p, 0, MEM_RELEASE))
+#define ARENA_WIN_ALLOC_
+#elif defined __linux__
+#include <sys/mman.h>
+#ifdef MAP_ANONYMOUS /* may be not defined in strict ISO C mode */
+#define ARENA_ALLOC_CHUNK(size) arena_mmap_(size)
+#define ARENA_FREE_CHUNK(p, size) ((void)munmap(p, size))
+#define ARENA_MMAP_
+#endif
+#endif
+#endif
+#endif /* ARENA_HUGE_PAGES */
+
+#ifndef ARENA_ALLOC_CHUNK
+#define ARENA_ALLOC_CHUNK(size) malloc(size)
+#define ARENA_FREE_CHUNK(p, size) ((void)(size), free(p))
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* header of a chunk, followed by the memory for objects */
+struct arena_chunk_ {
+	struct arena_chunk_ *prev;  /* previously allocated chunk */
+	size_t size;                /* size of the chunk, including the header */
+};
+
+struct arena {
+	char *cur;                  /* free space in the current chunk */
+	char *end;                  /* end of the current chunk */
+	struct arena_chunk_ *chunk; /* current chunk */
+	size_t chunk_size;          /* min size of a chunk */
+};
+
+struct arena_mark {
+	struct arena_chunk_ *chunk;
+	char *cur;
+};
+
+#define ARENA_NEW(a, type)            ((type*)arena_alloc(a, sizeof(type), ALIGNOF_TYPE(type)))
+#define ARENA_NEW_ARRAY(a, type, n)   ((type*)arena_alloc_array_(a, n, sizeof(type), ALIGNOF_TYPE(type)))
+
+#ifdef ARENA_MMAP_
+/* map the chunk on the huge page boundary, so it may be backed by transparent huge pages */
+static void *arena_mmap_(const size_t size)
+{
+	char *const p = (char*)mmap((void*)0, size + ARENA_HUGE_PAGE_SIZE,
+		PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	size_t head;
+	if (MAP_FAILED == (void*)p)
+		return (void*)0;
+	head = (ARENA_HUGE_PAGE_SIZE - ptr_get_tags_(p, ARENA_HUGE_PAGE_SIZE)) & (ARENA_HUGE_PAGE_SIZE - 1);
+	if (head)
+		(void)munmap(p, head);
+	(void)munmap(p + head + size, ARENA_HUGE_PAGE_SIZE - head);
+#ifdef MADV_HUGEPAGE
+	(void)madvise(p + head, size, MADV_HUGEPAGE);
+#endif
+	return p + head;
+}
+#endif /* ARENA_MMAP_ */
+
+#ifdef ARENA_WIN_ALLOC_
+static void *arena_win_alloc_(const size_t size)
+{
+	const SIZE_T large = GetLargePageMinimum();
+	if (large && !(size % large)) {
+		void *const p = VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (p)
+			return p;
+	}
+	return VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+}
+#endif /* ARENA_WIN_ALLOC_ */
+
+A_Force_inline_function
+static void arena_init(
+	struct arena *const a/*!=NULL,out*/,
+	const size_t chunk_size/*0?*/)
+{
+	a->cur = (char*)0;
+	a->end = (char*)0;
+	a->chunk = (struct arena_chunk_*)0;
+	a->chunk_size = chunk_size ? chunk_size : ARENA_CHUNK_SIZE;
+}
+
+/* free chunks allocated after the given one */
+static void arena_free_chunks_(
+	struct arena *const a/*!=NULL*/,
+	struct arena_chunk_ *const last/*NULL?*/)
+{
+	struct arena_chunk_ *c = a->chunk;
+	while (c != last) {
+		struct arena_chunk_ *const prev = c->prev;
+		ARENA_FREE_CHUNK(c, c->size);
+		c = prev;
+	}
+	a->chunk = last;
+}
+
+A_Force_inline_function
+static void arena_destroy(struct arena *const a/*!=NULL*/)
+{
+	arena_free_chunks_(a, (struct arena_chunk_*)0);
+	a->cur = (char*)0;
+	a->end = (char*)0;
+}
+
+static void arena_reset(struct arena *const a/*!=NULL*/)
+{
+	struct arena_chunk_ *const c = a->chunk;
+	if (c) {
+		a->chunk = c->prev;
+		arena_free_chunks_(a, (struct arena_chunk_*)0);
+		c->prev = (struct arena_chunk_*)0;
+		a->chunk = c;
+		a->cur = (char*)(c + 1);
+	}
+}
+
+A_Force_inline_function
+static void arena_mark(
+	const struct arena *const a/*!=NULL*/,
+	struct arena_mark *const m/*!=NULL,out*/)
+{
+	m->chunk = a->chunk;
+	m->cur = a->cur;
+}
+
+static void arena_release(
+	struct arena *const a/*!=NULL*/,
+	const struct arena_mark *const m/*!=NULL*/)
+{
+	arena_free_chunks_(a, m->chunk);
+	a->cur = m->cur;
+	a->end = m->chunk ? (char*)m->chunk + m->chunk->size : (char*)0;
+}
+
+/* allocate new chunk for the object */
+static void *arena_alloc_slow_(
+	struct arena *const a/*!=NULL*/,
+	const size_t size/*>0*/,
+	const size_t align/*>0*/)
+{
+	struct arena_chunk_ *c;
+	char *p;
+	size_t csize = sizeof(*c) + align - 1 + size;
+	if (csize < size)
+		return (void*)0; /* too big */
+	if (csize < a->chunk_size)
+		csize = a->chunk_size;
+#ifdef ARENA_HUGE_PAGE_SIZE
+	if (csize > (size_t)-1 - (ARENA_HUGE_PAGE_SIZE - 1))
+		return (void*)0; /* too big */
+	csize = (csize + ARENA_HUGE_PAGE_SIZE - 1) & ~(size_t)(ARENA_HUGE_PAGE_SIZE - 1);
+#endif
+	c = (struct arena_chunk_*)ARENA_ALLOC_CHUNK(csize);
+	if (!c)
+		return (void*)0;
+	c->prev = a->chunk;
+	c->size = csize;
+	a->chunk = c;
+	a->end = (char*)c + csize;
+	p = (char*)(c + 1);
+	p += (align - ptr_get_tags_(p, (unsigned)align)) & (align - 1);
+	a->cur = p + size;
+	return p;
+}
+
+/* allocate size bytes aligned on align, returns NULL if out of memory */
+A_Force_inline_function
+static void *arena_alloc(
+	struct arena *const a/*!=NULL*/,
+	const size_t size/*>0*/,
+	const size_t align/*>0,power of 2*/)
+{
+	const size_t pad = (align - ptr_get_tags_(a->cur, (unsigned)align)) & (align - 1);
+	const size_t avail = (size_t)(a->end - a->cur);
+	ASSERT(size);
+	ASSERT(align && !(align & (align - 1)));
+	if (avail >= pad && avail - pad >= size) {
+		char *const p = a->cur + pad;
+		a->cur = p + size;
+		return p;
+	}
+	return arena_alloc_slow_(a, size, align);
+}
+
+A_Force_inline_function
+static void *arena_alloc_array_(
+	struct arena *const a/*!=NULL*/,
+	const size_t n/*>0*/,
+	const size_t size/*>0*/,
+	const size_t align/*>0*/)
+{
+	if (n > (size_t)-1/size)
+		return (void*)0; /* too big */
+	return arena_alloc(a, n*size, align);
+}
+
+static char *arena_strdup(
+	struct arena *const a/*!=NULL*/,
+	const char *const s/*!=NULL*/)
+{
+	const size_t len = strlen(s) + 1;
+	char *const p = (char*)arena_alloc(a, len, 1);
+	if (p)
+		memcpy(p, s, len);
+	return p;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int arena_reset_unused_[sizeof(&arena_reset)];
+typedef int arena_release_unused_[sizeof(&arena_release)];
+typedef int arena_alloc_slow_unused_[sizeof(&arena_alloc_slow_)];
+typedef int arena_strdup_unused_[sizeof(&arena_strdup)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* ARENA_H_INCLUDED */
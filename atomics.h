@@ -0,0 +1,261 @@
+#ifndef ATOMICS_H_INCLUDED
+#define ATOMICS_H_INCLUDED
+
+/**********************************************************************************
+* Atomic operations and thread-local storage
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* atomics.h */
+
+/* defines:
+
+  THREAD_LOCAL                              - storage class for thread-local variables,
+  CPU_RELAX()                               - hint for the CPU that current thread is spinning in a loop,
+
+  memory orders:
+  ATOMIC_RELAXED, ATOMIC_ACQUIRE, ATOMIC_RELEASE, ATOMIC_ACQ_REL, ATOMIC_SEQ_CST
+
+  operations on 4- or 8-byte integers:
+  ATOMIC_LOAD(p, mo)                        - return *p,
+  ATOMIC_STORE(p, v, mo)                    - *p = v,
+  ATOMIC_EXCHANGE(p, v, mo)                 - *p = v, return old value,
+  ATOMIC_FETCH_ADD(p, v, mo)                - *p += v, return old value,
+  ATOMIC_FETCH_SUB(p, v, mo)                - *p -= v, return old value,
+  ATOMIC_FETCH_OR(p, v, mo)                 - *p |= v, return old value,
+  ATOMIC_CAS(p, pexp, v, mo_ok, mo_fail)    - if *p == *pexp then *p = v, return 1, else *pexp = *p, return 0,
+
+  operations on pointers:
+  ATOMIC_LOAD_PTR(p, mo)
+  ATOMIC_STORE_PTR(p, v, mo)
+  ATOMIC_EXCHANGE_PTR(p, v, mo)
+  ATOMIC_CAS_PTR(p, pexp, v, mo_ok, mo_fail)
+
+  ATOMIC_FENCE(mo)                          - memory barrier.
+
+  Note: 'p' - pointer to a plain (not _Atomic) object, which is always accessed only via these macros
+   by all threads, except the owner thread that may read the object it exclusively modifies directly.
+*/
+
+#include "annotations.h" /* for A_Force_inline_function */
+
+/* THREAD_LOCAL - thread-local storage class specifier, may be combined with 'static' or 'extern' */
+#ifndef THREAD_LOCAL
+#if defined __cplusplus && __cplusplus >= 201103L
+#define THREAD_LOCAL thread_local
+#elif defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L && !defined __STDC_NO_THREADS__
+#define THREAD_LOCAL _Thread_local
+#elif defined _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#elif defined __GNUC__ || defined __clang__
+#define THREAD_LOCAL __thread
+#else
+#error unable to define THREAD_LOCAL for this compiler
+#endif
+#endif /* !THREAD_LOCAL */
+
+#if defined __GNUC__ || defined __clang__
+
+#define ATOMIC_RELAXED __ATOMIC_RELAXED
+#define ATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+#define ATOMIC_RELEASE __ATOMIC_RELEASE
+#define ATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+#define ATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+#define ATOMIC_LOAD(p, mo)                        __atomic_load_n(p, mo)
+#define ATOMIC_STORE(p, v, mo)                    __atomic_store_n(p, v, mo)
+#define ATOMIC_EXCHANGE(p, v, mo)                 __atomic_exchange_n(p, v, mo)
+#define ATOMIC_FETCH_ADD(p, v, mo)                __atomic_fetch_add(p, v, mo)
+#define ATOMIC_FETCH_SUB(p, v, mo)                __atomic_fetch_sub(p, v, mo)
+#define ATOMIC_FETCH_OR(p, v, mo)                 __atomic_fetch_or(p, v, mo)
+#define ATOMIC_CAS(p, pexp, v, mo_ok, mo_fail)    __atomic_compare_exchange_n(p, pexp, v, /*weak:*/0, mo_ok, mo_fail)
+
+#define ATOMIC_LOAD_PTR(p, mo)                    __atomic_load_n(p, mo)
+#define ATOMIC_STORE_PTR(p, v, mo)                __atomic_store_n(p, v, mo)
+#define ATOMIC_EXCHANGE_PTR(p, v, mo)             __atomic_exchange_n(p, v, mo)
+#define ATOMIC_CAS_PTR(p, pexp, v, mo_ok, mo_fail) __atomic_compare_exchange_n(p, pexp, v, /*weak:*/0, mo_ok, mo_fail)
+
+#define ATOMIC_FENCE(mo)                          __atomic_thread_fence(mo)
+
+#if defined __i386__ || defined __x86_64__
+#define CPU_RELAX() __builtin_ia32_pause()
+#elif defined __aarch64__ || (defined __arm__ && defined __ARM_ARCH && __ARM_ARCH >= 7)
+#define CPU_RELAX() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define CPU_RELAX() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#elif defined _MSC_VER
+
+/* note: interlocked operations are full memory barriers, memory orders are ignored */
+#define ATOMIC_RELAXED 0
+#define ATOMIC_ACQUIRE 2
+#define ATOMIC_RELEASE 3
+#define ATOMIC_ACQ_REL 4
+#define ATOMIC_SEQ_CST 5
+
+#include <stddef.h> /* for size_t */
+#include <intrin.h>
+
+#if defined _M_ARM || defined _M_ARM64
+#define ATOMICS_BARRIER_() __dmb(0xB/*_ARM64_BARRIER_ISH*/)
+#define CPU_RELAX() __yield()
+#else
+#define ATOMICS_BARRIER_() _ReadWriteBarrier()
+#define CPU_RELAX() _mm_pause()
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+A_Force_inline_function
+static long long atomics_load_(const volatile void *const p, const size_t sz, const int mo)
+{
+	const long long v = (8 == sz) ? *(const volatile long long*)p : *(const volatile long*)p;
+	if (mo != ATOMIC_RELAXED)
+		ATOMICS_BARRIER_();
+	return v;
+}
+
+A_Force_inline_function
+static void atomics_store_(volatile void *const p, const long long v, const size_t sz, const int mo)
+{
+	if (mo == ATOMIC_SEQ_CST) {
+		if (8 == sz)
+			(void)_InterlockedExchange64((volatile long long*)p, v);
+		else
+			(void)_InterlockedExchange((volatile long*)p, (long)v);
+		return;
+	}
+	if (mo != ATOMIC_RELAXED)
+		ATOMICS_BARRIER_();
+	if (8 == sz)
+		*(volatile long long*)p = v;
+	else
+		*(volatile long*)p = (long)v;
+}
+
+A_Force_inline_function
+static long long atomics_exchange_(volatile void *const p, const long long v, const size_t sz)
+{
+	return (8 == sz) ? _InterlockedExchange64((volatile long long*)p, v) :
+		_InterlockedExchange((volatile long*)p, (long)v);
+}
+
+A_Force_inline_function
+static long long atomics_fetch_add_(volatile void *const p, const long long v, const size_t sz)
+{
+	return (8 == sz) ? _InterlockedExchangeAdd64((volatile long long*)p, v) :
+		_InterlockedExchangeAdd((volatile long*)p, (long)v);
+}
+
+A_Force_inline_function
+static long long atomics_fetch_or_(volatile void *const p, const long long v, const size_t sz)
+{
+	return (8 == sz) ? _InterlockedOr64((volatile long long*)p, v) :
+		_InterlockedOr((volatile long*)p, (long)v);
+}
+
+A_Force_inline_function
+static int atomics_cas_(volatile void *const p, void *const pexp, const long long v, const size_t sz)
+{
+	if (8 == sz) {
+		const long long e = *(const long long*)pexp;
+		const long long o = _InterlockedCompareExchange64((volatile long long*)p, v, e);
+		if (o == e)
+			return 1;
+		*(long long*)pexp = o;
+	}
+	else {
+		const long e = *(const long*)pexp;
+		const long o = _InterlockedCompareExchange((volatile long*)p, (long)v, e);
+		if (o == e)
+			return 1;
+		*(long*)pexp = o;
+	}
+	return 0;
+}
+
+A_Force_inline_function
+static void *atomics_load_ptr_(void *const volatile *const p, const int mo)
+{
+	void *const v = *p;
+	if (mo != ATOMIC_RELAXED)
+		ATOMICS_BARRIER_();
+	return v;
+}
+
+A_Force_inline_function
+static void atomics_store_ptr_(void *volatile *const p, void *const v, const int mo)
+{
+	if (mo == ATOMIC_SEQ_CST) {
+		(void)_InterlockedExchangePointer(p, v);
+		return;
+	}
+	if (mo != ATOMIC_RELAXED)
+		ATOMICS_BARRIER_();
+	*p = v;
+}
+
+A_Force_inline_function
+static int atomics_cas_ptr_(void *volatile *const p, void **const pexp, void *const v)
+{
+	void *const e = *pexp;
+	void *const o = _InterlockedCompareExchangePointer(p, v, e);
+	if (o == e)
+		return 1;
+	*pexp = o;
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* check that operand is 4- or 8-byte integer */
+#define ATOMICS_SIZE_(p) (sizeof(*(p)) + 0*sizeof(int[1-2*(sizeof(*(p)) != 4 && sizeof(*(p)) != 8)]))
+
+#define ATOMIC_LOAD(p, mo)                        atomics_load_(p, ATOMICS_SIZE_(p), mo)
+#define ATOMIC_STORE(p, v, mo)                    atomics_store_(p, (long long)(v), ATOMICS_SIZE_(p), mo)
+#define ATOMIC_EXCHANGE(p, v, mo)                 atomics_exchange_(p, (long long)(v), ATOMICS_SIZE_(p))
+#define ATOMIC_FETCH_ADD(p, v, mo)                atomics_fetch_add_(p, (long long)(v), ATOMICS_SIZE_(p))
+#define ATOMIC_FETCH_SUB(p, v, mo)                atomics_fetch_add_(p, -(long long)(v), ATOMICS_SIZE_(p))
+#define ATOMIC_FETCH_OR(p, v, mo)                 atomics_fetch_or_(p, (long long)(v), ATOMICS_SIZE_(p))
+#define ATOMIC_CAS(p, pexp, v, mo_ok, mo_fail)    atomics_cas_(p, pexp, (long long)(v), ATOMICS_SIZE_(p) + 0*sizeof(*(p) = *(pexp)))
+
+#ifdef __cplusplus
+/* in C++, void* is not implicitly converted to T*, use templates */
+extern "C++" template <class T> A_Force_inline_function
+static T *atomics_load_ptr_t_(T *const volatile *const p, const int mo)
+{
+	return static_cast<T*>(atomics_load_ptr_((void *const volatile*)p, mo));
+}
+extern "C++" template <class T> A_Force_inline_function
+static T *atomics_exchange_ptr_t_(T *volatile *const p, T *const v)
+{
+	return static_cast<T*>(_InterlockedExchangePointer((void *volatile*)p, (void*)v));
+}
+#define ATOMIC_LOAD_PTR(p, mo)                    atomics_load_ptr_t_(p, mo)
+#define ATOMIC_EXCHANGE_PTR(p, v, mo)             atomics_exchange_ptr_t_(p, v)
+#else
+#define ATOMIC_LOAD_PTR(p, mo)                    atomics_load_ptr_((void *const volatile*)(p), mo)
+#define ATOMIC_EXCHANGE_PTR(p, v, mo)             _InterlockedExchangePointer((void *volatile*)(p), (void*)(v))
+#endif
+#define ATOMIC_STORE_PTR(p, v, mo)                ((void)sizeof(*(p) = (v)), atomics_store_ptr_((void *volatile*)(p), (void*)(v), mo))
+#define ATOMIC_CAS_PTR(p, pexp, v, mo_ok, mo_fail) ((void)sizeof(*(p) = *(pexp)), atomics_cas_ptr_((void *volatile*)(p), (void**)(pexp), (void*)(v)))
+
+#if defined _M_ARM || defined _M_ARM64
+#define ATOMIC_FENCE(mo) ((mo) == ATOMIC_RELAXED ? (void)0 : __dmb(0xB/*_ARM64_BARRIER_ISH*/))
+#elif defined _M_X64
+#define ATOMIC_FENCE(mo) ((mo) == ATOMIC_SEQ_CST ? __faststorefence() : _ReadWriteBarrier())
+#else
+#define ATOMIC_FENCE(mo) ((mo) == ATOMIC_SEQ_CST ? _mm_mfence() : _ReadWriteBarrier())
+#endif
+
+#else /* !__GNUC__ && !_MSC_VER */
+#error atomic operations are not implemented for this compiler
+#endif /* !__GNUC__ && !_MSC_VER */
+
+#endif /* ATOMICS_H_INCLUDED */
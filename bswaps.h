@@ -132,7 +132,7 @@ static inline UINT64_TYPE hswap8(UINT64_TYPE x)
 static inline int arch_is_be(void)
 {
 	const UINT32_TYPE x = 1;
-	return !(const unsigned char*)&x;
+	return !*(const unsigned char*)&x;
 }
 
 /* check if processor architecture is LITTLE-endian */
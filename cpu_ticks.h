@@ -0,0 +1,118 @@
+#ifndef CPU_TICKS_H_INCLUDED
+#define CPU_TICKS_H_INCLUDED
+
+/**********************************************************************************
+* Low-overhead CPU time-stamp counter
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* cpu_ticks.h */
+
+/* defines functions:
+
+  cpu_ticks()          - read time-stamp counter: rdtsc on x86, cntvct_el0 on arm64, monotonic clock otherwise,
+  cpu_ticks_hz()       - number of ticks per second, on x86 the first call spins for 10 ms to calibrate,
+  cpu_ticks_clock_ns() - read monotonic clock, in nanoseconds (slower than cpu_ticks()).
+
+  Note: on POSIX systems, define _POSIX_C_SOURCE >= 199309L (or _GNU_SOURCE) for clock_gettime(),
+    on Windows - #include <windows.h> before this file.
+*/
+
+#include "annotations.h"
+#include "atomics.h"
+
+#ifdef _WIN32
+/* NOTE: #include <windows.h> before this file */
+#else
+#include <time.h> /* for clock_gettime() */
+#endif
+
+#if defined _MSC_VER && (defined _M_IX86 || defined _M_X64)
+#include <intrin.h> /* for __rdtsc() */
+#define CPU_TICKS_RDTSC_() __rdtsc()
+#elif (defined __GNUC__ || defined __clang__) && (defined __i386__ || defined __x86_64__)
+#define CPU_TICKS_RDTSC_() __builtin_ia32_rdtsc()
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* read monotonic clock, in nanoseconds */
+static inline unsigned long long cpu_ticks_clock_ns(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER f; /* QueryPerformanceFrequency() never fails on Windows XP and later */
+	LARGE_INTEGER c;
+	if (!f.QuadPart)
+		(void)QueryPerformanceFrequency(&f);
+	(void)QueryPerformanceCounter(&c);
+	return (unsigned long long)c.QuadPart/(unsigned long long)f.QuadPart*1000000000ull +
+		(unsigned long long)c.QuadPart%(unsigned long long)f.QuadPart*1000000000ull/(unsigned long long)f.QuadPart;
+#else
+	struct timespec t;
+	(void)clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long long)t.tv_sec*1000000000ull + (unsigned long long)t.tv_nsec;
+#endif
+}
+
+/* read CPU time-stamp counter, not serializing: out-of-order execution may slightly shift the measured region */
+A_Force_inline_function
+static unsigned long long cpu_ticks(void)
+{
+#if defined CPU_TICKS_RDTSC_
+	return CPU_TICKS_RDTSC_();
+#elif (defined __GNUC__ || defined __clang__) && defined __aarch64__
+	unsigned long long t;
+	__asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(t));
+	return t;
+#elif defined _MSC_VER && defined _M_ARM64
+	return (unsigned long long)_ReadStatusReg(ARM64_CNTVCT);
+#else
+	return cpu_ticks_clock_ns();
+#endif
+}
+
+/* get number of cpu_ticks() per second,
+  note: on x86 the first call busy-waits for 10 ms to calibrate rdtsc against the monotonic clock,
+  so call it once at startup, not from a latency-sensitive path */
+static unsigned long long cpu_ticks_hz(void)
+{
+	static unsigned long long hz = 0;
+	unsigned long long h = ATOMIC_LOAD(&hz, ATOMIC_RELAXED);
+	if (!h) {
+#if defined CPU_TICKS_RDTSC_
+		/* calibrate against monotonic clock */
+		const unsigned long long c0 = cpu_ticks_clock_ns();
+		const unsigned long long t0 = cpu_ticks();
+		unsigned long long c1, t1;
+		do {
+			c1 = cpu_ticks_clock_ns();
+			t1 = cpu_ticks();
+		} while (c1 - c0 < 10000000/*10ms*/);
+		h = (unsigned long long)((double)(t1 - t0)*1e9/(double)(c1 - c0));
+#elif (defined __GNUC__ || defined __clang__) && defined __aarch64__
+		__asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(h));
+#elif defined _MSC_VER && defined _M_ARM64
+		h = (unsigned long long)_ReadStatusReg(ARM64_CNTFRQ);
+#else
+		h = 1000000000ull; /* cpu_ticks() returns nanoseconds */
+#endif
+		if (!h)
+			h = 1;
+		ATOMIC_STORE(&hz, h, ATOMIC_RELAXED);
+	}
+	return h;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* suppress warnings about unreferenced static functions */
+typedef int cpu_ticks_unused_[sizeof(&cpu_ticks)];
+typedef int cpu_ticks_hz_unused_[sizeof(&cpu_ticks_hz)];
+typedef int cpu_ticks_clock_ns_unused_[sizeof(&cpu_ticks_clock_ns)];
+
+#endif /* CPU_TICKS_H_INCLUDED */
@@ -0,0 +1,197 @@
+#ifndef DCOUNTERS_H_INCLUDED
+#define DCOUNTERS_H_INCLUDED
+
+/**********************************************************************************
+* Debug counters with per-thread sharding
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dcounters.h */
+
+/* defines macros:
+
+  DCOUNTER_DEFINE(name)      - define a static counter,
+  DCOUNTER_ADD(name, n)      - add n to the counter,
+  DCOUNTER_INC(name)         - add 1 to the counter,
+  DCOUNTER_GET(name)         - get counter value - sum of values of all per-thread shards,
+  DCOUNTER_DUMP(name)        - print counter value via DBGPRINT(),
+  DCOUNTERS_DUMP()           - print values of all used counters defined in current translation unit,
+  DCOUNTERS_DUMP_HOOK        - name of void(void) function that prints all counters, may be passed to atexit().
+
+  Counters are enabled if debug printing is enabled (see dprint.h), unless DCOUNTERS_DISABLE is defined.
+*/
+
+/* usage:
+
+DCOUNTER_DEFINE(bytes_read);
+
+void on_read(size_t n)
+{
+	DCOUNTER_ADD(bytes_read, n);
+}
+
+int main(void)
+{
+	(void)atexit(DCOUNTERS_DUMP_HOOK);
+	...
+}
+*/
+
+/* Implementation notes:
+
+  1) each thread increments its own shard of the counter - a structure of the size of a cache line,
+    using plain (relaxed) stores, so incrementing a counter costs few cycles and never causes cache-line ping-pong,
+  2) a shard is allocated on the first increment of the counter by the thread, shards are never freed
+    - values counted by finished threads are retained,
+  3) counters and the list of counters for dumping are local to a translation unit. */
+
+#include "dprint.h" /* for DBGPRINT() */
+
+#if (defined DPRINT_TO_LOG || defined DPRINT_TO_STREAM) && !defined DCOUNTERS_DISABLE
+
+#include <stdlib.h> /* for malloc() */
+#include "atomics.h"
+#include "layout_asserts.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* per-thread shard of a counter, occupies one cache line */
+struct dcounter_shard {
+	unsigned long long value;     /* modified only by the owner thread */
+	struct dcounter_shard *next;  /* next shard of the same counter */
+	char pad[CACHE_LINE_SIZE - sizeof(unsigned long long) - sizeof(void*)];
+};
+
+STATIC_ASSERT_NO_PADDING(struct dcounter_shard, value, next, pad);
+
+struct dcounter {
+	const char *name;
+	struct dcounter_shard *shards; /* lock-free list of per-thread shards */
+	struct dcounter *next;         /* next registered counter */
+	unsigned long long overflow;   /* atomically updated if failed to allocate a shard */
+	int registered;                /* non-zero if counter was added to the list of used counters */
+};
+
+/* list of used counters of current translation unit */
+static struct dcounter *dcounters_list_ = NULL;
+
+/* allocate a shard for current thread, register the counter on first use, returns NULL if out of memory */
+A_Non_inline_function
+static struct dcounter_shard *dcounter_shard_new_(
+	struct dcounter *const c/*!=NULL*/,
+	struct dcounter_shard **const tls/*!=NULL,out*/)
+{
+	/* never freed: allocate cache line-aligned memory, shard values must outlive threads */
+	char *const m = (char*)malloc(2*CACHE_LINE_SIZE - 1);
+	struct dcounter_shard *s;
+	if (!m)
+		return NULL;
+	s = (struct dcounter_shard*)(void*)(m + (CACHE_LINE_SIZE - (size_t)(void*)m % CACHE_LINE_SIZE) % CACHE_LINE_SIZE);
+	s->value = 0;
+	s->next = ATOMIC_LOAD_PTR(&c->shards, ATOMIC_RELAXED);
+	while (!ATOMIC_CAS_PTR(&c->shards, &s->next, s, ATOMIC_RELEASE, ATOMIC_RELAXED)) {
+		/* s->next was updated, retry */
+	}
+	{
+		int r = 0;
+		if (ATOMIC_CAS(&c->registered, &r, 1, ATOMIC_RELAXED, ATOMIC_RELAXED)) {
+			c->next = ATOMIC_LOAD_PTR(&dcounters_list_, ATOMIC_RELAXED);
+			while (!ATOMIC_CAS_PTR(&dcounters_list_, &c->next, c, ATOMIC_RELEASE, ATOMIC_RELAXED)) {
+				/* c->next was updated, retry */
+			}
+		}
+	}
+	*tls = s;
+	return s;
+}
+
+A_Force_inline_function
+static void dcounter_add_(
+	struct dcounter *const c/*!=NULL*/,
+	struct dcounter_shard **const tls/*!=NULL,in/out*/,
+	const unsigned long long n)
+{
+	struct dcounter_shard *s = *tls;
+	if (!s) {
+		s = dcounter_shard_new_(c, tls);
+		if (!s) {
+			(void)ATOMIC_FETCH_ADD(&c->overflow, n, ATOMIC_RELAXED);
+			return;
+		}
+	}
+	/* no need for atomic increment - the shard is modified only by current thread */
+	ATOMIC_STORE(&s->value, s->value + n, ATOMIC_RELAXED);
+}
+
+/* sum up values of all shards, values of shards may be modified concurrently */
+static unsigned long long dcounter_get_(const struct dcounter *const c/*!=NULL*/)
+{
+	unsigned long long sum = ATOMIC_LOAD(&c->overflow, ATOMIC_RELAXED);
+	const struct dcounter_shard *s = ATOMIC_LOAD_PTR(&c->shards, ATOMIC_ACQUIRE);
+	for (; s; s = s->next)
+		sum += ATOMIC_LOAD(&s->value, ATOMIC_RELAXED);
+	return sum;
+}
+
+static void dcounter_dump_(const struct dcounter *const c/*!=NULL*/)
+{
+	DBGPRINT("counter %s = %llu", c->name, dcounter_get_(c));
+}
+
+static void dcounters_dump_(void)
+{
+	const struct dcounter *c = ATOMIC_LOAD_PTR(&dcounters_list_, ATOMIC_ACQUIRE);
+	for (; c; c = c->next)
+		dcounter_dump_(c);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* suppress warnings about unreferenced static functions */
+typedef int dcounter_get_unused_[sizeof(&dcounter_get_)];
+typedef int dcounter_dump_unused_[sizeof(&dcounter_dump_)];
+typedef int dcounters_dump_unused_[sizeof(&dcounters_dump_)];
+
+/* the counter may be not used, e.g. if incremented only in some configurations */
+#define DCOUNTER_DEFINE(name) \
+	static struct dcounter name = {#name, NULL, NULL, 0, 0}; \
+	static THREAD_LOCAL struct dcounter_shard *name##_dcounter_shard_ = NULL; \
+	typedef int name##_unused_[sizeof(&name) + sizeof(&name##_dcounter_shard_)]
+
+#define DCOUNTER_ADD(name, n)  dcounter_add_(&name, &name##_dcounter_shard_, n)
+#define DCOUNTER_INC(name)     DCOUNTER_ADD(name, 1)
+#define DCOUNTER_GET(name)     dcounter_get_(&name)
+#define DCOUNTER_DUMP(name)    dcounter_dump_(&name)
+#define DCOUNTERS_DUMP()       dcounters_dump_()
+#define DCOUNTERS_DUMP_HOOK    dcounters_dump_
+
+#else /* !DPRINT_TO_LOG && !DPRINT_TO_STREAM || DCOUNTERS_DISABLE */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void dcounters_dump_(void) {}
+
+#ifdef __cplusplus
+}
+#endif
+
+typedef int dcounters_dump_unused_[sizeof(&dcounters_dump_)];
+
+#define DCOUNTER_DEFINE(name)  struct dcounter
+#define DCOUNTER_ADD(name, n)  ((void)(n))
+#define DCOUNTER_INC(name)     ((void)0)
+#define DCOUNTER_GET(name)     0ull
+#define DCOUNTER_DUMP(name)    ((void)0)
+#define DCOUNTERS_DUMP()       ((void)0)
+#define DCOUNTERS_DUMP_HOOK    dcounters_dump_
+
+#endif /* !DPRINT_TO_LOG && !DPRINT_TO_STREAM || DCOUNTERS_DISABLE */
+
+#endif /* DCOUNTERS_H_INCLUDED */
@@ -0,0 +1,277 @@
+#ifndef DLIST_H_INCLUDED
+#define DLIST_H_INCLUDED
+
+/**********************************************************************************
+* Intrusive doubly-linked list
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dlist.h */
+
+/* defines:
+
+  struct dlist_entry                    - list link, embedded in a list element, also used as the list head,
+
+  dlist_init(head)                      - initialize empty list (or unlinked element),
+  dlist_is_empty(head)                  - check if list has no elements,
+  dlist_is_single(head)                 - check if list has exactly one element,
+  dlist_insert_after(pos, e)            - link element after given one (or at the beginning of the list, if pos is the head),
+  dlist_insert_before(pos, e)           - link element before given one (or at the end of the list, if pos is the head),
+  dlist_add_head(head, e)               - link element at the beginning of the list,
+  dlist_add_tail(head, e)               - link element at the end of the list,
+  dlist_remove(e)                       - unlink element,
+  dlist_remove_init(e)                  - unlink element and re-initialize it, so dlist_is_empty(e) returns true,
+  dlist_move_head(head, e)              - move linked element to the beginning of the list (e.g. on access to LRU entry),
+  dlist_move_tail(head, e)              - move linked element to the end of the list,
+  dlist_splice_head(head, list)         - move all elements of the list to the beginning of another list,
+  dlist_splice_tail(head, list)         - move all elements of the list to the end of another list,
+  dlist_first(head), dlist_last(head)   - first/last element or NULL if the list is empty,
+  dlist_next(head, e), dlist_prev(head, e) - next/previous element or NULL,
+
+  DLIST_ENTRY(e, type, member)          - get element containing the link, CONTAINER_OF() (see "ccasts.h"),
+  DLIST_OPT_ENTRY(e, type, member)      - same as DLIST_ENTRY(), but returns NULL if e is NULL,
+  DLIST_FOR_EACH(e, head)               - iterate over the list,
+  DLIST_FOR_EACH_REVERSE(e, head)       - iterate over the list backward,
+  DLIST_FOR_EACH_SAFE(e, n, head)       - iterate over the list, current element may be unlinked.
+
+  All operations are O(1), except iteration. The list does not allocate memory: the link is a member
+  of the element, so an element is linked without allocation and is unlinked without searching the list.
+*/
+
+/* usage:
+
+struct conn {
+	int fd;
+	struct dlist_entry lru; // link in the LRU list
+};
+
+struct dlist_entry lru_list;
+dlist_init(&lru_list);
+
+// on access to a connection: make it most recently used
+dlist_move_head(&lru_list, &c->lru);
+
+// close least recently used connection
+struct conn *const oldest = DLIST_OPT_ENTRY(dlist_last(&lru_list), struct conn, lru);
+
+// iterate over the list, the type of the iterator defines constness of elements
+void print_conns(const struct dlist_entry *const list)
+{
+	const struct dlist_entry *e;
+	DLIST_FOR_EACH(e, list) {
+		const struct conn *const c = DLIST_ENTRY(e, const struct conn, lru);
+		printf("%d\n", c->fd);
+	}
+}
+*/
+
+/* Implementation notes:
+
+  1) the list is circular, the head is a link that is not embedded in an element,
+    so inserting or unlinking an element never checks for the beginning or the end of the list,
+  2) an unlinked element is not modified by dlist_remove() - use dlist_remove_init(), if the element
+    should then be checked for being linked via !dlist_is_empty(e). */
+
+#include "ccasts.h" /* for CONTAINER_OF(), ASSERT() */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* list link or head of the list */
+struct dlist_entry {
+	struct dlist_entry *next;
+	struct dlist_entry *prev;
+};
+
+A_Force_inline_function
+static void dlist_init(struct dlist_entry *const head/*!=NULL,out*/)
+{
+	head->next = head;
+	head->prev = head;
+}
+
+A_Force_inline_function
+static int dlist_is_empty(const struct dlist_entry *const head/*!=NULL*/)
+{
+	return head->next == head;
+}
+
+A_Force_inline_function
+static int dlist_is_single(const struct dlist_entry *const head/*!=NULL*/)
+{
+	return head->next != head && head->next == head->prev;
+}
+
+/* link an element between two adjacent ones */
+A_Force_inline_function
+static void dlist_link_(
+	struct dlist_entry *const prev/*!=NULL*/,
+	struct dlist_entry *const next/*!=NULL*/,
+	struct dlist_entry *const e/*!=NULL,out*/)
+{
+	ASSERT(prev->next == next && next->prev == prev); /* list is corrupted */
+	e->next = next;
+	e->prev = prev;
+	prev->next = e;
+	next->prev = e;
+}
+
+A_Force_inline_function
+static void dlist_insert_after(
+	struct dlist_entry *const pos/*!=NULL*/,
+	struct dlist_entry *const e/*!=NULL,not linked*/)
+{
+	dlist_link_(pos, pos->next, e);
+}
+
+A_Force_inline_function
+static void dlist_insert_before(
+	struct dlist_entry *const pos/*!=NULL*/,
+	struct dlist_entry *const e/*!=NULL,not linked*/)
+{
+	dlist_link_(pos->prev, pos, e);
+}
+
+A_Force_inline_function
+static void dlist_add_head(
+	struct dlist_entry *const head/*!=NULL*/,
+	struct dlist_entry *const e/*!=NULL,not linked*/)
+{
+	dlist_link_(head, head->next, e);
+}
+
+A_Force_inline_function
+static void dlist_add_tail(
+	struct dlist_entry *const head/*!=NULL*/,
+	struct dlist_entry *const e/*!=NULL,not linked*/)
+{
+	dlist_link_(head->prev, head, e);
+}
+
+A_Force_inline_function
+static void dlist_remove(struct dlist_entry *const e/*!=NULL,linked*/)
+{
+	struct dlist_entry *const next = e->next;
+	struct dlist_entry *const prev = e->prev;
+	ASSERT(next->prev == e && prev->next == e); /* list is corrupted or element is not linked */
+	prev->next = next;
+	next->prev = prev;
+}
+
+A_Force_inline_function
+static void dlist_remove_init(struct dlist_entry *const e/*!=NULL,linked*/)
+{
+	dlist_remove(e);
+	dlist_init(e);
+}
+
+A_Force_inline_function
+static void dlist_move_head(
+	struct dlist_entry *const head/*!=NULL*/,
+	struct dlist_entry *const e/*!=NULL,linked*/)
+{
+	if (head->next != e) {
+		dlist_remove(e);
+		dlist_link_(head, head->next, e);
+	}
+}
+
+A_Force_inline_function
+static void dlist_move_tail(
+	struct dlist_entry *const head/*!=NULL*/,
+	struct dlist_entry *const e/*!=NULL,linked*/)
+{
+	if (head->prev != e) {
+		dlist_remove(e);
+		dlist_link_(head->prev, head, e);
+	}
+}
+
+/* move all elements of the list between two adjacent elements, the list becomes empty */
+A_Force_inline_function
+static void dlist_splice_(
+	struct dlist_entry *const list/*!=NULL,!empty*/,
+	struct dlist_entry *const prev/*!=NULL*/,
+	struct dlist_entry *const next/*!=NULL*/)
+{
+	struct dlist_entry *const first = list->next;
+	struct dlist_entry *const last = list->prev;
+	ASSERT(prev->next == next && next->prev == prev); /* list is corrupted */
+	first->prev = prev;
+	prev->next = first;
+	last->next = next;
+	next->prev = last;
+	dlist_init(list);
+}
+
+A_Force_inline_function
+static void dlist_splice_head(
+	struct dlist_entry *const head/*!=NULL*/,
+	struct dlist_entry *const list/*!=NULL,!=head*/)
+{
+	if (!dlist_is_empty(list))
+		dlist_splice_(list, head, head->next);
+}
+
+A_Force_inline_function
+static void dlist_splice_tail(
+	struct dlist_entry *const head/*!=NULL*/,
+	struct dlist_entry *const list/*!=NULL,!=head*/)
+{
+	if (!dlist_is_empty(list))
+		dlist_splice_(list, head->prev, head);
+}
+
+/* note: like strchr(), these functions return non-const pointers for a const list,
+  to preserve constness, cast the result to a pointer to const or use DLIST_ENTRY() with a const type */
+
+A_Force_inline_function
+static struct dlist_entry *dlist_first(const struct dlist_entry *const head/*!=NULL*/)
+{
+	return head->next != head ? head->next : (struct dlist_entry*)0;
+}
+
+A_Force_inline_function
+static struct dlist_entry *dlist_last(const struct dlist_entry *const head/*!=NULL*/)
+{
+	return head->prev != head ? head->prev : (struct dlist_entry*)0;
+}
+
+A_Force_inline_function
+static struct dlist_entry *dlist_next(
+	const struct dlist_entry *const head/*!=NULL*/,
+	const struct dlist_entry *const e/*!=NULL,linked*/)
+{
+	return e->next != head ? e->next : (struct dlist_entry*)0;
+}
+
+A_Force_inline_function
+static struct dlist_entry *dlist_prev(
+	const struct dlist_entry *const head/*!=NULL*/,
+	const struct dlist_entry *const e/*!=NULL,linked*/)
+{
+	return e->prev != head ? e->prev : (struct dlist_entry*)0;
+}
+
+/* get element containing the link, e - pointer to const link requires const type */
+#define DLIST_ENTRY(e, type, member)      CONTAINER_OF(e, type, member)
+#define DLIST_OPT_ENTRY(e, type, member)  OPT_CONTAINER_OF(e, type, member)
+
+/* e - iterator, pointer to (const?) struct dlist_entry */
+#define DLIST_FOR_EACH(e, head) \
+	for ((e) = (head)->next; (e) != (head); (e) = (e)->next)
+
+#define DLIST_FOR_EACH_REVERSE(e, head) \
+	for ((e) = (head)->prev; (e) != (head); (e) = (e)->prev)
+
+/* n - temporary pointer to the next link, current element e may be unlinked in the loop */
+#define DLIST_FOR_EACH_SAFE(e, n, head) \
+	for ((e) = (head)->next, (n) = (e)->next; (e) != (head); (e) = (n), (n) = (e)->next)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DLIST_H_INCLUDED */
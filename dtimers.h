@@ -0,0 +1,344 @@
+#ifndef DTIMERS_H_INCLUDED
+#define DTIMERS_H_INCLUDED
+
+/**********************************************************************************
+* Debug scoped timers with per-thread latency histograms
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dtimers.h */
+
+/* defines macros:
+
+  DTIMER_DEFINE(name)          - define a static timer,
+  SCOPED_TIMER(name)           - measure time from this point to the end of enclosing scope (C++ or GNU C only),
+  DTIMER_BEGIN(name)           - open a block and start measuring,
+  DTIMER_END(name)             - stop measuring and close the block opened by DTIMER_BEGIN(),
+  DTIMER_RECORD(name, ticks)   - record a measured duration, in cpu_ticks(),
+  DTIMER_DUMP(name)            - print count, mean, p50/p99/p999 and max durations via DBGPRINT(),
+  DTIMERS_DUMP()               - print statistics of all used timers defined in current translation unit,
+  DTIMERS_DUMP_HOOK            - name of void(void) function that prints all timers, may be passed to atexit().
+
+  Timers are enabled if debug printing is enabled (see dprint.h), unless DTIMERS_DISABLE is defined.
+*/
+
+/* usage:
+
+DTIMER_DEFINE(parse);
+
+void parse_request(void)
+{
+	SCOPED_TIMER(parse);
+	...
+}
+
+void parse_request2(void)
+{
+	DTIMER_BEGIN(parse);
+	...
+	DTIMER_END(parse);
+}
+*/
+
+/* Implementation notes:
+
+  1) durations are measured in cpu_ticks() (see cpu_ticks.h) and recorded into a per-thread log-linear histogram:
+    each power-of-two range of values is divided into (1 << DTIMER_SUB_BITS) equal sub-buckets, so relative error
+    of reported percentiles do not exceeds 1/(1 << DTIMER_SUB_BITS),
+  2) a histogram is allocated on the first measurement by the thread, histograms are never freed,
+  3) timers and the list of timers for dumping are local to a translation unit,
+  4) durations are converted to nanoseconds by cpu_ticks_hz(): on x86, the first dump spins for 10 ms to calibrate it. */
+
+#include "dprint.h" /* for DBGPRINT() */
+
+#if (defined DPRINT_TO_LOG || defined DPRINT_TO_STREAM) && !defined DTIMERS_DISABLE
+
+#include <stdlib.h> /* for calloc() */
+#include "cpu_ticks.h"
+#include "atomics.h"
+
+/* number of bits of sub-bucket index */
+#ifndef DTIMER_SUB_BITS
+#define DTIMER_SUB_BITS 4
+#endif
+
+/* durations of (1 << DTIMER_MAX_BITS) ticks or longer are recorded into the last bucket */
+#ifndef DTIMER_MAX_BITS
+#define DTIMER_MAX_BITS 40
+#endif
+
+#define DTIMER_SUB_BUCKETS (1u << DTIMER_SUB_BITS)
+#define DTIMER_BUCKETS     ((DTIMER_MAX_BITS - DTIMER_SUB_BITS + 1)*DTIMER_SUB_BUCKETS)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* per-thread histogram, modified only by the owner thread */
+struct dtimer_hist {
+	struct dtimer_hist *next;  /* next histogram of the same timer */
+	unsigned long long count;
+	unsigned long long sum;
+	unsigned long long max;
+	unsigned buckets[DTIMER_BUCKETS];
+};
+
+struct dtimer {
+	const char *name;
+	struct dtimer_hist *hists;  /* lock-free list of per-thread histograms */
+	struct dtimer *next;        /* next registered timer */
+	int registered;             /* non-zero if timer was added to the list of used timers */
+};
+
+/* list of used timers of current translation unit */
+static struct dtimer *dtimers_list_ = NULL;
+
+/* index of most significant bit of non-zero value */
+A_Force_inline_function
+static unsigned dtimer_msb_(const unsigned long long v/*!=0*/)
+{
+#if defined __GNUC__ || defined __clang__
+	return 63u - (unsigned)__builtin_clzll(v);
+#elif defined _MSC_VER && (defined _M_X64 || defined _M_ARM64)
+	unsigned long i;
+	(void)_BitScanReverse64(&i, v);
+	return (unsigned)i;
+#else
+	unsigned i = 0;
+	unsigned long long x = v;
+	for (; x >>= 1; i++);
+	return i;
+#endif
+}
+
+/* get index of histogram bucket for the value */
+A_Force_inline_function
+static unsigned dtimer_bucket_(const unsigned long long v)
+{
+	unsigned e;
+	if (v < DTIMER_SUB_BUCKETS)
+		return (unsigned)v;
+	e = dtimer_msb_(v);
+	if (e >= DTIMER_MAX_BITS)
+		return DTIMER_BUCKETS - 1;
+	/* (e - DTIMER_SUB_BITS + 1)*DTIMER_SUB_BUCKETS + (mantissa - DTIMER_SUB_BUCKETS) */
+	return (e - DTIMER_SUB_BITS)*DTIMER_SUB_BUCKETS + (unsigned)(v >> (e - DTIMER_SUB_BITS));
+}
+
+/* get the highest value that is recorded into given bucket */
+A_Const_function
+static unsigned long long dtimer_bucket_max_(const unsigned b/*<DTIMER_BUCKETS*/)
+{
+	const unsigned g = b/DTIMER_SUB_BUCKETS;
+	const unsigned m = b%DTIMER_SUB_BUCKETS;
+	if (!g)
+		return m;
+	return ((unsigned long long)(DTIMER_SUB_BUCKETS + m + 1) << (g - 1)) - 1;
+}
+
+/* allocate a histogram for current thread, register the timer on first use, returns NULL if out of memory */
+A_Non_inline_function
+static struct dtimer_hist *dtimer_hist_new_(
+	struct dtimer *const t/*!=NULL*/,
+	struct dtimer_hist **const tls/*!=NULL,out*/)
+{
+	/* never freed: histograms must outlive threads */
+	struct dtimer_hist *const h = (struct dtimer_hist*)calloc(1, sizeof(*h));
+	if (!h)
+		return NULL;
+	h->next = ATOMIC_LOAD_PTR(&t->hists, ATOMIC_RELAXED);
+	while (!ATOMIC_CAS_PTR(&t->hists, &h->next, h, ATOMIC_RELEASE, ATOMIC_RELAXED)) {
+		/* h->next was updated, retry */
+	}
+	{
+		int r = 0;
+		if (ATOMIC_CAS(&t->registered, &r, 1, ATOMIC_RELAXED, ATOMIC_RELAXED)) {
+			t->next = ATOMIC_LOAD_PTR(&dtimers_list_, ATOMIC_RELAXED);
+			while (!ATOMIC_CAS_PTR(&dtimers_list_, &t->next, t, ATOMIC_RELEASE, ATOMIC_RELAXED)) {
+				/* t->next was updated, retry */
+			}
+		}
+	}
+	*tls = h;
+	return h;
+}
+
+A_Force_inline_function
+static void dtimer_record_(
+	struct dtimer *const t/*!=NULL*/,
+	struct dtimer_hist **const tls/*!=NULL,in/out*/,
+	const unsigned long long ticks)
+{
+	struct dtimer_hist *h = *tls;
+	if (!h) {
+		h = dtimer_hist_new_(t, tls);
+		if (!h)
+			return; /* out of memory: measurement is lost */
+	}
+	/* no need for atomic increments - the histogram is modified only by current thread */
+	{
+		const unsigned b = dtimer_bucket_(ticks);
+		ATOMIC_STORE(&h->buckets[b], h->buckets[b] + 1, ATOMIC_RELAXED);
+		ATOMIC_STORE(&h->count, h->count + 1, ATOMIC_RELAXED);
+		ATOMIC_STORE(&h->sum, h->sum + ticks, ATOMIC_RELAXED);
+		if (ticks > h->max)
+			ATOMIC_STORE(&h->max, ticks, ATOMIC_RELAXED);
+	}
+}
+
+/* find the value below which given fraction (per million) of recorded values lie */
+static unsigned long long dtimer_percentile_(
+	const unsigned long long buckets[DTIMER_BUCKETS],
+	const unsigned long long count/*>0*/,
+	const unsigned long long max,
+	const unsigned ppm/*<=1000000*/)
+{
+	/* rank of the value, 1-based */
+	const unsigned long long rank = (count*ppm + 999999)/1000000;
+	unsigned long long n = 0;
+	unsigned b = 0;
+	for (; b < DTIMER_BUCKETS; b++) {
+		n += buckets[b];
+		if (n >= rank && n) {
+			/* the last bucket also counts durations of (1 << DTIMER_MAX_BITS) ticks or longer */
+			const unsigned long long v = (b == DTIMER_BUCKETS - 1) ? max : dtimer_bucket_max_(b);
+			return v < max ? v : max;
+		}
+	}
+	return max;
+}
+
+/* convert ticks to nanoseconds */
+static double dtimer_ns_(const unsigned long long ticks)
+{
+	return (double)ticks*1e9/(double)cpu_ticks_hz();
+}
+
+static void dtimer_dump_(const struct dtimer *const t/*!=NULL*/)
+{
+	unsigned long long buckets[DTIMER_BUCKETS] = {0};
+	unsigned long long count = 0, sum = 0, max = 0;
+	const struct dtimer_hist *h = ATOMIC_LOAD_PTR(&t->hists, ATOMIC_ACQUIRE);
+	/* merge per-thread histograms, they may be modified concurrently */
+	for (; h; h = h->next) {
+		unsigned b = 0;
+		const unsigned long long m = ATOMIC_LOAD(&h->max, ATOMIC_RELAXED);
+		for (; b < DTIMER_BUCKETS; b++) {
+			const unsigned n = ATOMIC_LOAD(&h->buckets[b], ATOMIC_RELAXED);
+			buckets[b] += n;
+			count += n;
+		}
+		sum += ATOMIC_LOAD(&h->sum, ATOMIC_RELAXED);
+		if (m > max)
+			max = m;
+	}
+	if (!count)
+		DBGPRINT("timer %s: no measurements", t->name);
+	else {
+		DBGPRINT("timer %s: count=%llu mean=%.1fns p50=%.1fns p99=%.1fns p999=%.1fns max=%.1fns",
+			t->name, count,
+			dtimer_ns_(sum)/(double)count,
+			dtimer_ns_(dtimer_percentile_(buckets, count, max, 500000)),
+			dtimer_ns_(dtimer_percentile_(buckets, count, max, 990000)),
+			dtimer_ns_(dtimer_percentile_(buckets, count, max, 999000)),
+			dtimer_ns_(max));
+	}
+}
+
+static void dtimers_dump_(void)
+{
+	const struct dtimer *t = ATOMIC_LOAD_PTR(&dtimers_list_, ATOMIC_ACQUIRE);
+	for (; t; t = t->next)
+		dtimer_dump_(t);
+}
+
+/* state of measurement of a scope */
+struct dtimer_scope_ {
+	struct dtimer *t;
+	struct dtimer_hist **tls;
+	unsigned long long start;
+#ifdef __cplusplus
+	dtimer_scope_(struct dtimer *const t_, struct dtimer_hist **const tls_)
+		: t(t_), tls(tls_), start(cpu_ticks()) {}
+	~dtimer_scope_() {
+		dtimer_record_(t, tls, cpu_ticks() - start);
+	}
+#endif
+};
+
+#if defined __GNUC__ || defined __clang__
+/* cleanup function for a variable of 'struct dtimer_scope_' type */
+static inline void dtimer_scope_end_(const struct dtimer_scope_ *const s/*!=NULL*/)
+{
+	dtimer_record_(s->t, s->tls, cpu_ticks() - s->start);
+}
+typedef int dtimer_scope_end_unused_[sizeof(&dtimer_scope_end_)];
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/* suppress warnings about unreferenced static functions */
+typedef int dtimer_dump_unused_[sizeof(&dtimer_dump_)];
+typedef int dtimers_dump_unused_[sizeof(&dtimers_dump_)];
+
+/* the timer may be not used, e.g. if measurements are done only in some configurations */
+#define DTIMER_DEFINE(name) \
+	static struct dtimer name = {#name, NULL, NULL, 0}; \
+	static THREAD_LOCAL struct dtimer_hist *name##_dtimer_hist_ = NULL; \
+	typedef int name##_unused_[sizeof(&name) + sizeof(&name##_dtimer_hist_)]
+
+#define DTIMER_RECORD(name, ticks) dtimer_record_(&name, &name##_dtimer_hist_, ticks)
+
+#define DTIMER_BEGIN(name) { \
+	const unsigned long long name##_dtimer_start_ = cpu_ticks();
+
+#define DTIMER_END(name) \
+	DTIMER_RECORD(name, cpu_ticks() - name##_dtimer_start_); \
+}
+
+#define DTIMER_SCOPE_VAR3_(l) dtimer_scope_at_line_##l
+#define DTIMER_SCOPE_VAR2_(l) DTIMER_SCOPE_VAR3_(l)
+#define DTIMER_SCOPE_VAR_     DTIMER_SCOPE_VAR2_(__LINE__)
+
+#ifdef __cplusplus
+#define SCOPED_TIMER(name) \
+	const dtimer_scope_ DTIMER_SCOPE_VAR_(&name, &name##_dtimer_hist_)
+#elif defined __GNUC__ || defined __clang__
+#define SCOPED_TIMER(name) \
+	__attribute__ ((cleanup(dtimer_scope_end_))) \
+	const struct dtimer_scope_ DTIMER_SCOPE_VAR_ = {&name, &name##_dtimer_hist_, cpu_ticks()}
+#endif
+
+#define DTIMER_DUMP(name)    dtimer_dump_(&name)
+#define DTIMERS_DUMP()       dtimers_dump_()
+#define DTIMERS_DUMP_HOOK    dtimers_dump_
+
+#else /* !DPRINT_TO_LOG && !DPRINT_TO_STREAM || DTIMERS_DISABLE */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void dtimers_dump_(void) {}
+
+#ifdef __cplusplus
+}
+#endif
+
+typedef int dtimers_dump_unused_[sizeof(&dtimers_dump_)];
+
+#define DTIMER_DEFINE(name)        struct dtimer
+#define DTIMER_RECORD(name, ticks) ((void)(ticks))
+#define DTIMER_BEGIN(name)         {
+#define DTIMER_END(name)           }
+#define SCOPED_TIMER(name)         ((void)0)
+#define DTIMER_DUMP(name)          ((void)0)
+#define DTIMERS_DUMP()             ((void)0)
+#define DTIMERS_DUMP_HOOK          dtimers_dump_
+
+#endif /* !DPRINT_TO_LOG && !DPRINT_TO_STREAM || DTIMERS_DISABLE */
+
+#endif /* DTIMERS_H_INCLUDED */
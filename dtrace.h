@@ -0,0 +1,360 @@
+#ifndef DTRACE_H_INCLUDED
+#define DTRACE_H_INCLUDED
+
+/**********************************************************************************
+* Trace events recording and export to Chrome trace-event JSON format
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dtrace.h */
+
+/* defines macros:
+
+  DTRACE_STATE_DEFINE          - define global tracing state, must be placed in exactly one translation unit,
+  DTRACE_BEGIN(name)           - record the beginning of a region,
+  DTRACE_END(name)             - record the end of the region started by DTRACE_BEGIN(name),
+  DTRACE_SCOPE(name)           - record a region from this point to the end of enclosing scope (C++ or GNU C only),
+  DTRACE_INSTANT(name)         - record an instant event (e.g. a log site),
+  DTRACE_THREAD_NAME(name)     - name current thread on the timeline,
+  DTRACE_WRITE_JSON(file)      - write recorded events of all threads to the FILE* stream, returns 0 on success,
+  DTRACE_SAVE_HOOK             - name of void(void) function that saves events to DTRACE_FILE, may be passed to atexit().
+
+  'name' - a string constant (its address is recorded, not the contents).
+
+  Tracing is enabled only if DTRACE_ENABLE is defined, otherwise all macros do nothing.
+
+  Note: DBGPRINT() sites are not traced automatically - place DTRACE_INSTANT() next to the log sites of interest.
+
+  Recorded events may be viewed in chrome://tracing or in Perfetto UI (https://ui.perfetto.dev).
+*/
+
+/* usage:
+
+DTRACE_STATE_DEFINE;
+
+static void *worker(void *arg)
+{
+	DTRACE_THREAD_NAME("worker");
+	for (;;) {
+		DTRACE_SCOPE("process item");
+		...
+		DTRACE_BEGIN("lock");
+		pthread_mutex_lock(&m);
+		DTRACE_END("lock");
+		...
+	}
+}
+
+int main(void)
+{
+	(void)atexit(DTRACE_SAVE_HOOK);
+	...
+}
+*/
+
+/* Implementation notes:
+
+  1) each thread records events into its own buffer: a store of an event plus a release store of events counter,
+    a buffer is allocated on the first event recorded by the thread and linked to the global lock-free list of buffers,
+  2) buffers are never freed - events of finished threads are retained,
+  3) a buffer has fixed capacity of DTRACE_BUFFER_EVENTS events, excessive events are dropped (and counted),
+  4) timestamps are taken via cpu_ticks() and converted to microseconds only while writing the JSON,
+  5) events may be written while other threads are still recording - only events recorded before are written. */
+
+#ifdef DTRACE_ENABLE
+
+#include <stdio.h>  /* for FILE, fprintf() */
+#include <stdlib.h> /* for malloc(), getenv() */
+#include "cpu_ticks.h"
+#include "atomics.h"
+
+/* capacity of per-thread buffer of events */
+#ifndef DTRACE_BUFFER_EVENTS
+#define DTRACE_BUFFER_EVENTS 65536
+#endif
+
+/* name of the file to save events to at exit (via DTRACE_SAVE_HOOK),
+  may be overridden at runtime by the environment variable of the same name */
+#ifndef DTRACE_FILE
+#define DTRACE_FILE "trace.json"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dtrace_event {
+	unsigned long long ticks;  /* cpu_ticks() */
+	const char *name;          /* string constant */
+	char phase;                /* 'B' - begin, 'E' - end, 'i' - instant */
+};
+
+/* per-thread buffer of events, events are written only by the owner thread */
+struct dtrace_buf {
+	struct dtrace_buf *next;   /* next buffer in the global list */
+	const char *thread_name;   /* NULL if not set */
+	unsigned tid;              /* sequential number of the buffer, starting from 1 */
+	unsigned count;            /* number of recorded events, store-released by the owner thread */
+	unsigned long long dropped;
+	struct dtrace_event events[DTRACE_BUFFER_EVENTS];
+};
+
+/* global tracing state, see DTRACE_STATE_DEFINE */
+extern struct dtrace_buf *dtrace_bufs_;  /* lock-free list of all buffers */
+extern unsigned dtrace_tids_;            /* number of allocated buffers */
+extern THREAD_LOCAL struct dtrace_buf *dtrace_buf_;
+
+#ifdef __cplusplus
+}
+#endif
+
+#define DTRACE_STATE_DEFINE \
+	struct dtrace_buf *dtrace_bufs_ = NULL; \
+	unsigned dtrace_tids_ = 0; \
+	THREAD_LOCAL struct dtrace_buf *dtrace_buf_ = NULL
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* allocate a buffer for current thread, returns NULL if out of memory */
+A_Non_inline_function
+static struct dtrace_buf *dtrace_buf_new_(void)
+{
+	struct dtrace_buf *const b = (struct dtrace_buf*)malloc(sizeof(*b));
+	if (!b)
+		return NULL;
+	b->thread_name = NULL;
+	b->tid = ATOMIC_FETCH_ADD(&dtrace_tids_, 1u, ATOMIC_RELAXED) + 1;
+	b->count = 0;
+	b->dropped = 0;
+	b->next = ATOMIC_LOAD_PTR(&dtrace_bufs_, ATOMIC_RELAXED);
+	while (!ATOMIC_CAS_PTR(&dtrace_bufs_, &b->next, b, ATOMIC_RELEASE, ATOMIC_RELAXED)) {
+		/* b->next was updated, retry */
+	}
+	dtrace_buf_ = b;
+	return b;
+}
+
+A_Force_inline_function
+static struct dtrace_buf *dtrace_buf_get_(void)
+{
+	struct dtrace_buf *const b = dtrace_buf_;
+	return b ? b : dtrace_buf_new_();
+}
+
+A_Force_inline_function
+static void dtrace_event_(const char *const name/*!=NULL*/, const char phase)
+{
+	struct dtrace_buf *const b = dtrace_buf_get_();
+	if (b) {
+		const unsigned n = b->count;
+		if (n < DTRACE_BUFFER_EVENTS) {
+			struct dtrace_event *const e = &b->events[n];
+			e->ticks = cpu_ticks();
+			e->name = name;
+			e->phase = phase;
+			/* publish the event for the writer */
+			ATOMIC_STORE(&b->count, n + 1, ATOMIC_RELEASE);
+		}
+		else
+			ATOMIC_STORE(&b->dropped, b->dropped + 1, ATOMIC_RELAXED);
+	}
+}
+
+static inline void dtrace_thread_name_(const char *const name/*!=NULL*/)
+{
+	struct dtrace_buf *const b = dtrace_buf_get_();
+	if (b)
+		ATOMIC_STORE_PTR(&b->thread_name, name, ATOMIC_RELAXED);
+}
+
+/* write a string as JSON string literal */
+static void dtrace_write_str_(FILE *const f/*!=NULL*/, const char *s/*!=NULL*/)
+{
+	(void)fputc('"', f);
+	for (; *s; s++) {
+		const unsigned char c = (unsigned char)*s;
+		if (c == '"' || c == '\\')
+			(void)fprintf(f, "\\%c", c);
+		else if (c < 0x20)
+			(void)fprintf(f, "\\u%04x", c);
+		else
+			(void)fputc(c, f);
+	}
+	(void)fputc('"', f);
+}
+
+/* convert timestamp to microseconds since t0, events recorded concurrently with the writer may precede t0 */
+static double dtrace_us_(const unsigned long long ticks, const unsigned long long t0, const double us_per_tick)
+{
+	return ticks > t0 ? (double)(ticks - t0)*us_per_tick : 0.0;
+}
+
+/* write events recorded by all threads in Chrome trace-event JSON format, returns 0 on success, -1 on write error */
+static int dtrace_write_json_(FILE *const f/*!=NULL*/)
+{
+	const double us_per_tick = 1e6/(double)cpu_ticks_hz();
+	const struct dtrace_buf *const bufs = ATOMIC_LOAD_PTR(&dtrace_bufs_, ATOMIC_ACQUIRE);
+	const struct dtrace_buf *b;
+	unsigned long long t0 = ~0ull;
+	int comma = 0;
+
+	/* timestamps are written relative to the first recorded event */
+	for (b = bufs; b; b = b->next) {
+		if (ATOMIC_LOAD(&b->count, ATOMIC_ACQUIRE) && b->events[0].ticks < t0)
+			t0 = b->events[0].ticks;
+	}
+
+	(void)fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", f);
+	for (b = bufs; b; b = b->next) {
+		const unsigned count = ATOMIC_LOAD(&b->count, ATOMIC_ACQUIRE);
+		const char *const thread_name = ATOMIC_LOAD_PTR(&b->thread_name, ATOMIC_RELAXED);
+		const unsigned long long dropped = ATOMIC_LOAD(&b->dropped, ATOMIC_RELAXED);
+		unsigned i = 0;
+		if (thread_name) {
+			(void)fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+				comma ? "," : "", b->tid);
+			dtrace_write_str_(f, thread_name);
+			(void)fputs("}}", f);
+			comma = 1;
+		}
+		for (; i < count; i++) {
+			const struct dtrace_event *const e = &b->events[i];
+			(void)fprintf(f, "%s\n{\"name\":", comma ? "," : "");
+			dtrace_write_str_(f, e->name);
+			(void)fprintf(f, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}",
+				e->phase, dtrace_us_(e->ticks, t0, us_per_tick), b->tid, e->phase == 'i' ? ",\"s\":\"t\"" : "");
+			comma = 1;
+		}
+		if (dropped) {
+			/* mark the point where the buffer overflowed */
+			(void)fprintf(f, "%s\n{\"name\":\"dropped %llu events\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+				comma ? "," : "", dropped, count ? dtrace_us_(b->events[count - 1].ticks, t0, us_per_tick) : 0.0, b->tid);
+			comma = 1;
+		}
+	}
+	(void)fputs("\n]}\n", f);
+	return (fflush(f) || ferror(f)) ? -1 : 0;
+}
+
+/* save events to the file specified by DTRACE_FILE environment variable or macro */
+static void dtrace_save_(void)
+{
+	const char *const env = getenv("DTRACE_FILE");
+	const char *const name = (env && *env) ? env : DTRACE_FILE;
+#if defined _MSC_VER && !defined __cplusplus
+	FILE *f;
+	if (fopen_s(&f, name, "w"))
+		f = NULL;
+#else
+	FILE *const f = fopen(name, "w");
+#endif
+	if (f) {
+		if (dtrace_write_json_(f))
+			(void)fprintf(stderr, "dtrace: failed to write %s\n", name);
+		(void)fclose(f);
+	}
+	else
+		(void)fprintf(stderr, "dtrace: failed to create %s\n", name);
+}
+
+/* state of a traced scope */
+struct dtrace_scope_ {
+	const char *name;
+#ifdef __cplusplus
+	explicit dtrace_scope_(const char *const name_)
+		: name(name_) {
+		dtrace_event_(name, 'B');
+	}
+	~dtrace_scope_() {
+		dtrace_event_(name, 'E');
+	}
+#endif
+};
+
+#if !defined __cplusplus && (defined __GNUC__ || defined __clang__)
+/* cleanup function for a variable of 'struct dtrace_scope_' type */
+static inline void dtrace_scope_end_(const struct dtrace_scope_ *const s/*!=NULL*/)
+{
+	dtrace_event_(s->name, 'E');
+}
+typedef int dtrace_scope_end_unused_[sizeof(&dtrace_scope_end_)];
+
+/* create a variable of 'struct dtrace_scope_' type */
+static inline struct dtrace_scope_ dtrace_scope_begin_(const char *const name/*!=NULL*/)
+{
+	struct dtrace_scope_ s;
+	s.name = name;
+	dtrace_event_(name, 'B');
+	return s;
+}
+typedef int dtrace_scope_begin_unused_[sizeof(&dtrace_scope_begin_)];
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/* suppress warnings about unreferenced static functions */
+typedef int dtrace_thread_name_unused_[sizeof(&dtrace_thread_name_)];
+typedef int dtrace_write_json_unused_[sizeof(&dtrace_write_json_)];
+typedef int dtrace_save_unused_[sizeof(&dtrace_save_)];
+
+#define DTRACE_BEGIN(name)         dtrace_event_(name, 'B')
+#define DTRACE_END(name)           dtrace_event_(name, 'E')
+#define DTRACE_INSTANT(name)       dtrace_event_(name, 'i')
+#define DTRACE_THREAD_NAME(name)   dtrace_thread_name_(name)
+#define DTRACE_WRITE_JSON(file)    dtrace_write_json_(file)
+#define DTRACE_SAVE_HOOK           dtrace_save_
+
+#define DTRACE_SCOPE_VAR3_(l) dtrace_scope_at_line_##l
+#define DTRACE_SCOPE_VAR2_(l) DTRACE_SCOPE_VAR3_(l)
+#define DTRACE_SCOPE_VAR_     DTRACE_SCOPE_VAR2_(__LINE__)
+
+#ifdef __cplusplus
+#define DTRACE_SCOPE(name) \
+	const dtrace_scope_ DTRACE_SCOPE_VAR_(name)
+#elif defined __GNUC__ || defined __clang__
+#define DTRACE_SCOPE(name) \
+	__attribute__ ((cleanup(dtrace_scope_end_))) \
+	const struct dtrace_scope_ DTRACE_SCOPE_VAR_ = dtrace_scope_begin_(name)
+#endif
+
+#else /* !DTRACE_ENABLE */
+
+#include <stdio.h> /* for FILE */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void dtrace_save_(void) {}
+
+/* nothing to write, may be used both as a statement and in an expression */
+static inline int dtrace_write_json_(FILE *const f)
+{
+	(void)f;
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+typedef int dtrace_save_unused_[sizeof(&dtrace_save_)];
+typedef int dtrace_write_json_unused_[sizeof(&dtrace_write_json_)];
+
+#define DTRACE_STATE_DEFINE        struct dtrace_buf
+#define DTRACE_BEGIN(name)         ((void)0)
+#define DTRACE_END(name)           ((void)0)
+#define DTRACE_INSTANT(name)       ((void)0)
+#define DTRACE_THREAD_NAME(name)   ((void)0)
+#define DTRACE_WRITE_JSON(file)    dtrace_write_json_(file)
+#define DTRACE_SCOPE(name)         ((void)0)
+#define DTRACE_SAVE_HOOK           dtrace_save_
+
+#endif /* !DTRACE_ENABLE */
+
+#endif /* DTRACE_H_INCLUDED */
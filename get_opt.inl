@@ -33,6 +33,40 @@
 #define GET_OPT_MEMCMP(a,b,n) memcmp(a,b,n)
 #endif
 
+/* GET_OPT_UTF8 - arguments and options are UTF-8 strings, short options may be multi-byte characters */
+#if defined GET_OPT_UTF8 && defined GET_OPT_WIDE_CHAR_SUPPORT
+#error GET_OPT_UTF8 cannot be used together with GET_OPT_WIDE_CHAR_SUPPORT
+#endif
+
+/* use SSE2 to find the end of long option name, may be disabled by defining GET_OPT_NO_SIMD */
+#if !defined GET_OPT_NO_SIMD && !defined GET_OPT_WIDE_CHAR_SUPPORT && !defined GET_OPT_SSE2
+#if defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define GET_OPT_SSE2
+#endif
+#endif
+
+#ifdef GET_OPT_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+/* aligned loads may read bytes past the end of a string - but not across a page boundary */
+#ifdef __SANITIZE_ADDRESS__
+#ifdef _MSC_VER
+#define GET_OPT_NO_ASAN_ __declspec(no_sanitize_address)
+#else
+#define GET_OPT_NO_ASAN_ __attribute__((no_sanitize_address))
+#endif
+#elif defined __has_feature
+#if __has_feature(address_sanitizer)
+#define GET_OPT_NO_ASAN_ __attribute__((no_sanitize_address))
+#endif
+#endif
+#ifndef GET_OPT_NO_ASAN_
+#define GET_OPT_NO_ASAN_
+#endif
+#endif /* GET_OPT_SSE2 */
+
 /* note: may #include "asserts.h" for the ASSERT macro */
 #ifndef GET_OPT_ASSERT
 #ifdef ASSERT
@@ -54,7 +88,7 @@
 #pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
 #endif
 
-/* this file defines 7 static functions:
+/* this file defines 13 static functions:
 
    1) opt_info_init             - initialize options parsing state structure 'opt_info' (declared in "get_opt_info.h"),
    2) opt_info_is_end           - check if there are no more unchecked command-line arguments,
@@ -62,7 +96,13 @@
    4) get_opt                   - get next option value or parameter specified on the command line,
    5) opt_skip_unknown          - skip unrecognized option,
    6) opt_is_separate_value     - check if option value is specified in a separate argument,
-   7) opt_unread_separate_value - unread option value specified in the separate argument.
+   7) opt_unread_separate_value - unread option value specified in the separate argument,
+   8) long_opt_hash_init        - build hash table of long options names for fast lookup,
+   9) opt_index_init            - initialize options index 'opt_index' for get_opt_indexed(),
+  10) get_opt_indexed           - same as get_opt(), but looks up options via the index,
+  11) opt_tokenize              - parse all arguments at once into an array of pre-decoded tokens,
+  12) opt_token_reparse         - prepare parsing state for re-parsing of an unknown option token,
+  13) opt_token_resume          - get the index of the next token to process after re-parsing of an unknown option token.
 
    Note: get_opt() considers all strings referenced via argv[] as constants, ignoring the fact that they are declared
      as non-constant ones - C language does not allow conversion 'char **' -> 'const char *const *' (but C++ does).
@@ -116,6 +156,11 @@
 |      "-f-h"           - option "-f"     will have value "-h",
 |      "--file=--help"  - option "--file" will have value "--help".
 |
+| 9) if GET_OPT_UTF8 is defined, arguments are UTF-8 strings, and a short option may be any character - a sequence of 1-4 bytes,
+|    for example, "\xc3\xa9\xc3\xa9" - option "-\xc3\xa9" expects a value; the option position is a byte offset
+|    in the short options format string - as computed by SHORT_OPT_ENCODER(), invalid bytes are treated as one-byte characters,
+|    long options names are compared byte-wise, so no conversion of arguments to wide characters is needed
+|
 ===============================================================================================================================*/
 
 
@@ -220,10 +265,13 @@ const struct long_opt_info long_opts[] = {LONG_OPTION_alpha};
  'name'      - option name, must be non-empty, e.g.: "alpha"
  'has_value' - non-zero if option accepts a value,
  'next'      - next option, e.g.: LONG_OPTION_beta */
-#define LONG_OPT_DEFINER(name, has_value, next) {                 \
+#define LONG_OPT_DEFINER(name, has_value, next) LONG_OPT_INFO_(name, has_value), next
+
+/* initializer of struct long_opt_info */
+#define LONG_OPT_INFO_(name, has_value) {                         \
     sizeof("" name) - 1 + 0*sizeof(int[1-2*(sizeof(name) <= 1)]), \
     (has_value) ? GET_OPT_TEXT("=" name) : GET_OPT_TEXT(name)     \
-  }, next
+  }
 
 /* then, to be able to re-use options macros as (encoded) long option indexes (in the long options names array):
 
@@ -245,6 +293,107 @@ const struct long_opt_info long_opts[] = {LONG_OPTION_alpha};
 
 /*********************************************************************************************************/
 
+/* index of short and long options - for lookup of an option in O(1) instead of linear scans of short options
+  format string and long options array:
+
+  static unsigned short long_slots[LONG_OPT_HASH_SIZE(long_opts)];
+  struct opt_index x;
+  opt_index_init(&x, short_opts, long_opts, long_slots, sizeof(long_slots)/sizeof(long_slots[0]));
+  ...
+  switch (get_opt_indexed(&i, &x)) {
+    ...
+  }
+
+  Note: C preprocessor cannot index tables by characters of string literals nor hash them, so the index is filled
+    once at runtime by opt_index_init(), which is cheap - one pass over the short options format string and a hash
+    of each long option name, while get_opt_indexed() hashes the argument in the same pass that looks for the end
+    of the option name ('=' or '\0'). */
+
+/* hash table of long options names */
+struct long_opt_hash {
+	const struct long_opt_info *long_opts; /* NULL? */
+	unsigned short *slots;                 /* index+1 of long option in long_opts array, 0 - empty slot */
+	unsigned mask;                         /* number of slots - 1 */
+};
+
+/* number of entries in the table of short options, characters >= GET_OPT_SHORT_TABLE_SIZE are looked up via strchr() */
+#ifndef GET_OPT_SHORT_TABLE_SIZE
+#define GET_OPT_SHORT_TABLE_SIZE 128
+#endif
+
+/* in UTF-8 mode, only ASCII characters are looked up via the table */
+#if defined GET_OPT_UTF8 && GET_OPT_SHORT_TABLE_SIZE > 128
+#error GET_OPT_SHORT_TABLE_SIZE must not be greater than 128 if GET_OPT_UTF8 is defined
+#endif
+
+/* options index - table of short options and hash table of long options */
+struct opt_index {
+	const GET_OPT_CHAR *short_opts;        /* NULL? */
+	struct long_opt_hash long_hash;
+	/* position+1 of the first occurrence of a character in short_opts, 0 - character is not found */
+	unsigned short short_pos[GET_OPT_SHORT_TABLE_SIZE];
+};
+
+/* pre-decoded command line - arguments are parsed once by opt_tokenize() into an array of tokens,
+  then modules may filter tokens by option codes without re-scanning argument strings:
+
+  struct opt_token tokens[64];
+  struct opt_info i;
+  unsigned n, k;
+  opt_info_init(&i, argv);
+  n = opt_tokenize(&i, argv, short_opts, long_opts, NULL, tokens, 64);
+  if (n > 64)
+    ... too many tokens, allocate n tokens and tokenize again ...
+  for (k = 0; k < n; k++) {
+    switch (tokens[k].opt) {
+      ...
+    }
+  }
+
+  Processing of an unknown option may be delegated to another module, which re-parses the option via get_opt(),
+  the module may consume more arguments than the tokenizer assumed - tokens of them must be skipped:
+
+  for (k = 0; k < n;) {
+    switch (tokens[k].opt) {
+      case OPT_UNKNOWN:
+        opt_token_reparse(&i, argv, &tokens[k]);
+        other_module_process_option(&i);
+        k = opt_token_resume(&i, argv, tokens, n, k);
+        continue;
+      ...
+    }
+    k++;
+  } */
+
+/* parsed option or parameter */
+struct opt_token {
+	/* code returned by get_opt(): encoded option, OPT_UNKNOWN, OPT_PARAMETER or OPT_REST_PARAMS */
+	int opt;
+	/* index of the argument in argv[] where the option (or the bundle of short options, or "--") is specified,
+	  (tokens produced from other sources have a source tag in high bits, see "get_opt_src.inl") */
+	unsigned arg;
+	/* option value or parameter (may be NULL, as i->value after get_opt()),
+	  for OPT_UNKNOWN - unknown short option in the bundle (i->sopt) or NULL,
+	  for OPT_REST_PARAMS - NULL, it is followed by OPT_PARAMETER tokens for the rest arguments */
+	GET_OPT_CHAR *value;
+};
+
+/* number of slots of the hash table for given long options array:
+  power of two, at least twice the number of long options, to keep probe sequences short */
+#define LONG_OPT_HASH_SIZE(long_opts) LONG_OPT_HASH_POW2_(2*(sizeof(long_opts)/sizeof(struct long_opt_info) - 1))
+
+#define LONG_OPT_HASH_POW2_(n) \
+	((n) <= 8 ? 8u : (n) <= 16 ? 16u : (n) <= 32 ? 32u : (n) <= 64 ? 64u : (n) <= 128 ? 128u : (n) <= 256 ? 256u : \
+	(n) <= 512 ? 512u : (n) <= 1024 ? 1024u : (n) <= 2048 ? 2048u : (n) <= 4096 ? 4096u : (n) <= 8192 ? 8192u :     \
+	(n) <= 16384 ? 16384u : (n) <= 32768 ? 32768u : (n) <= 65536 ? 65536u : 0u/*too many options*/)
+
+/* FNV-1a hash of option name characters */
+#define GET_OPT_HASH_INIT      2166136261u
+#define GET_OPT_HASH_STEP(h,c) (((h) ^ (unsigned)(c))*16777619u)
+
+/* get slot index by the hash value */
+#define GET_OPT_HASH_SLOT(h,mask) (((h) ^ ((h) >> 15)) & (mask))
+
 
 #if 0
 /* example */
@@ -385,14 +534,243 @@ static int opt_arg_is_option(const GET_OPT_CHAR *const arg/*!=NULL*/)
 	return GET_OPT_TEXT('-') == *arg && arg[1];
 }
 
-static int get_opt(
+/* find the end of long option name - '=' or '\0' - in one pass, computing the hash of the name,
+  returns name length, *v - points to '=' or NULL */
+static unsigned opt_long_name_(
+	GET_OPT_CHAR *const a/*!=NULL*/,
+	GET_OPT_CHAR **const v/*!=NULL,out*/,
+	unsigned *const hash/*!=NULL,out*/)
+{
+	GET_OPT_CHAR *e = a;
+	unsigned h = GET_OPT_HASH_INIT;
+	for (; *e && GET_OPT_TEXT('=') != *e; e++)
+		h = GET_OPT_HASH_STEP(h, *e);
+	*v = *e ? e : NULL;
+	*hash = h;
+	return (unsigned)(e - a);
+}
+
+/* find the end of long option name - '=' or '\0', returns pointer to it */
+#ifdef GET_OPT_SSE2
+GET_OPT_NO_ASAN_
+static GET_OPT_CHAR *opt_long_end_(GET_OPT_CHAR *const a/*!=NULL*/)
+{
+	/* check 16 bytes at a time, aligned loads do not cross a page boundary */
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i eq = _mm_set1_epi8('=');
+	const unsigned off = (unsigned)((size_t)a & 15);
+	GET_OPT_CHAR *p = a - off;
+	__m128i c = _mm_load_si128((const __m128i*)p);
+	unsigned m = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, zero), _mm_cmpeq_epi8(c, eq)));
+	m &= ~0u << off; /* ignore bytes before the name */
+	while (!m) {
+		p += 16;
+		c = _mm_load_si128((const __m128i*)p);
+		m = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, zero), _mm_cmpeq_epi8(c, eq)));
+	}
+	{
+#ifdef _MSC_VER
+		unsigned long b;
+		_BitScanForward(&b, m);
+#else
+		const unsigned b = (unsigned)__builtin_ctz(m);
+#endif
+		return p + b;
+	}
+}
+#else /* !GET_OPT_SSE2 */
+static GET_OPT_CHAR *opt_long_end_(GET_OPT_CHAR *a/*!=NULL*/)
+{
+	for (; *a && GET_OPT_TEXT('=') != *a; a++) {
+		/* skip name character */
+	}
+	return a;
+}
+#endif /* !GET_OPT_SSE2 */
+
+/* check if long option has given name */
+static int opt_long_match_(
+	const struct long_opt_info *const lo/*!=NULL*/,
+	const GET_OPT_CHAR *const a/*!=NULL*/,
+	const unsigned len)
+{
+	if (len == lo->len) {
+		const GET_OPT_CHAR *n = lo->name;
+		if (GET_OPT_TEXT('=') == *n)
+			n++; /* option expects a value */
+		GET_OPT_ASSERT(*n); /* bad long_opts array: long option name must be non-empty */
+		return !GET_OPT_MEMCMP(a, n, len*sizeof(GET_OPT_CHAR));
+	}
+	return 0;
+}
+
+/* find long option by linear scan of long options array, returns NULL if not found */
+static const struct long_opt_info *opt_long_find_(
+	const struct long_opt_info long_opts[]/*!=NULL*/,
+	const GET_OPT_CHAR *const a/*!=NULL*/,
+	const unsigned len)
+{
+	const struct long_opt_info *lo = long_opts;
+	for (; lo->len; lo++) {
+		if (opt_long_match_(lo, a, len))
+			return lo;
+	}
+	return NULL;
+}
+
+/* find long option in the hash table, returns NULL if not found */
+static const struct long_opt_info *long_opt_hash_find_(
+	const struct long_opt_hash *const h/*!=NULL*/,
+	const GET_OPT_CHAR *const a/*!=NULL*/,
+	const unsigned len,
+	const unsigned hash)
+{
+	unsigned s = GET_OPT_HASH_SLOT(hash, h->mask);
+	for (;; s = (s + 1) & h->mask) {
+		const unsigned x = h->slots[s];
+		if (!x)
+			return NULL; /* table always has an empty slot */
+		if (opt_long_match_(&h->long_opts[x - 1], a, len))
+			return &h->long_opts[x - 1];
+	}
+}
+
+/* build hash table of long options names,
+  slots_count - power of two, greater than the number of long options, use LONG_OPT_HASH_SIZE() */
+static void long_opt_hash_init(
+	struct long_opt_hash *const h/*!=NULL,out*/,
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	unsigned short slots[/*slots_count*/]/*!=NULL,out*/,
+	const unsigned slots_count/*>0*/)
+{
+	unsigned s = 0;
+	GET_OPT_ASSERT(slots_count && !(slots_count & (slots_count - 1)));
+	h->long_opts = long_opts;
+	h->slots = slots;
+	h->mask = slots_count - 1;
+	for (; s < slots_count; s++)
+		slots[s] = 0;
+	if (long_opts) {
+		const struct long_opt_info *lo = long_opts;
+		for (; lo->len; lo++) {
+			const GET_OPT_CHAR *const n = lo->name + (GET_OPT_TEXT('=') == *lo->name);
+			unsigned hash = GET_OPT_HASH_INIT;
+			unsigned k = 0;
+			for (; k < lo->len; k++)
+				hash = GET_OPT_HASH_STEP(hash, n[k]);
+			/* if names are duplicated, keep the first one - as would be matched by the linear scan */
+			if (!long_opt_hash_find_(h, n, lo->len, hash)) {
+				/* too many long options or too few slots */
+				GET_OPT_ASSERT((unsigned)(lo - long_opts) < slots_count - 1 && (unsigned)(lo - long_opts) < 65535u);
+				for (s = GET_OPT_HASH_SLOT(hash, h->mask); slots[s]; s = (s + 1) & h->mask) {
+					/* slot is occupied, probe next one */
+				}
+				slots[s] = (unsigned short)(lo - long_opts + 1);
+			}
+		}
+	}
+}
+
+/* initialize options index for get_opt_indexed(),
+  long_slots_count - power of two, greater than the number of long options, use LONG_OPT_HASH_SIZE() */
+static void opt_index_init(
+	struct opt_index *const x/*!=NULL,out*/,
+	const GET_OPT_CHAR short_opts[]/*NULL?*/,
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	unsigned short long_slots[/*long_slots_count*/]/*!=NULL,out*/,
+	const unsigned long_slots_count/*>0*/)
+{
+	unsigned k = 0;
+	x->short_opts = short_opts;
+	for (; k < GET_OPT_SHORT_TABLE_SIZE; k++)
+		x->short_pos[k] = 0;
+	if (short_opts) {
+		/* scan backward, so the first occurrence of a character wins - as found by strchr() */
+		for (k = 0; short_opts[k]; k++) {
+			/* too long short options format string */
+			GET_OPT_ASSERT(k < 65535u);
+		}
+		while (k) {
+			const GET_OPT_CHAR c = short_opts[--k];
+			if ((unsigned)c < GET_OPT_SHORT_TABLE_SIZE)
+				x->short_pos[(unsigned)c] = (unsigned short)(k + 1);
+		}
+	}
+	long_opt_hash_init(&x->long_hash, long_opts, long_slots, long_slots_count);
+}
+
+/* number of characters (bytes in UTF-8 mode) of a short option name: 1 for ASCII or invalid UTF-8 sequence */
+static unsigned opt_char_len_(const GET_OPT_CHAR *const s/*!=NULL*/)
+{
+#ifdef GET_OPT_UTF8
+	const unsigned c = (unsigned char)*s;
+	const unsigned n = c < 0xC2 ? 1u : c < 0xE0 ? 2u : c < 0xF0 ? 3u : c < 0xF5 ? 4u : 1u;
+	unsigned k = 1;
+	for (; k < n; k++) {
+		if (0x80 != ((unsigned char)s[k] & 0xC0))
+			return 1u; /* invalid or truncated sequence: do not read past the '\0' */
+	}
+	return n;
+#else
+	(void)s;
+	return 1u;
+#endif
+}
+
+/* compare short options names, a[] - n non-'\0' characters, comparison stops at the first mismatch */
+static int opt_char_eq_(
+	const GET_OPT_CHAR a[/*n*/]/*!=NULL*/,
+	const GET_OPT_CHAR b[]/*!=NULL,'\0'-terminated*/,
+	const unsigned n/*>0*/)
+{
+	unsigned k = 0;
+	for (; k < n; k++) {
+		if (a[k] != b[k])
+			return 0;
+	}
+	return 1;
+}
+
+/* find short option, short_pos - table of short options positions, if NULL - short_opts are scanned linearly,
+  c - option name of n characters (in UTF-8 mode, n > 1 for a multi-byte character) */
+static const GET_OPT_CHAR *opt_short_find_(
+	const GET_OPT_CHAR short_opts[]/*!=NULL*/,
+	const unsigned short *const short_pos/*NULL?*/,
+	const GET_OPT_CHAR c[/*n*/]/*!=NULL,c[0]!='\0'*/,
+	const unsigned n/*>0*/)
+{
+#ifdef GET_OPT_UTF8
+	if ((unsigned char)*c >= 0x80) {
+		/* non-ASCII: compare whole characters, a byte of multi-byte character must not match a part of another one */
+		const GET_OPT_CHAR *o = short_opts;
+		while (*o) {
+			const unsigned m = opt_char_len_(o);
+			if (m == n && opt_char_eq_(c, o, n))
+				return o;
+			o += m;
+		}
+		return NULL;
+	}
+#endif
+	(void)n;
+	GET_OPT_ASSERT(1 == n);
+	if (short_pos && (unsigned)*c < GET_OPT_SHORT_TABLE_SIZE) {
+		const unsigned p = short_pos[(unsigned)*c];
+		return p ? &short_opts[p - 1] : NULL;
+	}
+	return GET_OPT_STRCHR(short_opts, *c);
+}
+
+/* x - options index, if NULL - short_opts and long_opts are scanned linearly */
+static int get_opt_(
 #ifdef GET_OPT_ARGV_NZ
 	struct opt_info *const i/*!=NULL,i->arg < i->args_end*/,
 #else
 	struct opt_info *const i/*!=NULL,i->arg[0] != NULL*/,
 #endif
 	const GET_OPT_CHAR short_opts[]/*NULL?*/,
-	const struct long_opt_info long_opts[]/*NULL?*/)
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	const struct opt_index *const x/*NULL?*/)
 {
 	GET_OPT_CHAR *a = i->sopt;
 #ifdef GET_OPT_ARGV_NZ
@@ -403,24 +781,25 @@ static int get_opt(
 	if (a) {
 		/* next short option in the bundle, like "yz" in "-xyz" */
 		if (short_opts) {
-			const GET_OPT_CHAR *const o = GET_OPT_STRCHR(short_opts, *a);
+			const unsigned n = opt_char_len_(a);
+			const GET_OPT_CHAR *const o = opt_short_find_(short_opts, x ? x->short_pos : NULL, a, n);
 			if (o) {
 				/* short_opts format string must not contain "-" */
-				GET_OPT_ASSERT(GET_OPT_TEXT('-') != o[0] && GET_OPT_TEXT('-') != o[1]);
-				if (GET_OPT_TEXT(' ') == o[1]) {
+				GET_OPT_ASSERT(GET_OPT_TEXT('-') != o[0] && GET_OPT_TEXT('-') != o[n]);
+				if (GET_OPT_TEXT(' ') == o[n]) {
 					/* option is the first letter of a long option started with one dash:
 					   "-xfile=abc" as equivalent of "-x -file=abc" or "-x --file=abc" */
 					i->arg++; /* skip bundle */
 					i->sopt = NULL; /* end of short options bundle */
 					goto parse_long_option; /* 'a' points to the option name */
 				}
-				if (o[1] == *a) {
+				if (opt_char_eq_(a, o + n, n)) {
 					/* short option expects a value: "-xfabc" as equivalent of "-x -fabc" */
 					i->arg++; /* skip bundle */
 					i->sopt = NULL; /* end of short options bundle */
-					if (a[1]) {
+					if (a[n]) {
 						/* "-xfabc": set (non-empty) option value */
-						i->value = a + 1; /* skip "f" */
+						i->value = a + n; /* skip "f" */
 					}
 					/* no value was specified together with the option, like "-xf", try to get the next argument */
 					else if (opt_info_is_end(i))
@@ -435,8 +814,8 @@ static int get_opt(
 					/* caller must not check for a value of short option if, according
 					  to given short_opts format string, the option do not needs a value */
 					/*i->value = NULL;*/
-					if (a[1])
-						i->sopt = a + 1; /* next short option the bundle: "z" in "yz" */
+					if (a[n])
+						i->sopt = a + n; /* next short option the bundle: "z" in "yz" */
 					else {
 						i->arg++; /* skip bundle */
 						i->sopt = NULL; /* end of short options bundle */
@@ -466,33 +845,36 @@ static int get_opt(
 parse_long_option:
 		if (long_opts) {
 			/* check if long option specified with a value, like "--file=name" */
-			GET_OPT_CHAR *const v = GET_OPT_STRCHR(a, GET_OPT_TEXT('='));
-			const unsigned len = (unsigned)((v ? v : GET_OPT_STRCHR(a, GET_OPT_TEXT('\0'))) - a);
-			const struct long_opt_info *lo = long_opts;
-			for (; lo->len; lo++) {
-				if (len == lo->len) {
-					const GET_OPT_CHAR *n = lo->name;
-					if (GET_OPT_TEXT('=') == *n)
-						n++; /* option expects a value */
-					GET_OPT_ASSERT(*n); /* bad long_opts array: long option name must be non-empty */
-					if (!GET_OPT_MEMCMP(a, n, len*sizeof(GET_OPT_CHAR))) {
-						if (v) {
-							/* "--file=abc": set (can be empty) option value, even if not expecting one */
-							i->value = v + 1; /* skip '=' */
-						}
-						else if (lo->name == n)
-							i->value = NULL; /* option do not needs a value */
-						/* no value was specified together with the option, like "--help", try to get the next argument */
-						else if (opt_info_is_end(i))
-							i->value = NULL; /* no value: end of args */
-						/* don't take the next argument if it looks like an option */
-						else if (opt_arg_is_option(*i->arg))
-							i->value = NULL; /* no value: next argument is an option */
-						else
-							i->value = *i->arg++; /* option value, like "--file name" */
-						return LONG_OPT((int)(unsigned)(lo - long_opts));
-					}
+			GET_OPT_CHAR *v;
+			const struct long_opt_info *lo;
+			if (x) {
+				/* compute the hash of the name while looking for its end */
+				unsigned hash;
+				const unsigned len = opt_long_name_(a, &v, &hash);
+				lo = long_opt_hash_find_(&x->long_hash, a, len, hash);
+			}
+			else {
+				v = opt_long_end_(a);
+				lo = opt_long_find_(long_opts, a, (unsigned)(v - a));
+				if (!*v)
+					v = NULL;
+			}
+			if (lo) {
+				if (v) {
+					/* "--file=abc": set (can be empty) option value, even if not expecting one */
+					i->value = v + 1; /* skip '=' */
 				}
+				else if (GET_OPT_TEXT('=') != *lo->name)
+					i->value = NULL; /* option do not needs a value */
+				/* no value was specified together with the option, like "--help", try to get the next argument */
+				else if (opt_info_is_end(i))
+					i->value = NULL; /* no value: end of args */
+				/* don't take the next argument if it looks like an option */
+				else if (opt_arg_is_option(*i->arg))
+					i->value = NULL; /* no value: next argument is an option */
+				else
+					i->value = *i->arg++; /* option value, like "--file name" */
+				return LONG_OPT((int)(unsigned)(lo - long_opts));
 			}
 		}
 		/* check if parsing a long option started with one dash in the short options bundle, like "-xfile=abc":
@@ -503,24 +885,25 @@ parse_long_option:
 	}
 	else if (short_opts) {
 		/* short option(s), like "-h" or "-fabc" */
-		const GET_OPT_CHAR *const o = GET_OPT_STRCHR(short_opts, a[1]);
+		const unsigned n = opt_char_len_(a + 1);
+		const GET_OPT_CHAR *const o = opt_short_find_(short_opts, x ? x->short_pos : NULL, a + 1, n);
 		if (o) {
 			/* short_opts format string must not contain "-" */
-			GET_OPT_ASSERT(GET_OPT_TEXT('-') != o[1]);
-			if (GET_OPT_TEXT(' ') == o[1]) {
+			GET_OPT_ASSERT(GET_OPT_TEXT('-') != o[n]);
+			if (GET_OPT_TEXT(' ') == o[n]) {
 				/* long option started with one dash: "-file" or "-file=abc" */
 				a++; /* skip "-" */
 				goto parse_long_option;
 			}
-			if (a[2]) {
+			if (a[1 + n]) {
 				/* may be short option with a value: "-fabc" or multiple short options bundled together: "-xyz" */
-				if (a[1] == o[1]) {
+				if (opt_char_eq_(a + 1, o + n, n)) {
 					/* "-fabc": set (non-empty) option value */
-					i->value = a + 2; /* skip "-f" */
+					i->value = a + 1 + n; /* skip "-f" */
 				}
 				else {
 					/* "-xyz": multiple short options bundled together */
-					i->sopt = a + 2; /* next short option in the bundle: "yz" in "-xyz" */
+					i->sopt = a + 1 + n; /* next short option in the bundle: "yz" in "-xyz" */
 					/* caller must not check for a value of short option if, according
 					  to given short_opts format string, the option do not needs a value */
 					/*i->value = NULL;*/
@@ -528,7 +911,7 @@ parse_long_option:
 				}
 			}
 			/* no value was passed, like "-f" */
-			else if (a[1] == o[1]) {
+			else if (opt_char_eq_(a + 1, o + n, n)) {
 				/* short option expects a value, like "-f name", try to get the next argument */
 				if (opt_info_is_end(i))
 					i->value = NULL; /* no value: end of args */
@@ -550,11 +933,36 @@ parse_long_option:
 	return OPT_UNKNOWN; /* i->arg points to unknown option (or bundle, if i->sopt != NULL) */
 }
 
+static int get_opt(
+#ifdef GET_OPT_ARGV_NZ
+	struct opt_info *const i/*!=NULL,i->arg < i->args_end*/,
+#else
+	struct opt_info *const i/*!=NULL,i->arg[0] != NULL*/,
+#endif
+	const GET_OPT_CHAR short_opts[]/*NULL?*/,
+	const struct long_opt_info long_opts[]/*NULL?*/)
+{
+	return get_opt_(i, short_opts, long_opts, NULL);
+}
+
+/* same as get_opt(), but looks up options in constant time via the index initialized by opt_index_init() */
+static int get_opt_indexed(
+#ifdef GET_OPT_ARGV_NZ
+	struct opt_info *const i/*!=NULL,i->arg < i->args_end*/,
+#else
+	struct opt_info *const i/*!=NULL,i->arg[0] != NULL*/,
+#endif
+	const struct opt_index *const x/*!=NULL*/)
+{
+	return get_opt_(i, x->short_opts, x->long_hash.long_opts, x);
+}
+
 static void opt_skip_unknown(struct opt_info *const i/*!=NULL*/)
 {
 	/* skip unknown option, assume it do not expects a value */
 	if (i->sopt) {
-		if (*++(i->sopt))
+		i->sopt += opt_char_len_(i->sopt);
+		if (*i->sopt)
 			return;
 		i->sopt = NULL;
 	}
@@ -587,6 +995,96 @@ static void opt_unread_separate_value(struct opt_info *const i/*!=NULL*/)
 	GET_OPT_ASSERT(*i->arg == i->value);
 }
 
+/* parse all remaining arguments at once, x - options index (NULL?), if x != NULL, short_opts and long_opts are ignored,
+  stores at most max_tokens tokens, returns total number of tokens - may be greater than max_tokens,
+  i - parsing state initialized by opt_info_init() for argv[], may be already advanced, e.g. by opt_cmd_select(),
+  but not in the middle of a short options bundle, on return all arguments are parsed,
+  argv - the array passed to opt_info_init(), token 'arg' members are indexes in it */
+static unsigned opt_tokenize(
+	struct opt_info *const i/*!=NULL,in/out*/,
+	GET_OPT_CHAR *const argv[]/*!=NULL*/,
+	const GET_OPT_CHAR short_opts[]/*NULL?*/,
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	const struct opt_index *const x/*NULL?*/,
+	struct opt_token tokens[/*max_tokens*/]/*NULL?,out*/,
+	const unsigned max_tokens)
+{
+	unsigned n = 0;
+	GET_OPT_ASSERT(!i->sopt);
+	GET_OPT_ASSERT(i->arg > argv);
+	if (x) {
+		short_opts = x->short_opts;
+		long_opts = x->long_hash.long_opts;
+	}
+	while (!opt_info_is_end(i)) {
+		GET_OPT_CHAR *const *const a = i->arg;
+		const int opt = get_opt_(i, short_opts, long_opts, x);
+		if (n < max_tokens) {
+			tokens[n].opt = opt;
+			tokens[n].arg = (unsigned)(a - argv);
+			tokens[n].value = OPT_UNKNOWN == opt ? i->sopt : OPT_REST_PARAMS == opt ? NULL : i->value;
+		}
+		n++;
+		if (OPT_UNKNOWN == opt)
+			opt_skip_unknown(i); /* assume unknown option do not expects a value */
+		else if (OPT_REST_PARAMS == opt) {
+			for (; !opt_info_is_end(i); i->arg++, n++) {
+				if (n < max_tokens) {
+					tokens[n].opt = OPT_PARAMETER;
+					tokens[n].arg = (unsigned)(i->arg - argv);
+					tokens[n].value = *i->arg;
+				}
+			}
+		}
+	}
+	return n;
+}
+
+/* prepare parsing state for re-parsing of an unknown option, e.g. by another module via get_opt(),
+  i - must be initialized by opt_info_init() for the same argv[] that was tokenized */
+static void opt_token_reparse(
+	struct opt_info *const i/*!=NULL,in/out*/,
+	GET_OPT_CHAR *const argv[]/*!=NULL*/,
+	const struct opt_token *const t/*!=NULL*/)
+{
+	GET_OPT_ASSERT(OPT_UNKNOWN == t->opt);
+	i->arg = &argv[t->arg];
+	i->sopt = t->value;
+}
+
+/* after re-parsing of the unknown option tokens[k] (see opt_token_reparse()), get the index of the next token to process:
+  tokens of arguments consumed by the re-parsing module, like a separate value "--foo val" or the rest of the short options
+  bundle "-xVALUE", are skipped, n - number of stored tokens, returns n if there are no more tokens to process */
+static unsigned opt_token_resume(
+	const struct opt_info *const i/*!=NULL*/,
+	GET_OPT_CHAR *const argv[]/*!=NULL*/,
+	const struct opt_token tokens[/*n*/]/*!=NULL*/,
+	const unsigned n,
+	const unsigned k/*<n*/)
+{
+	const unsigned a = (unsigned)(i->arg - argv); /* index of the argument where the module has stopped */
+	unsigned j = k + 1;
+	GET_OPT_ASSERT(k < n);
+	GET_OPT_ASSERT(OPT_UNKNOWN == tokens[k].opt);
+	while (j < n && tokens[j].arg < a)
+		j++; /* skip tokens of consumed arguments */
+	if (i->sopt) {
+		/* the module has stopped inside the short options bundle argv[a]: tokens of the bundle
+		  start at consecutive characters of it, the first one - at the first character after the dash */
+		const GET_OPT_CHAR *s = argv[a] + 1;
+		unsigned f = j;
+		while (f && tokens[f - 1].arg == a)
+			f--; /* first token of the bundle */
+		/* skip tokens started before i->sopt, if the rest of the bundle was parsed as one token
+		  (e.g. as an option value or as a whole unknown option) - skip all tokens of the bundle */
+		for (; s < i->sopt && f < n && tokens[f].arg == a; s += opt_char_len_(s))
+			f++;
+		if (f > j)
+			j = f;
+	}
+	return j;
+}
+
 /* suppress warnings about unreferenced static functions */
 typedef int get_opt_unused_[sizeof(&get_opt)];
 typedef int opt_info_init_unused_[sizeof(&opt_info_init)];
@@ -595,6 +1093,12 @@ typedef int opt_skip_unknown_unused_[sizeof(&opt_skip_unknown)];
 typedef int opt_arg_is_option_unused_[sizeof(&opt_arg_is_option)];
 typedef int opt_is_separate_value_unused_[sizeof(&opt_is_separate_value)];
 typedef int opt_unread_separate_value_unused_[sizeof(&opt_unread_separate_value)];
+typedef int long_opt_hash_init_unused_[sizeof(&long_opt_hash_init)];
+typedef int opt_index_init_unused_[sizeof(&opt_index_init)];
+typedef int get_opt_indexed_unused_[sizeof(&get_opt_indexed)];
+typedef int opt_tokenize_unused_[sizeof(&opt_tokenize)];
+typedef int opt_token_reparse_unused_[sizeof(&opt_token_reparse)];
+typedef int opt_token_resume_unused_[sizeof(&opt_token_resume)];
 
 #ifdef __clang__
 #pragma clang diagnostic pop
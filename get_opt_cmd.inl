@@ -0,0 +1,173 @@
+#ifndef GET_OPT_CMD_INL_INCLUDED
+#define GET_OPT_CMD_INL_INCLUDED
+
+/**********************************************************************************
+* Subcommands dispatch for get_opt()
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_cmd.inl */
+
+/* note: #include "get_opt.inl" before this file */
+
+/* this file defines 3 static functions:
+
+   1) opt_cmd_table_init - build hash table of subcommands names,
+   2) opt_cmd_find       - look up subcommand by name, e.g. by the program name for a busybox-style binary,
+   3) opt_cmd_select     - look up subcommand named by the next argument and hand off parsing state to it.
+
+  Example:
+
+  static int cmd_add(struct opt_info *i, const struct opt_cmd *cmd)
+  {
+    while (!opt_info_is_end(i)) {
+      switch (get_opt_indexed(i, cmd->x)) {
+        ...
+      }
+    }
+    return 0;
+  }
+
+#define CMD_add     LONG_OPT_MODIFIER("add",    0, CMD_remove)
+#define CMD_remove  LONG_OPT_MODIFIER("remove", 0, LONG_OPT_NULL)
+
+#define LONG_OPT_NULL       {0, NULL}
+#define LONG_OPT_MODIFIER   LONG_OPT_DEFINER
+
+  static const struct long_opt_info cmd_names[] = {CMD_add};
+
+  static struct opt_index add_index;
+  static unsigned short add_long_slots[LONG_OPT_HASH_SIZE(add_long_opts)];
+
+  static const struct opt_cmd cmds[] = {
+    {add_short_opts, add_long_opts, cmd_add, &add_index, add_long_slots, LONG_OPT_HASH_SIZE(add_long_opts)},
+    {remove_short_opts, remove_long_opts, cmd_remove, NULL, NULL, 0}
+  };
+
+  int main(int argc, char *argv[])
+  {
+    static unsigned short slots[LONG_OPT_HASH_SIZE(cmd_names)];
+    struct opt_cmd_table t;
+    const struct opt_cmd *cmd;
+    struct opt_info i;
+    opt_cmd_table_init(&t, cmd_names, cmds, slots, sizeof(slots)/sizeof(slots[0]));
+    opt_info_init(&i, argv);
+    cmd = opt_info_is_end(&i) ? NULL : opt_cmd_select(&t, &i);
+    if (!cmd) {
+      fprintf(stderr, "usage: %s <add|remove> [options]\n", argv[0]);
+      return 2;
+    }
+    return cmd->handler(&i, cmd);
+  }
+*/
+
+/*=========================== Notes: ============================================================================================
+|
+| 1) subcommands names are defined the same way as long options names, in an array of struct long_opt_info,
+|    commands descriptions are in a parallel array of struct opt_cmd - in the same order
+|
+| 2) subcommand is looked up in O(1) via the same hash table as used for long options by get_opt_indexed()
+|
+| 3) options tables of a subcommand are not accessed until the subcommand is selected,
+|    then, if the subcommand has an index, the index is initialized - only for the selected subcommand
+|
+===============================================================================================================================*/
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+struct opt_cmd;
+
+/* subcommand handler: i - parsing state, i->arg points to the argument after the subcommand name */
+typedef int opt_cmd_handler_t(struct opt_info *i, const struct opt_cmd *cmd);
+
+/* subcommand description */
+struct opt_cmd {
+	const GET_OPT_CHAR *short_opts;        /* NULL? */
+	const struct long_opt_info *long_opts; /* NULL? */
+	opt_cmd_handler_t *handler;            /* NULL? */
+	/* optional index of the subcommand options, initialized when the subcommand is selected */
+	struct opt_index *x;                   /* NULL? */
+	unsigned short *long_slots;            /* !=NULL if x != NULL */
+	unsigned long_slots_count;             /* use LONG_OPT_HASH_SIZE() */
+};
+
+/* table of subcommands */
+struct opt_cmd_table {
+	const struct opt_cmd *cmds;            /* parallel to names array */
+	struct long_opt_hash names;
+};
+
+/* build hash table of subcommands names,
+  slots_count - power of two, greater than the number of subcommands, use LONG_OPT_HASH_SIZE(names) */
+static void opt_cmd_table_init(
+	struct opt_cmd_table *const t/*!=NULL,out*/,
+	const struct long_opt_info names[]/*!=NULL*/,
+	const struct opt_cmd cmds[]/*!=NULL*/,
+	unsigned short slots[/*slots_count*/]/*!=NULL,out*/,
+	const unsigned slots_count/*>0*/)
+{
+	t->cmds = cmds;
+	long_opt_hash_init(&t->names, names, slots, slots_count);
+}
+
+/* look up subcommand by name, returns NULL if not found */
+static const struct opt_cmd *opt_cmd_find(
+	const struct opt_cmd_table *const t/*!=NULL*/,
+	const GET_OPT_CHAR *const name/*!=NULL*/)
+{
+	GET_OPT_CHAR *e;
+	unsigned hash;
+	/* note: opt_long_name_() does not modify the name */
+	const unsigned len = opt_long_name_((GET_OPT_CHAR*)name, &e, &hash);
+	if (len && !e) {
+		const struct long_opt_info *const lo = long_opt_hash_find_(&t->names, name, len, hash);
+		if (lo)
+			return &t->cmds[lo - t->names.long_opts];
+	}
+	return NULL;
+}
+
+/* look up subcommand named by the next argument, returns NULL if not found, else - skips the argument
+  and initializes the subcommand options index, if any, then options of the subcommand may be parsed via i */
+static const struct opt_cmd *opt_cmd_select(
+	const struct opt_cmd_table *const t/*!=NULL*/,
+#ifdef GET_OPT_ARGV_NZ
+	struct opt_info *const i/*!=NULL,i->arg < i->args_end*/
+#else
+	struct opt_info *const i/*!=NULL,i->arg[0] != NULL*/
+#endif
+)
+{
+	const struct opt_cmd *const cmd = opt_cmd_find(t, *i->arg);
+	if (cmd) {
+		i->arg++;
+		i->sopt = NULL;
+		if (cmd->x)
+			opt_index_init(cmd->x, cmd->short_opts, cmd->long_opts, cmd->long_slots, cmd->long_slots_count);
+	}
+	return cmd;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int opt_cmd_table_init_unused_[sizeof(&opt_cmd_table_init)];
+typedef int opt_cmd_find_unused_[sizeof(&opt_cmd_find)];
+typedef int opt_cmd_select_unused_[sizeof(&opt_cmd_select)];
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* GET_OPT_CMD_INL_INCLUDED */
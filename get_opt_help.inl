@@ -0,0 +1,211 @@
+#ifndef GET_OPT_HELP_INL_INCLUDED
+#define GET_OPT_HELP_INL_INCLUDED
+
+/**********************************************************************************
+* Help text and suggestions for options parsed by get_opt()
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_help.inl */
+
+/* note: #include "get_opt.inl" before this file */
+
+/* defines:
+
+  SHORT_OPT_DEFINER_H, SHORT_OPT_ENCODER_H, SHORT_OPT_HELP, SHORT_OPT_NO_HELP - short options modifiers with help,
+  LONG_OPT_DEFINER_H,  LONG_OPT_ENCODER_H,  LONG_OPT_HELP,  LONG_OPT_NO_HELP  - long options modifiers with help,
+  GET_OPT_HELP_LINE(usage, help) - format of help text of one option,
+  LONG_OPT_NAME(lo)              - name of long option without leading '=',
+
+ and 1 static function:
+
+  opt_suggest - find long option with the name most similar to an unknown option, for "did you mean" hints.
+*/
+
+/* options may be defined together with their help text, then help text is built by the compiler - as a string literal:
+
+#define SHORT_OPTION_f      SHORT_OPT_MODIFIER_H("ff", "-f FILE", "read input from FILE", SHORT_OPTION_v)
+#define SHORT_OPTION_v      SHORT_OPT_MODIFIER("v", SHORT_OPT_NULL)
+
+#define LONG_OPTION_file    LONG_OPT_MODIFIER_H("file", 1, "=FILE", "read input from FILE", LONG_OPTION_verbose)
+#define LONG_OPTION_verbose LONG_OPT_MODIFIER_H("verbose", 0, "", "print more messages", LONG_OPT_NULL)
+
+  1) define options, as usual:
+
+#define SHORT_OPT_NULL        GET_OPT_TEXT("")
+#define SHORT_OPT_MODIFIER    SHORT_OPT_DEFINER
+#define SHORT_OPT_MODIFIER_H  SHORT_OPT_DEFINER_H
+
+  static const GET_OPT_CHAR short_opts[] = SHORT_OPTION_f;
+
+#define LONG_OPT_NULL         {0, NULL}
+#define LONG_OPT_MODIFIER     LONG_OPT_DEFINER
+#define LONG_OPT_MODIFIER_H   LONG_OPT_DEFINER_H
+
+  static const struct long_opt_info long_opts[] = {LONG_OPTION_file};
+
+  2) define help text (options without help text, like "-v", are skipped):
+
+#define SHORT_OPT_NULL        ""
+#define SHORT_OPT_MODIFIER    SHORT_OPT_NO_HELP
+#define SHORT_OPT_MODIFIER_H  SHORT_OPT_HELP
+
+#define LONG_OPT_NULL         ""
+#define LONG_OPT_MODIFIER     LONG_OPT_NO_HELP
+#define LONG_OPT_MODIFIER_H   LONG_OPT_HELP
+
+  static const char help[] = "usage: prog [options]\n" SHORT_OPTION_f LONG_OPTION_file;
+
+  3) redefine macros to use options as (encoded) case labels:
+
+#define SHORT_OPT_NULL        SHORT_OPT_END_POS(short_opts)
+#define SHORT_OPT_MODIFIER    SHORT_OPT_ENCODER
+#define SHORT_OPT_MODIFIER_H  SHORT_OPT_ENCODER_H
+
+#define LONG_OPT_NULL         LONG_OPT_END_IDX(long_opts)
+#define LONG_OPT_MODIFIER     LONG_OPT_ENCODER
+#define LONG_OPT_MODIFIER_H   LONG_OPT_ENCODER_H
+
+  then, for an unknown option:
+
+  case OPT_UNKNOWN:
+    if (!i.sopt) {
+      const struct long_opt_info *const lo = opt_suggest(*i.arg, long_opts, 2);
+      if (lo)
+        fprintf(stderr, "unknown option: %s, did you mean --%s?\n", *i.arg, LONG_OPT_NAME(lo));
+    }
+*/
+
+/* format of help text of one option, help text is a narrow character string */
+#ifndef GET_OPT_HELP_LINE
+#define GET_OPT_HELP_LINE(usage, help) "  " usage "\n        " help "\n"
+#endif
+
+/* short option with help text:
+ 'name'  - option name, e.g.: "ff",
+ 'usage' - option usage, e.g.: "-f FILE",
+ 'help'  - option description,
+ 'next'  - next option, e.g.: SHORT_OPTION_b */
+#define SHORT_OPT_DEFINER_H(name, usage, help, next)  SHORT_OPT_DEFINER(name, next)
+#define SHORT_OPT_ENCODER_H(name, usage, help, next)  SHORT_OPT_ENCODER(name, next)
+#define SHORT_OPT_HELP(name, usage, help, next)       GET_OPT_HELP_LINE(usage, help) next
+#define SHORT_OPT_NO_HELP(name, next)                 next
+
+/* long option with help text:
+ 'name'      - option name, must be non-empty, e.g.: "file",
+ 'has_value' - non-zero if option accepts a value,
+ 'arg'       - value placeholder, e.g.: "=FILE", or "" if option do not accepts a value,
+ 'help'      - option description,
+ 'next'      - next option, e.g.: LONG_OPTION_beta */
+#define LONG_OPT_DEFINER_H(name, has_value, arg, help, next)  LONG_OPT_INFO_(name, has_value), next
+#define LONG_OPT_ENCODER_H(name, has_value, arg, help, next)  LONG_OPT_ENCODER(name, has_value, next)
+#define LONG_OPT_HELP(name, has_value, arg, help, next)       GET_OPT_HELP_LINE("--" name arg, help) next
+#define LONG_OPT_NO_HELP(name, has_value, next)               next
+
+/* name of long option, without leading '=' */
+#define LONG_OPT_NAME(lo) ((lo)->name + (GET_OPT_TEXT('=') == *(lo)->name))
+
+/* max length of option names compared by opt_suggest() */
+#ifndef GET_OPT_SUGGEST_MAX_LEN
+#define GET_OPT_SUGGEST_MAX_LEN 64
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+/* edit distance between strings: number of inserted, deleted, substituted or transposed adjacent characters,
+  returns a value > bound if the distance is greater than the bound */
+static unsigned opt_edit_distance_(
+	const GET_OPT_CHAR a[/*n*/],
+	const unsigned n/*<=GET_OPT_SUGGEST_MAX_LEN*/,
+	const GET_OPT_CHAR b[/*m*/],
+	const unsigned m/*<=GET_OPT_SUGGEST_MAX_LEN*/,
+	const unsigned bound)
+{
+	/* three rows of the distance matrix: previous-previous, previous and current */
+	unsigned rows[3][GET_OPT_SUGGEST_MAX_LEN + 1];
+	unsigned *pp = rows[0], *p = rows[1], *c = rows[2];
+	unsigned i, j;
+	for (j = 0; j <= m; j++)
+		p[j] = j;
+	for (i = 1; i <= n; i++) {
+		unsigned row_min = c[0] = i;
+		for (j = 1; j <= m; j++) {
+			const unsigned del = p[j] + 1;
+			const unsigned ins = c[j - 1] + 1;
+			const unsigned sub = p[j - 1] + (a[i - 1] != b[j - 1]);
+			unsigned d = del < ins ? del : ins;
+			if (sub < d)
+				d = sub;
+			if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1] && pp[j - 2] + 1 < d)
+				d = pp[j - 2] + 1; /* transposition */
+			c[j] = d;
+			if (d < row_min)
+				row_min = d;
+		}
+		if (row_min > bound)
+			return bound + 1; /* distance can only grow */
+		{
+			unsigned *const t = pp;
+			pp = p;
+			p = c;
+			c = t;
+		}
+	}
+	return p[m];
+}
+
+/* find long option with the name most similar to given unknown option, like "--fiel=x" or "-fiel",
+  max_dist - max number of typos, returns NULL if there is no such option */
+static const struct long_opt_info *opt_suggest(
+	const GET_OPT_CHAR *arg/*!=NULL*/,
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	const unsigned max_dist)
+{
+	const struct long_opt_info *best = NULL;
+	unsigned bound = max_dist, len = 0;
+	if (!long_opts)
+		return NULL;
+	if (GET_OPT_TEXT('-') == *arg)
+		arg += 1 + (GET_OPT_TEXT('-') == arg[1]);
+	for (; arg[len] && GET_OPT_TEXT('=') != arg[len]; len++) {
+		if (len == GET_OPT_SUGGEST_MAX_LEN)
+			return NULL;
+	}
+	if (!len)
+		return NULL;
+	for (; long_opts->len; long_opts++) {
+		const unsigned m = long_opts->len;
+		if (m <= GET_OPT_SUGGEST_MAX_LEN && (m > len ? m - len : len - m) <= bound) {
+			const unsigned d = opt_edit_distance_(arg, len, LONG_OPT_NAME(long_opts), m, bound);
+			if (d <= bound) {
+				best = long_opts;
+				if (!d)
+					break;
+				bound = d - 1; /* look for a better match */
+			}
+		}
+	}
+	return best;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int opt_suggest_unused_[sizeof(&opt_suggest)];
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* GET_OPT_HELP_INL_INCLUDED */
@@ -0,0 +1,392 @@
+#ifndef GET_OPT_RSP_INL_INCLUDED
+#define GET_OPT_RSP_INL_INCLUDED
+
+/**********************************************************************************
+* Expansion of response files (@file arguments) for get_opt()
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_rsp.inl */
+
+/* note: #include "get_opt.inl" before this file */
+
+/* this file defines 2 static functions:
+
+   1) opt_rsp_expand - replace @file arguments with arguments read from the files,
+   2) opt_rsp_free   - free resources allocated by opt_rsp_expand().
+
+  Example:
+
+  int main(int argc, char *argv[])
+  {
+    struct opt_rsp r;
+    struct opt_info i;
+    int bad_arg;
+    const int err = opt_rsp_expand(&r, argc, argv, &bad_arg);
+    if (err) {
+      fprintf(stderr, "failed to read response file %s: %s\n", argv[bad_arg] + 1, strerror(err));
+      return 1;
+    }
+  #ifdef GET_OPT_ARGV_NZ
+    opt_info_init(&i, r.argc, r.argv);
+  #else
+    opt_info_init(&i, r.argv);
+  #endif
+    while (!opt_info_is_end(&i)) {
+      switch (get_opt(&i, short_opts, long_opts)) {
+        ...
+      }
+    }
+    opt_rsp_free(&r);
+    return 0;
+  }
+*/
+
+/*=========================== Notes: ============================================================================================
+|
+| 1) an argument "@file" is replaced with the arguments read from the file "file",
+|    arguments after "--" and arguments read from response files are not expanded, "@" alone is not expanded
+|
+| 2) response file format:
+|    . arguments are separated by white space (spaces, tabs, new lines, '\0'),
+|    . white space may be included in an argument if enclosed in single or double quotes: 'a b' or "a b",
+|    . backslash outside of quotes escapes next character: a\ b, \"
+|    . within double quotes, backslash escapes only a double quote or a backslash: "a\"b\\c",
+|    . within single quotes, all characters are taken literally: 'a\b'
+|
+| 3) on POSIX systems, a response file is mapped to memory (copy-on-write) and is tokenized in place:
+|    strings of expanded argv[] point directly into the mapping, so no argument is copied or allocated,
+|    on Windows, the file is read into an allocated buffer
+|
+| 4) with GET_OPT_WIDE_CHAR_SUPPORT, a response file must contain wchar_t characters (e.g. UTF-16LE on Windows)
+|
+| 5) opt_rsp_expand() allocates memory only if there are response files: an array of file mappings
+|    and an array of expanded arguments
+|
+===============================================================================================================================*/
+
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc() */
+#include <errno.h>
+
+#ifdef _WIN32
+#include <stdio.h>  /* for fopen() */
+#else
+#ifdef GET_OPT_WIDE_CHAR_SUPPORT
+#error response files with GET_OPT_WIDE_CHAR_SUPPORT are supported only on Windows
+#endif
+#include <sys/types.h>
+#include <sys/stat.h> /* for fstat() */
+#include <sys/mman.h> /* for mmap() */
+#include <fcntl.h>    /* for open() */
+#include <unistd.h>   /* for close() */
+#if !defined MAP_ANONYMOUS && defined MAP_ANON
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+/* contents of a response file */
+struct opt_rsp_file {
+	GET_OPT_CHAR *buf; /* NULL if the file is empty */
+	size_t size;       /* size of mapping or allocated buffer, in bytes */
+	size_t count;      /* number of arguments stored at the beginning of the buffer */
+};
+
+/* expanded arguments */
+struct opt_rsp {
+	GET_OPT_CHAR **argv;         /* NULL-terminated, argv[0] - program name */
+	int argc;
+	unsigned nfiles;             /* number of response files */
+	struct opt_rsp_file *files;  /* NULL if there are no response files, then argv - is the original argv */
+};
+
+static int opt_rsp_is_space_(const GET_OPT_CHAR c)
+{
+	return GET_OPT_TEXT(' ') == c || GET_OPT_TEXT('\t') == c || GET_OPT_TEXT('\n') == c ||
+		GET_OPT_TEXT('\r') == c || GET_OPT_TEXT('\v') == c || GET_OPT_TEXT('\f') == c || GET_OPT_TEXT('\0') == c;
+}
+
+/* tokenize buffer in place: compact parsed arguments to the beginning of the buffer,
+  each argument is terminated by '\0', e[0] must be writable,
+  returns number of parsed arguments */
+static size_t opt_rsp_tokenize_(
+	GET_OPT_CHAR *const b/*!=NULL*/,
+	GET_OPT_CHAR *const e/*>=b*/)
+{
+	const GET_OPT_CHAR *r = b; /* read pointer */
+	GET_OPT_CHAR *w = b;       /* write pointer, always w <= r */
+	size_t count = 0;
+	for (;;) {
+		GET_OPT_CHAR q = GET_OPT_TEXT('\0'); /* current quote */
+		while (r < e && opt_rsp_is_space_(*r))
+			r++;
+		if (r == e)
+			break;
+		for (; r < e; r++) {
+			const GET_OPT_CHAR c = *r;
+			if (q) {
+				if (c == q)
+					q = GET_OPT_TEXT('\0'); /* closing quote */
+				else if (GET_OPT_TEXT('\\') == c && GET_OPT_TEXT('"') == q && r + 1 < e &&
+					(GET_OPT_TEXT('"') == r[1] || GET_OPT_TEXT('\\') == r[1]))
+				{
+					*w++ = *++r;
+				}
+				else
+					*w++ = c;
+			}
+			else if (opt_rsp_is_space_(c)) {
+				r++; /* so the terminating '\0' do not overwrites unread character */
+				break;
+			}
+			else if (GET_OPT_TEXT('"') == c || GET_OPT_TEXT('\'') == c)
+				q = c; /* opening quote */
+			else if (GET_OPT_TEXT('\\') == c && r + 1 < e)
+				*w++ = *++r;
+			else
+				*w++ = c;
+		}
+		*w++ = GET_OPT_TEXT('\0');
+		count++;
+	}
+	return count;
+}
+
+static void opt_rsp_unmap_(const struct opt_rsp_file *const f/*!=NULL*/)
+{
+	if (f->buf) {
+#ifdef _WIN32
+		free(f->buf);
+#else
+		(void)munmap(f->buf, f->size);
+#endif
+	}
+}
+
+/* read or map a file, one more writable character is reserved after the file contents,
+  returns 0 on success or errno value, *len - number of characters in the file */
+static int opt_rsp_read_(
+	struct opt_rsp_file *const f/*!=NULL,out*/,
+	const GET_OPT_CHAR *const name/*!=NULL*/,
+	size_t *const len/*!=NULL,out*/)
+{
+	size_t n; /* number of characters in the file */
+	f->buf = NULL;
+	f->size = 0;
+	f->count = 0;
+	{
+#ifdef _WIN32
+		FILE *s;
+		long size;
+#ifdef GET_OPT_WIDE_CHAR_SUPPORT
+		if (_wfopen_s(&s, name, L"rb"))
+#elif defined _MSC_VER
+		if (fopen_s(&s, name, "rb"))
+#else
+		if (!(s = fopen(name, "rb")))
+#endif
+			return errno ? errno : ENOENT;
+		if (fseek(s, 0, SEEK_END) || (size = ftell(s)) < 0 || fseek(s, 0, SEEK_SET)) {
+			const int err = errno ? errno : EIO;
+			(void)fclose(s);
+			return err;
+		}
+		n = (size_t)size/sizeof(GET_OPT_CHAR);
+		if (n) {
+			f->size = (n + 1)*sizeof(GET_OPT_CHAR);
+			f->buf = (GET_OPT_CHAR*)malloc(f->size);
+			if (!f->buf) {
+				(void)fclose(s);
+				return ENOMEM;
+			}
+			if (fread(f->buf, sizeof(GET_OPT_CHAR), n, s) != n) {
+				const int err = ferror(s) ? (errno ? errno : EIO) : EIO;
+				(void)fclose(s);
+				free(f->buf);
+				f->buf = NULL;
+				return err;
+			}
+		}
+		(void)fclose(s);
+#else /* !_WIN32 */
+		struct stat st;
+		void *m;
+		const int fd = open(name, O_RDONLY);
+		if (fd < 0)
+			return errno;
+		if (fstat(fd, &st)) {
+			const int err = errno;
+			(void)close(fd);
+			return err;
+		}
+		n = (size_t)st.st_size;
+		if (n) {
+			/* reserve one more byte for the terminating '\0' of the last argument: map the file over anonymous
+			  mapping, so the byte is accessible even if the file size is a multiple of the page size */
+			f->size = n + 1;
+			m = mmap(NULL, f->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (MAP_FAILED == m) {
+				const int err = errno;
+				(void)close(fd);
+				return err;
+			}
+			if (MAP_FAILED == mmap(m, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0)) {
+				const int err = errno;
+				(void)munmap(m, f->size);
+				(void)close(fd);
+				return err;
+			}
+			f->buf = (GET_OPT_CHAR*)m;
+		}
+		(void)close(fd);
+#endif /* !_WIN32 */
+	}
+	*len = n;
+	return 0;
+}
+
+/* read or map response file, tokenize it in place,
+  returns 0 on success or errno value */
+static int opt_rsp_map_(
+	struct opt_rsp_file *const f/*!=NULL,out*/,
+	const GET_OPT_CHAR *const name/*!=NULL*/)
+{
+	size_t n;
+	const int err = opt_rsp_read_(f, name, &n);
+	if (!err && n)
+		f->count = opt_rsp_tokenize_(f->buf, f->buf + n);
+	return err;
+}
+
+static void opt_rsp_unmap_files_(struct opt_rsp *const r/*!=NULL*/)
+{
+	unsigned k = 0;
+	for (; k < r->nfiles; k++)
+		opt_rsp_unmap_(&r->files[k]);
+	free(r->files);
+	r->files = NULL;
+	r->nfiles = 0;
+}
+
+static void opt_rsp_free(struct opt_rsp *const r/*!=NULL*/)
+{
+	if (r->files) {
+		opt_rsp_unmap_files_(r);
+		free(r->argv);
+	}
+	r->argv = NULL;
+	r->argc = 0;
+}
+
+/* check if argument names a response file */
+static int opt_rsp_is_file_(const GET_OPT_CHAR *const arg/*!=NULL*/)
+{
+	return GET_OPT_TEXT('@') == arg[0] && arg[1];
+}
+
+/* replace @file arguments with arguments read from the files,
+  returns 0 on success, or errno value, then *bad_arg - index of @file argument that caused the error */
+static int opt_rsp_expand(
+	struct opt_rsp *const r/*!=NULL,out*/,
+	const int argc/*>0*/,
+	GET_OPT_CHAR *argv[/*argc*/]/*!=NULL,may be not NULL-terminated*/,
+	int *const bad_arg/*NULL?,out*/)
+{
+	size_t total = 0; /* number of expanded arguments */
+	unsigned nfiles = 0;
+	int k = 1, end = argc; /* response files are expanded only before the "--" */
+
+	r->argv = argv;
+	r->argc = argc;
+	r->nfiles = 0;
+	r->files = NULL;
+
+	for (; k < argc; k++) {
+		if (GET_OPT_TEXT('-') == argv[k][0] && GET_OPT_TEXT('-') == argv[k][1] && !argv[k][2]) {
+			end = k;
+			break;
+		}
+		if (opt_rsp_is_file_(argv[k]))
+			nfiles++;
+	}
+	if (!nfiles)
+		return 0; /* nothing to expand */
+
+	r->files = (struct opt_rsp_file*)calloc(nfiles, sizeof(*r->files));
+	if (!r->files)
+		return bad_arg ? (*bad_arg = 0, ENOMEM) : ENOMEM;
+
+	/* map and tokenize response files */
+	for (k = 1; k < end; k++) {
+		if (opt_rsp_is_file_(argv[k])) {
+			const int err = opt_rsp_map_(&r->files[r->nfiles], argv[k] + 1);
+			if (err) {
+				if (bad_arg)
+					*bad_arg = k;
+				opt_rsp_unmap_files_(r);
+				return err;
+			}
+			total += r->files[r->nfiles++].count;
+		}
+	}
+	total += (size_t)argc - nfiles;
+
+	if (total >= 0x7FFFFFFF || !(r->argv = (GET_OPT_CHAR**)malloc((total + 1)*sizeof(*r->argv)))) {
+		if (bad_arg)
+			*bad_arg = 0;
+		r->argv = argv;
+		opt_rsp_unmap_files_(r);
+		return ENOMEM;
+	}
+
+	/* fill expanded arguments array */
+	{
+		GET_OPT_CHAR **a = r->argv;
+		const struct opt_rsp_file *f = r->files;
+		*a++ = argv[0];
+		for (k = 1; k < argc; k++) {
+			if (k < end && opt_rsp_is_file_(argv[k])) {
+				/* arguments are stored one after another, each terminated by '\0' */
+				GET_OPT_CHAR *p = f->buf;
+				size_t n = f->count;
+				for (; n; n--) {
+					*a++ = p;
+					while (*p++) {
+						/* skip argument characters and the terminating '\0' */
+					}
+				}
+				f++;
+			}
+			else
+				*a++ = argv[k];
+		}
+		*a = NULL;
+		r->argc = (int)(a - r->argv);
+	}
+	return 0;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int opt_rsp_expand_unused_[sizeof(&opt_rsp_expand)];
+typedef int opt_rsp_free_unused_[sizeof(&opt_rsp_free)];
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* GET_OPT_RSP_INL_INCLUDED */
@@ -0,0 +1,284 @@
+#ifndef GET_OPT_SRC_INL_INCLUDED
+#define GET_OPT_SRC_INL_INCLUDED
+
+/**********************************************************************************
+* Options from environment variables and configuration files for get_opt()
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_src.inl */
+
+/* note: #include "get_opt.inl" and "get_opt_rsp.inl" before this file */
+
+/* this file defines 4 static functions:
+
+   1) opt_conf_load     - map configuration file and parse its "key = value" lines in place,
+   2) opt_conf_tokenize - look up keys of parsed configuration file in long options, produce tokens,
+   3) opt_conf_free     - free resources allocated by opt_conf_load(),
+   4) opt_env_tokenize  - look up environment variables with given prefix in long options, produce tokens.
+
+  Options from all sources are converted to the same tokens as produced by opt_tokenize() (see "get_opt.inl"),
+  so a program processes them in one pass. Precedence is defined by the order of tokens: an option
+  parsed later overrides the same option parsed earlier, usually: configuration file < environment < command line.
+
+  Example:
+
+  int main(int argc, char *argv[], char *envp[])
+  {
+    struct opt_token tokens[256];
+    struct opt_rsp_file conf;
+    struct opt_info i;
+    unsigned n = 0, k;
+    if (!opt_conf_load(&conf, "app.conf"))
+      n += opt_conf_tokenize(&conf, long_opts, NULL, tokens, 256);
+    if (n <= 256)
+      n += opt_env_tokenize(envp, "APP_", long_opts, NULL, tokens + n, 256 - n);
+    opt_info_init(&i, argv);
+    if (n <= 256)
+      n += opt_tokenize(&i, argv, short_opts, long_opts, NULL, tokens + n, 256 - n);
+    if (n > 256)
+      ... too many options ...
+    for (k = 0; k < n; k++) {
+      switch (tokens[k].opt) {
+        case LONG_OPTION_level:
+          level = tokens[k].value;
+          break;
+        case OPT_UNKNOWN:
+          if (OPT_TOKEN_SOURCE(tokens[k].arg) != OPT_TOKEN_ARGV)
+            fprintf(stderr, "unknown option: %s\n", tokens[k].value);
+          ...
+      }
+    }
+    opt_conf_free(&conf);
+    return 0;
+  }
+*/
+
+/*=========================== Notes: ============================================================================================
+|
+| 1) values of options are not copied: they point into environment strings or into the mapped configuration file
+|
+| 2) environment variable PREFIX_LOG_LEVEL=value is mapped to the long option "log-level": after the prefix,
+|    upper-case letters are converted to lower-case and underscores '_' to dashes '-'
+|
+| 3) configuration file format:
+|    . one option per line, white space around keys and values is ignored,
+|    . empty lines and lines beginning with '#' or ';' are ignored,
+|    . "key = value" or "key=value" - option with a value, the value may be empty: "key =",
+|    . "key" - option without a value, token value is NULL,
+|    . keys are long options names, as specified on the command line, but without leading "--"
+|
+| 4) for an unknown environment variable or configuration file key, OPT_UNKNOWN token is produced,
+|    token value points to the whole environment string "PREFIX_NAME=value" or to the entry "key=value"
+|
+| 5) a configuration file is parsed in place once, by opt_conf_load(), then opt_conf_tokenize() may be called
+|    multiple times - e.g. with a bigger tokens array or with different long options
+|
+===============================================================================================================================*/
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+/* source of a token is encoded in the high bits of 'arg' member of struct opt_token */
+#define OPT_TOKEN_ARGV              0x00000000u /* arg - index in argv[] */
+#define OPT_TOKEN_ENV               0x80000000u /* arg - index of environment variable */
+#define OPT_TOKEN_CONF              0x40000000u /* arg - index of configuration file entry */
+#define OPT_TOKEN_SOURCE(arg)       ((arg) & 0xC0000000u)
+#define OPT_TOKEN_INDEX(arg)        ((arg) & 0x3FFFFFFFu)
+
+/* max length of the name of environment variable after the prefix */
+#ifndef GET_OPT_ENV_NAME_MAX
+#define GET_OPT_ENV_NAME_MAX 64
+#endif
+
+static int opt_conf_is_blank_(const GET_OPT_CHAR c)
+{
+	return GET_OPT_TEXT(' ') == c || GET_OPT_TEXT('\t') == c || GET_OPT_TEXT('\r') == c ||
+		GET_OPT_TEXT('\v') == c || GET_OPT_TEXT('\f') == c;
+}
+
+static int opt_conf_is_eol_(const GET_OPT_CHAR c)
+{
+	return GET_OPT_TEXT('\n') == c || GET_OPT_TEXT('\0') == c;
+}
+
+/* parse configuration file in place: compact entries "key=value" or "key" to the beginning of the buffer,
+  each entry is terminated by '\0', e[0] must be writable, returns number of entries */
+static size_t opt_conf_parse_(
+	GET_OPT_CHAR *const b/*!=NULL*/,
+	GET_OPT_CHAR *const e/*>=b*/)
+{
+	const GET_OPT_CHAR *r = b; /* read pointer */
+	GET_OPT_CHAR *w = b;       /* write pointer, always w <= r */
+	size_t count = 0;
+	while (r < e) {
+		GET_OPT_CHAR *t; /* end of written key or value, excluding trailing white space */
+		while (r < e && opt_conf_is_blank_(*r))
+			r++;
+		if (r == e)
+			break;
+		if (GET_OPT_TEXT('#') == *r || GET_OPT_TEXT(';') == *r || opt_conf_is_eol_(*r)) {
+			/* skip comment or empty line */
+			while (r < e && !opt_conf_is_eol_(*r))
+				r++;
+			r++;
+			continue;
+		}
+		for (t = w; r < e && !opt_conf_is_eol_(*r) && GET_OPT_TEXT('=') != *r; r++) {
+			*w++ = *r;
+			if (!opt_conf_is_blank_(*r))
+				t = w;
+		}
+		w = t; /* trim key */
+		if (r < e && GET_OPT_TEXT('=') == *r) {
+			*w++ = *r++;
+			while (r < e && opt_conf_is_blank_(*r))
+				r++;
+			for (t = w; r < e && !opt_conf_is_eol_(*r); r++) {
+				*w++ = *r;
+				if (!opt_conf_is_blank_(*r))
+					t = w;
+			}
+			w = t; /* trim value */
+		}
+		r++; /* so the terminating '\0' do not overwrites unread character */
+		*w++ = GET_OPT_TEXT('\0');
+		count++;
+	}
+	return count;
+}
+
+/* map configuration file and parse it in place, returns 0 on success or errno value */
+static int opt_conf_load(
+	struct opt_rsp_file *const f/*!=NULL,out*/,
+	const GET_OPT_CHAR *const name/*!=NULL*/)
+{
+	size_t n;
+	const int err = opt_rsp_read_(f, name, &n);
+	if (!err && n)
+		f->count = opt_conf_parse_(f->buf, f->buf + n);
+	return err;
+}
+
+static void opt_conf_free(struct opt_rsp_file *const f/*!=NULL*/)
+{
+	opt_rsp_unmap_(f);
+	f->buf = NULL;
+	f->size = 0;
+	f->count = 0;
+}
+
+/* find long option by name, x - options index (NULL?), returns encoded long option or OPT_UNKNOWN */
+static int opt_src_find_(
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	const struct opt_index *const x/*NULL?*/,
+	const GET_OPT_CHAR *const name/*!=NULL*/,
+	const unsigned len,
+	const unsigned hash)
+{
+	const struct long_opt_info *lo;
+	if (x) {
+		long_opts = x->long_hash.long_opts;
+		lo = long_opts ? long_opt_hash_find_(&x->long_hash, name, len, hash) : NULL;
+	}
+	else
+		lo = long_opts ? opt_long_find_(long_opts, name, len) : NULL;
+	return lo ? LONG_OPT((int)(unsigned)(lo - long_opts)) : OPT_UNKNOWN;
+}
+
+/* look up keys of parsed configuration file in long options, x - options index (NULL?),
+  if x != NULL, long_opts is ignored, stores at most max_tokens tokens, returns total number of tokens */
+static unsigned opt_conf_tokenize(
+	const struct opt_rsp_file *const f/*!=NULL*/,
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	const struct opt_index *const x/*NULL?*/,
+	struct opt_token tokens[/*max_tokens*/]/*NULL?,out*/,
+	const unsigned max_tokens)
+{
+	GET_OPT_CHAR *p = f->buf;
+	unsigned n = 0;
+	for (; n < f->count; n++) {
+		GET_OPT_CHAR *v;
+		unsigned hash;
+		const unsigned len = opt_long_name_(p, &v, &hash);
+		if (n < max_tokens) {
+			const int opt = len ? opt_src_find_(long_opts, x, p, len, hash) : OPT_UNKNOWN;
+			tokens[n].opt = opt;
+			tokens[n].arg = OPT_TOKEN_CONF | n;
+			tokens[n].value = OPT_UNKNOWN == opt ? p : v ? v + 1 : NULL;
+		}
+		p += len;
+		while (*p++) {
+			/* skip the value and the terminating '\0' */
+		}
+	}
+	return n;
+}
+
+/* look up environment variables with given prefix in long options, x - options index (NULL?),
+  if x != NULL, long_opts is ignored, stores at most max_tokens tokens, returns total number of tokens */
+static unsigned opt_env_tokenize(
+	GET_OPT_CHAR *const envp[]/*!=NULL,NULL-terminated*/,
+	const GET_OPT_CHAR prefix[]/*!=NULL*/,
+	const struct long_opt_info long_opts[]/*NULL?*/,
+	const struct opt_index *const x/*NULL?*/,
+	struct opt_token tokens[/*max_tokens*/]/*NULL?,out*/,
+	const unsigned max_tokens)
+{
+	unsigned n = 0, k = 0;
+	for (; envp[k]; k++) {
+		GET_OPT_CHAR *s = envp[k];
+		const GET_OPT_CHAR *p = prefix;
+		for (; *p && *p == *s; p++)
+			s++;
+		if (!*p) {
+			/* map the name: "LOG_LEVEL" -> "log-level" */
+			GET_OPT_CHAR name[GET_OPT_ENV_NAME_MAX];
+			unsigned hash = GET_OPT_HASH_INIT;
+			unsigned len = 0;
+			for (; *s && GET_OPT_TEXT('=') != *s && len < GET_OPT_ENV_NAME_MAX; s++) {
+				GET_OPT_CHAR c = *s;
+				if (GET_OPT_TEXT('A') <= c && c <= GET_OPT_TEXT('Z'))
+					c = (GET_OPT_CHAR)(c - GET_OPT_TEXT('A') + GET_OPT_TEXT('a'));
+				else if (GET_OPT_TEXT('_') == c)
+					c = GET_OPT_TEXT('-');
+				name[len++] = c;
+				hash = GET_OPT_HASH_STEP(hash, c);
+			}
+			if (n < max_tokens) {
+				/* too long name is not an option name */
+				const int opt = len && (!*s || GET_OPT_TEXT('=') == *s) ?
+					opt_src_find_(long_opts, x, name, len, hash) : OPT_UNKNOWN;
+				tokens[n].opt = opt;
+				tokens[n].arg = OPT_TOKEN_ENV | k;
+				tokens[n].value = OPT_UNKNOWN == opt ? envp[k] : *s ? s + 1 : NULL;
+			}
+			n++;
+		}
+	}
+	return n;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int opt_conf_load_unused_[sizeof(&opt_conf_load)];
+typedef int opt_conf_tokenize_unused_[sizeof(&opt_conf_tokenize)];
+typedef int opt_conf_free_unused_[sizeof(&opt_conf_free)];
+typedef int opt_env_tokenize_unused_[sizeof(&opt_env_tokenize)];
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* GET_OPT_SRC_INL_INCLUDED */
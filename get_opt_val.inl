@@ -0,0 +1,322 @@
+#ifndef GET_OPT_VAL_INL_INCLUDED
+#define GET_OPT_VAL_INL_INCLUDED
+
+/**********************************************************************************
+* Conversion of option values parsed by get_opt()
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_val.inl */
+
+/* note: #include "get_opt.inl" before this file */
+
+/* this file defines 6 static functions:
+
+   1) opt_val_uint     - convert value to unsigned integer in given range,
+   2) opt_val_int      - convert value to signed integer in given range,
+   3) opt_val_size     - convert value with optional size suffix, like "64K" or "2GiB", to number of bytes,
+   4) opt_val_duration - convert value with time units, like "150ms" or "1h30m", to nanoseconds,
+   5) opt_val_bool     - convert value like "yes"/"no", "on"/"off", "true"/"false", "1"/"0" to boolean,
+   6) opt_val_enum     - look up value in an array of names defined the same way as long options.
+
+  All functions return 0 on success, EINVAL if the value is NULL, empty or has wrong format,
+  or ERANGE if the value is out of range, on error the output is not changed.
+
+  Example:
+
+  case LONG_OPTION_level:
+    if (opt_val_uint(i.value, 0, 9, &level)) {
+      fprintf(stderr, "bad level: %s\n", i.value ? i.value : "<none>");
+      return 1;
+    }
+    break;
+*/
+
+/*=========================== Notes: ============================================================================================
+|
+| 1) parsers do not depend on the current locale and do not use strtol()/strtod():
+|    only ASCII digits and latin letters are recognized, white space is not skipped
+|
+| 2) integers are decimal or hexadecimal, with "0x" or "0X" prefix, a signed integer may have leading '-' or '+'
+|
+| 3) size suffixes are binary, case-insensitive and may be followed by "B" or "iB":
+|    K - 2^10, M - 2^20, G - 2^30, T - 2^40, P - 2^50, E - 2^60, for example: "4096", "64K", "64KB", "2GiB", "100B"
+|
+| 4) duration is a sequence of integers followed by units: ns, us, ms, s, m (minutes), h, d,
+|    for example: "150ms", "1h30m", "2s500ms", a single integer without a unit is multiplied by given default unit
+|
+| 5) enumeration names are defined as long options names, e.g.:
+|
+|    #define COLOR_red     LONG_OPT_MODIFIER("red",   0, COLOR_green)
+|    #define COLOR_green   LONG_OPT_MODIFIER("green", 0, LONG_OPT_NULL)
+|    static const struct long_opt_info colors[] = {COLOR_red};
+|
+|    opt_val_enum() returns encoded index - the same as get_opt() returns for a long option,
+|    so after redefining LONG_OPT_MODIFIER as LONG_OPT_ENCODER, COLOR_red and COLOR_green may be used as case labels
+|
+===============================================================================================================================*/
+
+#include <errno.h>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+/* convert ASCII letter to lower case, other characters are not changed */
+static unsigned opt_val_lower_(const GET_OPT_CHAR c)
+{
+	const unsigned u = (unsigned)c;
+	return (u - 'A' < 26u) ? (u | 0x20u) : u;
+}
+
+/* check if value, converted to lower case, is equal to given lower-case name */
+static int opt_val_is_(
+	const GET_OPT_CHAR *v/*!=NULL*/,
+	const char *n/*!=NULL*/)
+{
+	for (; *n; v++, n++) {
+		if (opt_val_lower_(*v) != (unsigned char)*n)
+			return 0;
+	}
+	return !*v;
+}
+
+/* parse decimal or hexadecimal digits, *s - advanced to the first non-digit character,
+  returns 0, EINVAL if there are no digits or ERANGE on overflow */
+static int opt_val_digits_(
+	const GET_OPT_CHAR **const s/*!=NULL,in/out*/,
+	unsigned long long *const r/*!=NULL,out*/)
+{
+	const GET_OPT_CHAR *p = *s;
+	unsigned long long x = 0;
+	if (GET_OPT_TEXT('0') == p[0] && GET_OPT_TEXT('x') == (GET_OPT_CHAR)opt_val_lower_(p[1])) {
+		const GET_OPT_CHAR *const b = (p += 2);
+		for (;; p++) {
+			const unsigned c = opt_val_lower_(*p);
+			const unsigned d = (c - '0' < 10u) ? c - '0' : (c - 'a' < 6u) ? c - 'a' + 10 : 16u;
+			if (d > 15)
+				break;
+			if (x >> 60)
+				return ERANGE;
+			x = (x << 4) | d;
+		}
+		if (p == b)
+			return EINVAL;
+	}
+	else {
+		const GET_OPT_CHAR *const b = p;
+		for (;; p++) {
+			const unsigned d = (unsigned)*p - '0';
+			if (d > 9)
+				break;
+			/* x*10 + d must not overflow */
+			if (x > (~0ull - d)/10)
+				return ERANGE;
+			x = x*10 + d;
+		}
+		if (p == b)
+			return EINVAL;
+	}
+	*s = p;
+	*r = x;
+	return 0;
+}
+
+/* convert value to unsigned integer in range [min, max] */
+static int opt_val_uint(
+	const GET_OPT_CHAR *v/*NULL?*/,
+	const unsigned long long min,
+	const unsigned long long max/*>=min*/,
+	unsigned long long *const out/*!=NULL,out*/)
+{
+	unsigned long long x;
+	int err;
+	if (!v)
+		return EINVAL;
+	err = opt_val_digits_(&v, &x);
+	if (err)
+		return err;
+	if (*v)
+		return EINVAL;
+	if (x < min || x > max)
+		return ERANGE;
+	*out = x;
+	return 0;
+}
+
+/* convert value to signed integer in range [min, max] */
+static int opt_val_int(
+	const GET_OPT_CHAR *v/*NULL?*/,
+	const long long min,
+	const long long max/*>=min*/,
+	long long *const out/*!=NULL,out*/)
+{
+	const unsigned long long lim = ~0ull >> 1; /* LLONG_MAX */
+	unsigned long long x;
+	long long y;
+	int neg, err;
+	if (!v)
+		return EINVAL;
+	neg = GET_OPT_TEXT('-') == *v;
+	if (neg || GET_OPT_TEXT('+') == *v)
+		v++;
+	err = opt_val_digits_(&v, &x);
+	if (err)
+		return err;
+	if (*v)
+		return EINVAL;
+	if (x > lim + (unsigned)neg)
+		return ERANGE;
+	/* -(LLONG_MAX + 1) is computed without overflow */
+	y = !neg ? (long long)x : x ? -(long long)(x - 1) - 1 : 0;
+	if (y < min || y > max)
+		return ERANGE;
+	*out = y;
+	return 0;
+}
+
+/* convert value with optional size suffix to number of bytes, not greater than max */
+static int opt_val_size(
+	const GET_OPT_CHAR *v/*NULL?*/,
+	const unsigned long long max,
+	unsigned long long *const out/*!=NULL,out*/)
+{
+	unsigned long long x;
+	unsigned shift = 0;
+	int err;
+	if (!v)
+		return EINVAL;
+	err = opt_val_digits_(&v, &x);
+	if (err)
+		return err;
+	switch (opt_val_lower_(*v)) {
+		case 'k': shift = 10; break;
+		case 'm': shift = 20; break;
+		case 'g': shift = 30; break;
+		case 't': shift = 40; break;
+		case 'p': shift = 50; break;
+		case 'e': shift = 60; break;
+		default: break;
+	}
+	if (shift) {
+		v++;
+		if ('i' == opt_val_lower_(*v) && 'b' == opt_val_lower_(v[1]))
+			v++; /* "KiB" */
+	}
+	if ('b' == opt_val_lower_(*v))
+		v++; /* "KB" or "100B" */
+	if (*v)
+		return EINVAL;
+	if (x > (~0ull >> shift))
+		return ERANGE;
+	x <<= shift;
+	if (x > max)
+		return ERANGE;
+	*out = x;
+	return 0;
+}
+
+/* convert value with time units to nanoseconds, not greater than max_ns,
+  unit_ns - multiplier of a single integer specified without a unit, 0 - unit is required */
+static int opt_val_duration(
+	const GET_OPT_CHAR *v/*NULL?*/,
+	const unsigned long long unit_ns,
+	const unsigned long long max_ns,
+	unsigned long long *const out/*!=NULL,out*/)
+{
+	unsigned long long sum = 0;
+	const GET_OPT_CHAR *const b = v;
+	if (!v)
+		return EINVAL;
+	do {
+		const GET_OPT_CHAR *const part = v;
+		unsigned long long x, mul;
+		unsigned c;
+		const int err = opt_val_digits_(&v, &x);
+		if (err)
+			return err;
+		c = opt_val_lower_(*v);
+		if ('s' == opt_val_lower_(v[1]) && ('n' == c || 'u' == c || 'm' == c)) {
+			mul = 'n' == c ? 1u : 'u' == c ? 1000u : 1000000u;
+			v += 2;
+		}
+		else if ('s' == c || 'm' == c || 'h' == c || 'd' == c) {
+			mul = 's' == c ? 1000000000ull : 'm' == c ? 60000000000ull : 'h' == c ? 3600000000000ull : 86400000000000ull;
+			v++;
+		}
+		else if (part == b && !*v && unit_ns)
+			mul = unit_ns; /* single integer without a unit */
+		else
+			return EINVAL;
+		if (x > ~0ull/mul || x*mul > ~0ull - sum)
+			return ERANGE;
+		sum += x*mul;
+	} while (*v);
+	if (sum > max_ns)
+		return ERANGE;
+	*out = sum;
+	return 0;
+}
+
+/* convert value to boolean, NULL value (option without a value) is true */
+static int opt_val_bool(
+	const GET_OPT_CHAR *const v/*NULL?*/,
+	int *const out/*!=NULL,out*/)
+{
+	if (!v || opt_val_is_(v, "1") || opt_val_is_(v, "yes") || opt_val_is_(v, "on") || opt_val_is_(v, "true"))
+		*out = 1;
+	else if (opt_val_is_(v, "0") || opt_val_is_(v, "no") || opt_val_is_(v, "off") || opt_val_is_(v, "false"))
+		*out = 0;
+	else
+		return EINVAL;
+	return 0;
+}
+
+/* look up value in the array of names, h - hash table of the names built by long_opt_hash_init() (NULL?),
+  *out - encoded index of the name, as get_opt() returns for a long option */
+static int opt_val_enum(
+	const GET_OPT_CHAR *const v/*NULL?*/,
+	const struct long_opt_info names[]/*!=NULL*/,
+	const struct long_opt_hash *const h/*NULL?*/,
+	int *const out/*!=NULL,out*/)
+{
+	GET_OPT_CHAR *e;
+	unsigned hash, len;
+	const struct long_opt_info *lo;
+	if (!v)
+		return EINVAL;
+	/* note: opt_long_name_() does not modify the value */
+	len = opt_long_name_((GET_OPT_CHAR*)v, &e, &hash);
+	if (!len || e)
+		return EINVAL;
+	lo = h ? long_opt_hash_find_(h, v, len, hash) : opt_long_find_(names, v, len);
+	if (!lo)
+		return EINVAL;
+	*out = LONG_OPT((int)(unsigned)(lo - names));
+	return 0;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int opt_val_uint_unused_[sizeof(&opt_val_uint)];
+typedef int opt_val_int_unused_[sizeof(&opt_val_int)];
+typedef int opt_val_size_unused_[sizeof(&opt_val_size)];
+typedef int opt_val_duration_unused_[sizeof(&opt_val_duration)];
+typedef int opt_val_bool_unused_[sizeof(&opt_val_bool)];
+typedef int opt_val_enum_unused_[sizeof(&opt_val_enum)];
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* GET_OPT_VAL_INL_INCLUDED */
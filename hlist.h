@@ -0,0 +1,201 @@
+#ifndef HLIST_H_INCLUDED
+#define HLIST_H_INCLUDED
+
+/**********************************************************************************
+* Intrusive doubly-linked list with a single-pointer head
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* hlist.h */
+
+/* defines:
+
+  struct hlist_head                     - head of the list - one pointer,
+  struct hlist_node                     - list link, embedded in a list element,
+
+  hlist_init(h)                         - initialize empty list,
+  hlist_node_init(n)                    - initialize unlinked element, so hlist_is_linked(n) returns false,
+  hlist_is_empty(h)                     - check if list has no elements,
+  hlist_is_linked(n)                    - check if element is linked (after hlist_node_init() or hlist_remove_init()),
+  hlist_add_head(h, n)                  - link element at the beginning of the list,
+  hlist_add_before(pos, n)              - link element before given linked one,
+  hlist_add_after(pos, n)               - link element after given linked one,
+  hlist_remove(n)                       - unlink element,
+  hlist_remove_init(n)                  - unlink element and re-initialize it,
+  hlist_move_list(from, to)             - move all elements to another (empty) list head,
+  hlist_first(h)                        - first element or NULL,
+
+  HLIST_ENTRY(n, type, member)          - get element containing the link, CONTAINER_OF() (see "ccasts.h"),
+  HLIST_OPT_ENTRY(n, type, member)      - same as HLIST_ENTRY(), but returns NULL if n is NULL,
+  HLIST_FOR_EACH(n, h)                  - iterate over the list,
+  HLIST_FOR_EACH_SAFE(n, t, h)          - iterate over the list, current element may be unlinked.
+
+  The list is intended for buckets of hash tables: the head is half the size of struct dlist_entry (see "dlist.h"),
+  an element is still unlinked in O(1) - without knowing the head, but the last element cannot be reached in O(1).
+*/
+
+/* usage:
+
+struct conn {
+	unsigned id;
+	struct hlist_node hash; // link in the bucket of the table of connections
+};
+
+static struct hlist_head conns[256];
+
+void conn_add(struct conn *const c)
+{
+	hlist_add_head(&conns[c->id & 255], &c->hash);
+}
+
+struct conn *conn_find(const unsigned id)
+{
+	struct hlist_node *n;
+	HLIST_FOR_EACH(n, &conns[id & 255]) {
+		struct conn *const c = HLIST_ENTRY(n, struct conn, hash);
+		if (c->id == id)
+			return c;
+	}
+	return NULL;
+}
+*/
+
+/* Implementation notes:
+
+  1) 'pprev' points to the 'next' member of the previous element or to the 'first' member of the head,
+    so unlinking of the first element needs no special case and no pointer to the head,
+  2) a zero-initialized head is an empty list, so static tables of buckets need no initialization. */
+
+#include "ccasts.h" /* for CONTAINER_OF(), ASSERT() */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct hlist_node {
+	struct hlist_node *next;
+	struct hlist_node **pprev; /* NULL if the element is not linked */
+};
+
+struct hlist_head {
+	struct hlist_node *first;
+};
+
+A_Force_inline_function
+static void hlist_init(struct hlist_head *const h/*!=NULL,out*/)
+{
+	h->first = (struct hlist_node*)0;
+}
+
+A_Force_inline_function
+static void hlist_node_init(struct hlist_node *const n/*!=NULL,out*/)
+{
+	n->next = (struct hlist_node*)0;
+	n->pprev = (struct hlist_node**)0;
+}
+
+A_Force_inline_function
+static int hlist_is_empty(const struct hlist_head *const h/*!=NULL*/)
+{
+	return !h->first;
+}
+
+A_Force_inline_function
+static int hlist_is_linked(const struct hlist_node *const n/*!=NULL*/)
+{
+	return !!n->pprev;
+}
+
+A_Force_inline_function
+static void hlist_add_head(
+	struct hlist_head *const h/*!=NULL*/,
+	struct hlist_node *const n/*!=NULL,not linked*/)
+{
+	struct hlist_node *const first = h->first;
+	n->next = first;
+	if (first)
+		first->pprev = &n->next;
+	h->first = n;
+	n->pprev = &h->first;
+}
+
+A_Force_inline_function
+static void hlist_add_before(
+	struct hlist_node *const pos/*!=NULL,linked*/,
+	struct hlist_node *const n/*!=NULL,not linked*/)
+{
+	ASSERT(pos->pprev && *pos->pprev == pos); /* list is corrupted or pos is not linked */
+	n->pprev = pos->pprev;
+	n->next = pos;
+	pos->pprev = &n->next;
+	*n->pprev = n;
+}
+
+A_Force_inline_function
+static void hlist_add_after(
+	struct hlist_node *const pos/*!=NULL,linked*/,
+	struct hlist_node *const n/*!=NULL,not linked*/)
+{
+	ASSERT(pos->pprev && *pos->pprev == pos); /* list is corrupted or pos is not linked */
+	n->next = pos->next;
+	pos->next = n;
+	n->pprev = &pos->next;
+	if (n->next)
+		n->next->pprev = &n->next;
+}
+
+A_Force_inline_function
+static void hlist_remove(struct hlist_node *const n/*!=NULL,linked*/)
+{
+	struct hlist_node *const next = n->next;
+	struct hlist_node **const pprev = n->pprev;
+	ASSERT(pprev && *pprev == n); /* list is corrupted or element is not linked */
+	*pprev = next;
+	if (next)
+		next->pprev = pprev;
+}
+
+A_Force_inline_function
+static void hlist_remove_init(struct hlist_node *const n/*!=NULL,linked*/)
+{
+	hlist_remove(n);
+	hlist_node_init(n);
+}
+
+/* move all elements to another list, 'from' becomes empty, previous elements of 'to' are lost */
+A_Force_inline_function
+static void hlist_move_list(
+	struct hlist_head *const from/*!=NULL*/,
+	struct hlist_head *const to/*!=NULL,empty*/)
+{
+	to->first = from->first;
+	if (to->first)
+		to->first->pprev = &to->first;
+	from->first = (struct hlist_node*)0;
+}
+
+/* note: like strchr(), returns non-const pointer for a const list */
+A_Force_inline_function
+static struct hlist_node *hlist_first(const struct hlist_head *const h/*!=NULL*/)
+{
+	return h->first;
+}
+
+/* get element containing the link, n - pointer to const link requires const type */
+#define HLIST_ENTRY(n, type, member)      CONTAINER_OF(n, type, member)
+#define HLIST_OPT_ENTRY(n, type, member)  OPT_CONTAINER_OF(n, type, member)
+
+/* n - iterator, pointer to (const?) struct hlist_node */
+#define HLIST_FOR_EACH(n, h) \
+	for ((n) = (h)->first; (n); (n) = (n)->next)
+
+/* t - temporary pointer to the next link, current element n may be unlinked in the loop */
+#define HLIST_FOR_EACH_SAFE(n, t, h) \
+	for ((n) = (h)->first; (n) && ((t) = (n)->next, 1); (n) = (t))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HLIST_H_INCLUDED */
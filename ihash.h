@@ -0,0 +1,497 @@
+#ifndef IHASH_H_INCLUDED
+#define IHASH_H_INCLUDED
+
+/**********************************************************************************
+* Intrusive open-addressing hash table
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* ihash.h */
+
+/* defines:
+
+  struct ihash_node                     - hook embedded in an element, caches the hash of element key,
+  struct ihash                          - hash table of pointers to hooks,
+
+  ihash_init(t)                         - initialize empty table, no memory is allocated,
+  ihash_destroy(t)                      - free memory allocated by the table (elements are not touched),
+  ihash_count(t)                        - number of elements in the table,
+  ihash_find(t, hash, key, eq)          - find element by key, returns NULL if not found,
+  ihash_insert(t, n, hash)              - insert element, returns 0 or ENOMEM,
+  ihash_remove(t, n)                    - remove inserted element,
+  ihash_next(t, pos)                    - iterate over elements of the table,
+  ihash_mix(x)                          - mix bits of a weak hash value, like a pointer or an integer key,
+
+  IHASH_ENTRY(n, type, member)          - get element containing the hook, CONTAINER_OF() (see "ccasts.h"),
+  IHASH_OPT_ENTRY(n, type, member)      - same as IHASH_ENTRY(), but returns NULL if n is NULL.
+*/
+
+/* usage:
+
+struct conn {
+	struct five_tuple key;
+	struct ihash_node hook;
+	...
+};
+
+static int conn_eq(const struct ihash_node *const n, const void *const key)
+{
+	const struct conn *const c = IHASH_ENTRY(n, const struct conn, hook);
+	return !memcmp(&c->key, key, sizeof(c->key));
+}
+
+struct ihash conns;
+ihash_init(&conns);
+
+// insert
+if (ihash_insert(&conns, &c->hook, five_tuple_hash(&c->key)))
+	... out of memory ...
+
+// look up
+struct conn *const c = IHASH_OPT_ENTRY(ihash_find(&conns, five_tuple_hash(&key), &key, conn_eq), struct conn, hook);
+
+// remove - without looking up the key
+ihash_remove(&conns, &c->hook);
+
+// iterate, e.g. to free elements before ihash_destroy()
+size_t pos = 0;
+struct ihash_node *n;
+while ((n = ihash_next(&conns, &pos)) != NULL)
+	...
+*/
+
+/* Implementation notes:
+
+  1) the table is an array of pointers to hooks (slots) and a parallel array of control bytes: for a used slot,
+    the control byte holds 7 bits of the hash value (fingerprint), other values mark empty and deleted slots,
+  2) slots are probed by groups of 16: control bytes of a group are compared with the fingerprint at once,
+    via SSE2 if available, so for most lookups only one element is accessed - the one with matching key,
+  3) the full hash value is cached in the hook, so the key of an element is compared only if hashes are equal,
+    and elements are moved to a new table without re-computing hashes,
+  4) the table grows incrementally: when it is full, a new table is allocated, then each insertion moves
+    a few elements from the old table to the new one - the cost of rehashing is spread over insertions,
+    while the old table is not empty, elements are looked up in both tables,
+  5) the hash value must be well-distributed in all bits - low 7 bits are used as the fingerprint and the rest
+    select the group, a weak hash may be improved via ihash_mix(),
+  6) the table must not be modified while iterating over it. */
+
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc() */
+#include <string.h> /* for memset() */
+#include <errno.h>  /* for ENOMEM */
+#include "ccasts.h" /* for CONTAINER_OF(), ASSERT() */
+
+/* use SSE2 to match control bytes of a group, may be disabled by defining IHASH_NO_SIMD */
+#if !defined IHASH_NO_SIMD && !defined IHASH_SSE2
+#if defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define IHASH_SSE2
+#endif
+#endif
+
+#ifdef IHASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h> /* for _BitScanForward() */
+#endif
+
+/* min number of slots of the old table moved to the new one on each insertion */
+#ifndef IHASH_MIGRATE_MIN
+#define IHASH_MIGRATE_MIN 32
+#endif
+
+#ifndef IHASH_MALLOC
+#define IHASH_MALLOC(sz) malloc(sz)
+#endif
+
+#ifndef IHASH_FREE
+#define IHASH_FREE(p) free(p)
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* hook of an element */
+struct ihash_node {
+	size_t hash; /* set by ihash_insert() */
+};
+
+/* one table of slots */
+struct ihash_tab_ {
+	struct ihash_node **slots;  /* NULL if not allocated */
+	unsigned char *ctrl;        /* control bytes, follow the slots in the same memory block */
+	size_t mask;                /* number of slots - 1, number of slots is a power of two, a multiple of the group size */
+	size_t growth_left;         /* number of empty slots that may be used before the table is full */
+};
+
+struct ihash {
+	struct ihash_tab_ cur;      /* new elements are inserted in this table */
+	struct ihash_tab_ old;      /* elements are moved from this table to 'cur', old.slots == NULL if none */
+	size_t migrate_pos;         /* next slot of the old table to move */
+	size_t migrate_step;        /* number of slots of the old table to check on each insertion */
+	size_t count;               /* total number of elements in both tables */
+};
+
+/* compare an element with the key, the hash of the element is equal to the hash of the key */
+typedef int ihash_eq_t(const struct ihash_node *n, const void *key);
+
+#define IHASH_GROUP_    16u
+#define IHASH_EMPTY_    0x80u   /* control byte of an empty slot */
+#define IHASH_DELETED_  0xFEu   /* control byte of a slot of removed element - do not stop probing */
+#define IHASH_H2_(hash) ((unsigned)(hash) & 0x7Fu)
+
+/* get element containing the hook, n - pointer to const hook requires const type */
+#define IHASH_ENTRY(n, type, member)      CONTAINER_OF(n, type, member)
+#define IHASH_OPT_ENTRY(n, type, member)  OPT_CONTAINER_OF(n, type, member)
+
+A_Const_function
+A_Force_inline_function
+static unsigned ihash_ctz_(const unsigned m/*!=0*/)
+{
+#ifdef _MSC_VER
+	unsigned long b;
+	_BitScanForward(&b, m);
+	return (unsigned)b;
+#else
+	return (unsigned)__builtin_ctz(m);
+#endif
+}
+
+/* bit mask of slots of the group with given control byte */
+A_Force_inline_function
+static unsigned ihash_match_(const unsigned char g[/*IHASH_GROUP_*/], const unsigned c)
+{
+#ifdef IHASH_SSE2
+	const __m128i x = _mm_loadu_si128((const __m128i*)(const void*)g);
+	return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8((char)c)));
+#else
+	unsigned m = 0, k = 0;
+	for (; k < IHASH_GROUP_; k++)
+		m |= (unsigned)(g[k] == c) << k;
+	return m;
+#endif
+}
+
+/* bit mask of empty or deleted slots of the group - with the high bit set in the control byte */
+A_Force_inline_function
+static unsigned ihash_match_free_(const unsigned char g[/*IHASH_GROUP_*/])
+{
+#ifdef IHASH_SSE2
+	return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(const void*)g));
+#else
+	unsigned m = 0, k = 0;
+	for (; k < IHASH_GROUP_; k++)
+		m |= (unsigned)(g[k] >> 7) << k;
+	return m;
+#endif
+}
+
+/* find element in the table */
+A_Force_inline_function
+static struct ihash_node *ihash_tab_find_(
+	const struct ihash_tab_ *const tab/*!=NULL,allocated*/,
+	const size_t hash,
+	const void *const key,
+	ihash_eq_t *const eq/*!=NULL*/)
+{
+	const size_t gmask = tab->mask/IHASH_GROUP_;
+	size_t g = (hash >> 7) & gmask;
+	size_t step = 0;
+	for (;;) {
+		const unsigned char *const c = tab->ctrl + g*IHASH_GROUP_;
+		unsigned m = ihash_match_(c, IHASH_H2_(hash));
+		for (; m; m &= m - 1) {
+			struct ihash_node *const n = tab->slots[g*IHASH_GROUP_ + ihash_ctz_(m)];
+			if (n->hash == hash && eq(n, key))
+				return n;
+		}
+		if (ihash_match_(c, IHASH_EMPTY_))
+			return NULL; /* element would be inserted in this group */
+		/* triangular probing visits all groups */
+		g = (g + ++step) & gmask;
+	}
+}
+
+/* insert element in the table, table must have an empty slot */
+static void ihash_tab_insert_(
+	struct ihash_tab_ *const tab/*!=NULL,allocated*/,
+	struct ihash_node *const n/*!=NULL*/)
+{
+	const size_t gmask = tab->mask/IHASH_GROUP_;
+	size_t g = (n->hash >> 7) & gmask;
+	size_t step = 0;
+	for (;;) {
+		const unsigned m = ihash_match_free_(tab->ctrl + g*IHASH_GROUP_);
+		if (m) {
+			const size_t i = g*IHASH_GROUP_ + ihash_ctz_(m);
+			if (IHASH_EMPTY_ == tab->ctrl[i]) {
+				ASSERT(tab->growth_left);
+				tab->growth_left--;
+			}
+			tab->ctrl[i] = (unsigned char)IHASH_H2_(n->hash);
+			tab->slots[i] = n;
+			return;
+		}
+		g = (g + ++step) & gmask;
+	}
+}
+
+/* remove element from the table, returns 0 if element is not found */
+static int ihash_tab_remove_(
+	struct ihash_tab_ *const tab/*!=NULL,allocated*/,
+	const struct ihash_node *const n/*!=NULL*/)
+{
+	const size_t gmask = tab->mask/IHASH_GROUP_;
+	size_t g = (n->hash >> 7) & gmask;
+	size_t step = 0;
+	for (;;) {
+		unsigned char *const c = tab->ctrl + g*IHASH_GROUP_;
+		unsigned m = ihash_match_(c, IHASH_H2_(n->hash));
+		const unsigned e = ihash_match_(c, IHASH_EMPTY_);
+		for (; m; m &= m - 1) {
+			const unsigned k = ihash_ctz_(m);
+			if (tab->slots[g*IHASH_GROUP_ + k] == n) {
+				/* if the group has an empty slot, no lookup has probed past the group - slot may become empty */
+				if (e) {
+					c[k] = (unsigned char)IHASH_EMPTY_;
+					tab->growth_left++;
+				}
+				else
+					c[k] = (unsigned char)IHASH_DELETED_;
+				return 1;
+			}
+		}
+		if (e)
+			return 0;
+		g = (g + ++step) & gmask;
+	}
+}
+
+/* allocate empty table, capacity - power of two, a multiple of the group size */
+static int ihash_tab_alloc_(
+	struct ihash_tab_ *const tab/*!=NULL,out*/,
+	const size_t capacity)
+{
+	void *m;
+	if (capacity > ((size_t)-1)/(sizeof(struct ihash_node*) + 1))
+		return ENOMEM;
+	m = IHASH_MALLOC(capacity*(sizeof(struct ihash_node*) + 1));
+	if (!m)
+		return ENOMEM;
+	tab->slots = (struct ihash_node**)m;
+	tab->ctrl = (unsigned char*)(tab->slots + capacity);
+	tab->mask = capacity - 1;
+	tab->growth_left = capacity - capacity/8; /* max load factor: 7/8 */
+	memset(tab->ctrl, IHASH_EMPTY_, capacity);
+	return 0;
+}
+
+A_Force_inline_function
+static void ihash_init(struct ihash *const t/*!=NULL,out*/)
+{
+	t->cur.slots = NULL;
+	t->cur.ctrl = NULL;
+	t->cur.mask = 0;
+	t->cur.growth_left = 0;
+	t->old = t->cur;
+	t->migrate_pos = 0;
+	t->migrate_step = 0;
+	t->count = 0;
+}
+
+static void ihash_destroy(struct ihash *const t/*!=NULL*/)
+{
+	IHASH_FREE(t->cur.slots);
+	IHASH_FREE(t->old.slots);
+	ihash_init(t);
+}
+
+A_Force_inline_function
+static size_t ihash_count(const struct ihash *const t/*!=NULL*/)
+{
+	return t->count;
+}
+
+/* move a few elements from the old table to the current one, free the old table when it becomes empty */
+static void ihash_migrate_(struct ihash *const t/*!=NULL*/)
+{
+	const size_t cap = t->old.mask + 1;
+	size_t i = t->migrate_pos;
+	const size_t end = cap - i > t->migrate_step ? i + t->migrate_step : cap;
+	for (; i < end; i++) {
+		if (!(t->old.ctrl[i] & 0x80)) {
+			ihash_tab_insert_(&t->cur, t->old.slots[i]);
+			t->old.ctrl[i] = (unsigned char)IHASH_DELETED_; /* do not break probe sequences of the rest elements */
+		}
+	}
+	t->migrate_pos = end;
+	if (end == cap) {
+		IHASH_FREE(t->old.slots);
+		t->old.slots = NULL;
+		t->old.ctrl = NULL;
+	}
+}
+
+/* allocate new table - at least twice the number of elements, start moving elements to it */
+A_Non_inline_function
+static int ihash_grow_(struct ihash *const t/*!=NULL*/)
+{
+	struct ihash_tab_ nt;
+	size_t capacity = IHASH_GROUP_;
+	int err;
+	/* previous migration must be completed, see below */
+	ASSERT(!t->old.slots);
+	while (capacity - capacity/8 <= 2*t->count) {
+		if (capacity > ((size_t)-1)/4)
+			return ENOMEM;
+		capacity *= 2;
+	}
+	err = ihash_tab_alloc_(&nt, capacity);
+	if (err)
+		return err;
+	if (t->cur.slots) {
+		/* move all elements before half of free slots of the new table is used:
+		  at most old_capacity/migrate_step insertions are needed */
+		const size_t insertions = (nt.growth_left - t->count)/2 + 1;
+		t->old = t->cur;
+		t->migrate_pos = 0;
+		t->migrate_step = (t->old.mask + 1)/insertions + 1;
+		if (t->migrate_step < IHASH_MIGRATE_MIN)
+			t->migrate_step = IHASH_MIGRATE_MIN;
+	}
+	t->cur = nt;
+	return 0;
+}
+
+/* find element by key, hash - hash of the key, eq - compares the key with an element with the same hash */
+A_Force_inline_function
+static struct ihash_node *ihash_find(
+	const struct ihash *const t/*!=NULL*/,
+	const size_t hash,
+	const void *const key,
+	ihash_eq_t *const eq/*!=NULL*/)
+{
+	struct ihash_node *n;
+	if (!t->count)
+		return NULL;
+	n = ihash_tab_find_(&t->cur, hash, key, eq);
+	if (!n && t->old.slots)
+		n = ihash_tab_find_(&t->old, hash, key, eq);
+	return n;
+}
+
+/* insert element, hash - hash of element key, element must not be already inserted,
+  elements with equal keys may be inserted - then ihash_find() returns any of them,
+  returns 0 or ENOMEM if failed to grow the table */
+static int ihash_insert(
+	struct ihash *const t/*!=NULL*/,
+	struct ihash_node *const n/*!=NULL,out*/,
+	const size_t hash)
+{
+	if (!t->cur.growth_left) {
+		const int err = ihash_grow_(t);
+		if (err)
+			return err;
+	}
+	n->hash = hash;
+	ihash_tab_insert_(&t->cur, n);
+	t->count++;
+	if (t->old.slots)
+		ihash_migrate_(t);
+	return 0;
+}
+
+/* remove inserted element, the element is found by its hook - keys are not compared */
+static void ihash_remove(
+	struct ihash *const t/*!=NULL*/,
+	struct ihash_node *const n/*!=NULL,inserted*/)
+{
+	ASSERT(t->count);
+	if (!ihash_tab_remove_(&t->cur, n)) {
+		const int found = t->old.slots && ihash_tab_remove_(&t->old, n);
+		ASSERT(found); /* element is not in the table */
+		(void)found;
+	}
+	t->count--;
+}
+
+/* get next element, *pos - iteration position, must be 0 initially, returns NULL at the end */
+static struct ihash_node *ihash_next(
+	const struct ihash *const t/*!=NULL*/,
+	size_t *const pos/*!=NULL,in/out*/)
+{
+	size_t i = *pos;
+	const size_t ocap = t->old.slots ? t->old.mask + 1 : 0;
+	const size_t cap = t->cur.slots ? t->cur.mask + 1 : 0;
+	for (; i < ocap; i++) {
+		if (!(t->old.ctrl[i] & 0x80)) {
+			*pos = i + 1;
+			return t->old.slots[i];
+		}
+	}
+	for (; i < ocap + cap; i++) {
+		if (!(t->cur.ctrl[i - ocap] & 0x80)) {
+			*pos = i + 1;
+			return t->cur.slots[i - ocap];
+		}
+	}
+	*pos = i;
+	return NULL;
+}
+
+/* mix bits of a hash value (finalizer of MurmurHash3) */
+A_Const_function
+A_Force_inline_function
+static size_t ihash_mix(size_t x)
+{
+#if defined _WIN64 || (defined __SIZEOF_SIZE_T__ && __SIZEOF_SIZE_T__ == 8) || \
+  (!defined _WIN32 && !defined __SIZEOF_SIZE_T__ && (defined __LP64__ || defined _LP64))
+	unsigned long long y = x;
+	y ^= y >> 33;
+	y *= 0xff51afd7ed558ccdull;
+	y ^= y >> 33;
+	y *= 0xc4ceb9fe1a85ec53ull;
+	y ^= y >> 33;
+	return (size_t)y;
+#else
+	x ^= x >> 16;
+	x *= 0x85ebca6bu;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35u;
+	x ^= x >> 16;
+	return x;
+#endif
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int ihash_destroy_unused_[sizeof(&ihash_destroy)];
+typedef int ihash_insert_unused_[sizeof(&ihash_insert)];
+typedef int ihash_remove_unused_[sizeof(&ihash_remove)];
+typedef int ihash_next_unused_[sizeof(&ihash_next)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* IHASH_H_INCLUDED */
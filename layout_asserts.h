@@ -0,0 +1,136 @@
+#ifndef LAYOUT_ASSERTS_H_INCLUDED
+#define LAYOUT_ASSERTS_H_INCLUDED
+
+/**********************************************************************************
+* Compile-time assertions of structures layout
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* layout_asserts.h */
+
+/* defines:
+  CACHE_LINE_SIZE                                    - assumed size of CPU cache line, in bytes,
+  STATIC_ASSERT_SIZE_LE(type, size)                  - sizeof(type) must not exceed 'size' bytes,
+  STATIC_ASSERT_SAME_CACHE_LINE(type, m1, m2)        - members m1 and m2 of type must fit in one cache line,
+  STATIC_ASSERT_DIFFERENT_CACHE_LINES(type, m1, m2)  - members m1 and m2 of type must not share a cache line,
+  STATIC_ASSERT_NO_PADDING(type, m1, m2, ...)        - type must consist only of listed members, without padding.
+
+  Note: all these assertions are implemented via STATIC_ASSERT(), so they cannot be placed inside expressions.
+*/
+
+#include <stddef.h> /* for offsetof() */
+#include "static_asserts.h"
+#include "countof.h" /* for MEMBER_SIZE() */
+
+/* size of CPU cache line, may be predefined */
+#ifndef CACHE_LINE_SIZE
+#if (defined __APPLE__ && (defined __aarch64__ || defined __arm64__)) || \
+  defined __powerpc64__ || defined __ppc64__
+#define CACHE_LINE_SIZE 128
+#elif defined __s390__ || defined __s390x__
+#define CACHE_LINE_SIZE 256
+#else
+#define CACHE_LINE_SIZE 64
+#endif
+#endif
+
+/* offset of first/last byte of a structure member */
+#define LAYOUT_FIRST_BYTE_(type, m) offsetof(type, m)
+#define LAYOUT_LAST_BYTE_(type, m)  (offsetof(type, m) + MEMBER_SIZE(type, m) - 1)
+
+/* index of cache line of first/last byte of a structure member,
+  assuming the structure begins at cache line boundary */
+#define LAYOUT_FIRST_LINE_(type, m) (LAYOUT_FIRST_BYTE_(type, m)/CACHE_LINE_SIZE)
+#define LAYOUT_LAST_LINE_(type, m)  (LAYOUT_LAST_BYTE_(type, m)/CACHE_LINE_SIZE)
+
+/* size of the structure must not exceed given size, for example:
+
+  struct S {int a; int b;};
+  STATIC_ASSERT_SIZE_LE(struct S, CACHE_LINE_SIZE);
+*/
+#define STATIC_ASSERT_SIZE_LE(type, size) \
+	STATIC_ASSERT1(sizeof(type) <= (size), size_le)
+
+/* two members of the structure must be located in the same cache line (e.g. fields read together on a hot path),
+  the structure itself is assumed to be aligned on the cache line boundary, for example:
+
+  struct S {int a; char pad[60]; int b;};
+  STATIC_ASSERT_SAME_CACHE_LINE(struct S, a, b);  - error: 'a' is in the 1st line while 'b' - in the 2nd one
+*/
+#define STATIC_ASSERT_SAME_CACHE_LINE(type, m1, m2) \
+	STATIC_ASSERT1(                                                   \
+		LAYOUT_FIRST_LINE_(type, m1) == LAYOUT_LAST_LINE_(type, m1) && \
+		LAYOUT_FIRST_LINE_(type, m2) == LAYOUT_LAST_LINE_(type, m2) && \
+		LAYOUT_FIRST_LINE_(type, m1) == LAYOUT_FIRST_LINE_(type, m2),  \
+		same_cache_line)
+
+/* two members of the structure must not share any cache line (e.g. counters modified by different threads),
+  the structure itself is assumed to be aligned on the cache line boundary, for example:
+
+  struct S {int a; int b;};
+  STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct S, a, b);  - error: 'a' and 'b' are both in the 1st line
+*/
+#define STATIC_ASSERT_DIFFERENT_CACHE_LINES(type, m1, m2) \
+	STATIC_ASSERT1(                                                  \
+		LAYOUT_LAST_LINE_(type, m1) < LAYOUT_FIRST_LINE_(type, m2) || \
+		LAYOUT_LAST_LINE_(type, m2) < LAYOUT_FIRST_LINE_(type, m1),   \
+		different_cache_lines)
+
+/* helpers for summing up sizes of up to 32 members */
+#define LAYOUT_EXPAND_(x) x
+#define LAYOUT_MS1_(t,m)      MEMBER_SIZE(t,m)
+#define LAYOUT_MS2_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS1_(t,__VA_ARGS__))
+#define LAYOUT_MS3_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS2_(t,__VA_ARGS__))
+#define LAYOUT_MS4_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS3_(t,__VA_ARGS__))
+#define LAYOUT_MS5_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS4_(t,__VA_ARGS__))
+#define LAYOUT_MS6_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS5_(t,__VA_ARGS__))
+#define LAYOUT_MS7_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS6_(t,__VA_ARGS__))
+#define LAYOUT_MS8_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS7_(t,__VA_ARGS__))
+#define LAYOUT_MS9_(t,m,...)  MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS8_(t,__VA_ARGS__))
+#define LAYOUT_MS10_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS9_(t,__VA_ARGS__))
+#define LAYOUT_MS11_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS10_(t,__VA_ARGS__))
+#define LAYOUT_MS12_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS11_(t,__VA_ARGS__))
+#define LAYOUT_MS13_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS12_(t,__VA_ARGS__))
+#define LAYOUT_MS14_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS13_(t,__VA_ARGS__))
+#define LAYOUT_MS15_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS14_(t,__VA_ARGS__))
+#define LAYOUT_MS16_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS15_(t,__VA_ARGS__))
+#define LAYOUT_MS17_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS16_(t,__VA_ARGS__))
+#define LAYOUT_MS18_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS17_(t,__VA_ARGS__))
+#define LAYOUT_MS19_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS18_(t,__VA_ARGS__))
+#define LAYOUT_MS20_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS19_(t,__VA_ARGS__))
+#define LAYOUT_MS21_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS20_(t,__VA_ARGS__))
+#define LAYOUT_MS22_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS21_(t,__VA_ARGS__))
+#define LAYOUT_MS23_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS22_(t,__VA_ARGS__))
+#define LAYOUT_MS24_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS23_(t,__VA_ARGS__))
+#define LAYOUT_MS25_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS24_(t,__VA_ARGS__))
+#define LAYOUT_MS26_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS25_(t,__VA_ARGS__))
+#define LAYOUT_MS27_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS26_(t,__VA_ARGS__))
+#define LAYOUT_MS28_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS27_(t,__VA_ARGS__))
+#define LAYOUT_MS29_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS28_(t,__VA_ARGS__))
+#define LAYOUT_MS30_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS29_(t,__VA_ARGS__))
+#define LAYOUT_MS31_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS30_(t,__VA_ARGS__))
+#define LAYOUT_MS32_(t,m,...) MEMBER_SIZE(t,m) + LAYOUT_EXPAND_(LAYOUT_MS31_(t,__VA_ARGS__))
+
+/* get number of arguments, works for maximum 32 arguments */
+#define LAYOUT_NARGS2_(a1,a2,a3,a4,a5,a6,a7,a8,a9,b0,b1,b2,b3,b4,b5,b6,b7,b8,b9,c0,c1,c2,c3,c4,c5,c6,c7,c8,c9,d0,d1,d2,n,...) n
+#define LAYOUT_NARGS1_(args) LAYOUT_NARGS2_ args
+#define LAYOUT_NARGS_(...)   LAYOUT_NARGS1_((__VA_ARGS__,32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0))
+
+#define LAYOUT_SUM3_(t,n,args) LAYOUT_MS##n##_ args
+#define LAYOUT_SUM2_(t,n,args) LAYOUT_SUM3_(t,n,args)
+#define LAYOUT_SUM1_(t,n,args) LAYOUT_SUM2_(t,n,args)
+
+/* sum of sizes of given members of the structure */
+#define LAYOUT_MEMBERS_SIZE(type, ...) (LAYOUT_SUM1_(type,LAYOUT_NARGS_(__VA_ARGS__),(type,__VA_ARGS__)))
+
+/* the structure must contain only listed members and no padding between them or at the end,
+  works for maximum 32 members, members cannot be bit-fields, for example:
+
+  struct S {char a; int b;};
+  STATIC_ASSERT_NO_PADDING(struct S, a, b);  - error: there are 3 padding bytes after 'a'
+*/
+#define STATIC_ASSERT_NO_PADDING(type, ...) \
+	STATIC_ASSERT1(sizeof(type) == LAYOUT_MEMBERS_SIZE(type, __VA_ARGS__), no_padding)
+
+#endif /* LAYOUT_ASSERTS_H_INCLUDED */
@@ -0,0 +1,237 @@
+#ifndef MPMC_QUEUE_H_INCLUDED
+#define MPMC_QUEUE_H_INCLUDED
+
+/**********************************************************************************
+* Bounded lock-free multi-producer multi-consumer queue
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* mpmc_queue.h */
+
+/* defines:
+
+  struct mpmc_queue                     - bounded queue of pointers,
+
+  mpmc_queue_init(q, capacity)          - allocate empty queue, capacity - power of 2, >= 2,
+                                          returns 0, EINVAL or ENOMEM,
+  mpmc_queue_destroy(q)                 - free memory allocated by the queue,
+  mpmc_queue_push(q, p)                 - add pointer to the queue, returns 0 if the queue is full,
+  mpmc_queue_pop(q)                     - remove the oldest pointer, returns NULL if the queue is empty,
+  mpmc_queue_push_batch(q, ptrs, n)     - add up to n pointers, returns the number of added ones,
+  mpmc_queue_pop_batch(q, ptrs, max)    - remove up to max pointers, returns the number of removed ones.
+
+  All operations may be called by any thread, and do not block: if a producer (or a consumer) is preempted
+  after it reserved a cell, but before it filled (emptied) the cell, consumers (producers) do not access
+  cells after it - the queue looks empty (full) for them.
+*/
+
+/* usage:
+
+struct mpmc_queue jobs;
+if (mpmc_queue_init(&jobs, 1024))
+	... out of memory ...
+
+// producers
+if (!mpmc_queue_push(&jobs, job))
+	... the queue is full ...
+
+// consumers
+struct job *const job = (struct job*)mpmc_queue_pop(&jobs);
+*/
+
+/* Implementation notes:
+
+  1) the queue is a ring of cells, each cell has a sequence number: a cell with number equal to the enqueue
+    position is free for the producer, a cell with number equal to the dequeue position + 1 is filled,
+  2) a producer reserves a cell by incrementing the enqueue position, fills it, then sets its sequence
+    number to the position + 1, a consumer reserves a cell by incrementing the dequeue position, empties it,
+    then sets its sequence number to the position + capacity - the number for the next round,
+  3) a batch is reserved by one increment of the position by the number of consecutive ready cells,
+  4) enqueue and dequeue positions are in separate cache lines, so producers do not slow down consumers,
+  5) the queue stores pointers: NULL cannot be pushed. */
+
+#include <stddef.h> /* for size_t, ptrdiff_t */
+#include <stdlib.h> /* for malloc() */
+#include <errno.h>  /* for EINVAL, ENOMEM */
+#include "atomics.h"
+#include "asserts.h"
+#include "layout_asserts.h" /* for CACHE_LINE_SIZE, STATIC_ASSERT_DIFFERENT_CACHE_LINES() */
+
+#ifndef MPMC_QUEUE_MALLOC
+#define MPMC_QUEUE_MALLOC(sz) malloc(sz)
+#endif
+
+#ifndef MPMC_QUEUE_FREE
+#define MPMC_QUEUE_FREE(p) free(p)
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mpmc_cell_ {
+	size_t seq;
+	void *ptr;
+};
+
+struct mpmc_queue {
+	char pad1_[CACHE_LINE_SIZE];
+	struct mpmc_cell_ *cells;
+	size_t mask;                    /* capacity - 1 */
+	char pad2_[CACHE_LINE_SIZE];
+	size_t enq;                     /* enqueue position */
+	char pad3_[CACHE_LINE_SIZE];
+	size_t deq;                     /* dequeue position */
+	char pad4_[CACHE_LINE_SIZE];
+};
+
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct mpmc_queue, mask, enq);
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct mpmc_queue, enq, deq);
+
+/* returns 0, EINVAL if capacity is not a power of 2 or too big, ENOMEM if failed to allocate memory */
+static int mpmc_queue_init(
+	struct mpmc_queue *const q/*!=NULL,out*/,
+	const size_t capacity/*>=2,power of 2*/)
+{
+	size_t i;
+	if (capacity < 2 || (capacity & (capacity - 1)) || capacity > (size_t)-1/sizeof(struct mpmc_cell_))
+		return EINVAL;
+	q->cells = (struct mpmc_cell_*)MPMC_QUEUE_MALLOC(capacity*sizeof(struct mpmc_cell_));
+	if (!q->cells)
+		return ENOMEM;
+	q->mask = capacity - 1;
+	for (i = 0; i < capacity; i++)
+		q->cells[i].seq = i;
+	q->enq = 0;
+	q->deq = 0;
+	return 0;
+}
+
+A_Force_inline_function
+static void mpmc_queue_destroy(struct mpmc_queue *const q/*!=NULL*/)
+{
+	MPMC_QUEUE_FREE(q->cells);
+}
+
+/* compare the sequence number of the cell with the position: 0 - the cell is ready,
+  < 0 - the cell is not ready (the queue is full or empty), > 0 - the position is outdated */
+A_Force_inline_function
+static ptrdiff_t mpmc_queue_cell_state_(
+	const struct mpmc_queue *const q/*!=NULL*/,
+	const size_t pos,
+	const size_t ready/*0 or 1*/)
+{
+	const size_t seq = (size_t)ATOMIC_LOAD(&q->cells[pos & q->mask].seq, ATOMIC_ACQUIRE);
+	return (ptrdiff_t)(seq - (pos + ready));
+}
+
+/* reserve up to n consecutive ready cells,
+  returns the starting position of reserved cells and their number in *count */
+static size_t mpmc_queue_reserve_(
+	struct mpmc_queue *const q/*!=NULL*/,
+	size_t *const ppos/*!=NULL,&q->enq or &q->deq*/,
+	const size_t ready/*0 - for enqueue, 1 - for dequeue*/,
+	const size_t n/*>0*/,
+	size_t *const count/*!=NULL,out*/)
+{
+	size_t pos = (size_t)ATOMIC_LOAD(ppos, ATOMIC_RELAXED);
+	for (;;) {
+		size_t k = 1;
+		const ptrdiff_t state = mpmc_queue_cell_state_(q, pos, ready);
+		if (state > 0) {
+			/* another thread has reserved the cell */
+			pos = (size_t)ATOMIC_LOAD(ppos, ATOMIC_RELAXED);
+			continue;
+		}
+		if (state < 0) {
+			*count = 0;
+			return pos;
+		}
+		while (k < n && !mpmc_queue_cell_state_(q, pos + k, ready))
+			k++;
+		if (ATOMIC_CAS(ppos, &pos, pos + k, ATOMIC_RELAXED, ATOMIC_RELAXED)) {
+			*count = k;
+			return pos;
+		}
+	}
+}
+
+/* returns the number of added pointers, less than n if the queue is full */
+static size_t mpmc_queue_push_batch(
+	struct mpmc_queue *const q/*!=NULL*/,
+	void *const ptrs[]/*!=NULL*/,
+	const size_t n/*>0*/)
+{
+	size_t count, i;
+	const size_t pos = mpmc_queue_reserve_(q, &q->enq, 0, n, &count);
+	for (i = 0; i < count; i++) {
+		struct mpmc_cell_ *const c = &q->cells[(pos + i) & q->mask];
+		ASSERT(ptrs[i]);
+		c->ptr = ptrs[i];
+		ATOMIC_STORE(&c->seq, pos + i + 1, ATOMIC_RELEASE);
+	}
+	return count;
+}
+
+/* returns the number of removed pointers, less than max if the queue is empty */
+static size_t mpmc_queue_pop_batch(
+	struct mpmc_queue *const q/*!=NULL*/,
+	void *ptrs[]/*!=NULL,out*/,
+	const size_t max/*>0*/)
+{
+	size_t count, i;
+	const size_t pos = mpmc_queue_reserve_(q, &q->deq, 1, max, &count);
+	for (i = 0; i < count; i++) {
+		struct mpmc_cell_ *const c = &q->cells[(pos + i) & q->mask];
+		ptrs[i] = c->ptr;
+		ATOMIC_STORE(&c->seq, pos + i + q->mask + 1, ATOMIC_RELEASE);
+	}
+	return count;
+}
+
+/* returns 0 if the queue is full */
+A_Force_inline_function
+static int mpmc_queue_push(
+	struct mpmc_queue *const q/*!=NULL*/,
+	void *const p/*!=NULL*/)
+{
+	return (int)mpmc_queue_push_batch(q, &p, 1);
+}
+
+/* returns NULL if the queue is empty */
+A_Force_inline_function
+static void *mpmc_queue_pop(struct mpmc_queue *const q/*!=NULL*/)
+{
+	void *p;
+	return mpmc_queue_pop_batch(q, &p, 1) ? p : (void*)0;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int mpmc_queue_init_unused_[sizeof(&mpmc_queue_init)];
+typedef int mpmc_queue_push_batch_unused_[sizeof(&mpmc_queue_push_batch)];
+typedef int mpmc_queue_pop_batch_unused_[sizeof(&mpmc_queue_pop_batch)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* MPMC_QUEUE_H_INCLUDED */
@@ -0,0 +1,190 @@
+#ifndef MPSC_QUEUE_H_INCLUDED
+#define MPSC_QUEUE_H_INCLUDED
+
+/**********************************************************************************
+* Intrusive lock-free multi-producer single-consumer queue
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* mpsc_queue.h */
+
+/* defines:
+
+  struct mpsc_node                      - queue link, embedded in a message,
+  struct mpsc_queue                     - the queue,
+
+  mpsc_queue_init(q)                    - initialize empty queue,
+  mpsc_queue_push(q, n)                 - add message to the queue, by any thread, wait-free,
+  mpsc_queue_push_batch(q, first, last) - add a chain of messages linked via 'next' of their nodes,
+  mpsc_queue_pop(q)                     - remove the oldest message, by the consumer thread,
+                                          returns NULL if the queue is empty or a push is in progress,
+  mpsc_queue_pop_batch(q, nodes, max)   - remove up to max messages, returns their number,
+  mpsc_queue_is_empty(q)                - check if the queue has no messages, by the consumer thread,
+
+  MPSC_ENTRY(n, type, member)           - get message containing the node, CONTAINER_OF() (see "ccasts.h"),
+  MPSC_OPT_ENTRY(n, type, member)       - same as MPSC_ENTRY(), but returns NULL if n is NULL.
+*/
+
+/* usage:
+
+struct msg {
+	struct mpsc_node node;
+	...
+};
+
+struct mpsc_queue inbox;
+mpsc_queue_init(&inbox);
+
+// any thread
+mpsc_queue_push(&inbox, &m->node);
+
+// the consumer thread
+struct msg *const m = MPSC_OPT_ENTRY(mpsc_queue_pop(&inbox), struct msg, node);
+*/
+
+/* Implementation notes:
+
+  1) the queue is a singly-linked list from the tail (the oldest message) to the head (the newest one),
+    a producer atomically exchanges the head with its node, then links the previous head to the node -
+    one atomic instruction per push, producers never wait for each other,
+  2) between the exchange and the linking, the list is broken: the consumer cannot see the nodes pushed
+    after the previous head until the producer links it, so pop may return NULL for a non-empty queue -
+    the consumer should retry later (e.g. after it is notified by the producer),
+  3) the queue contains the stub node, so the list is never empty: the last message is popped only after
+    the stub is pushed after it,
+  4) the head, modified by producers, and the tail, modified by the consumer, are in different cache lines. */
+
+#include "atomics.h"
+#include "ccasts.h"         /* for CONTAINER_OF(), ASSERT() */
+#include "layout_asserts.h" /* for CACHE_LINE_SIZE, STATIC_ASSERT_DIFFERENT_CACHE_LINES() */
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mpsc_node {
+	struct mpsc_node *next;
+};
+
+struct mpsc_queue {
+	struct mpsc_node *head;         /* the newest node, modified by producers */
+	char pad_[CACHE_LINE_SIZE];
+	struct mpsc_node *tail;         /* the oldest node, modified by the consumer */
+	struct mpsc_node stub;
+};
+
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct mpsc_queue, head, tail);
+
+/* get message containing the node, n - pointer to const node requires const type */
+#define MPSC_ENTRY(n, type, member)      CONTAINER_OF(n, type, member)
+#define MPSC_OPT_ENTRY(n, type, member)  OPT_CONTAINER_OF(n, type, member)
+
+A_Force_inline_function
+static void mpsc_queue_init(struct mpsc_queue *const q/*!=NULL,out*/)
+{
+	q->stub.next = (struct mpsc_node*)0;
+	q->head = &q->stub;
+	q->tail = &q->stub;
+}
+
+/* add a chain of nodes: first->next->...->last, last->next is ignored */
+A_Force_inline_function
+static void mpsc_queue_push_batch(
+	struct mpsc_queue *const q/*!=NULL*/,
+	struct mpsc_node *const first/*!=NULL*/,
+	struct mpsc_node *const last/*!=NULL*/)
+{
+	struct mpsc_node *prev;
+	last->next = (struct mpsc_node*)0;
+	prev = ATOMIC_EXCHANGE_PTR(&q->head, last, ATOMIC_ACQ_REL);
+	ATOMIC_STORE_PTR(&prev->next, first, ATOMIC_RELEASE);
+}
+
+A_Force_inline_function
+static void mpsc_queue_push(
+	struct mpsc_queue *const q/*!=NULL*/,
+	struct mpsc_node *const n/*!=NULL,out*/)
+{
+	mpsc_queue_push_batch(q, n, n);
+}
+
+/* returns NULL if the queue is empty or a producer has not linked the pushed node yet */
+static struct mpsc_node *mpsc_queue_pop(struct mpsc_queue *const q/*!=NULL*/)
+{
+	struct mpsc_node *tail = q->tail;
+	struct mpsc_node *next = ATOMIC_LOAD_PTR(&tail->next, ATOMIC_ACQUIRE);
+	if (tail == &q->stub) {
+		/* skip the stub */
+		if (!next)
+			return next;
+		q->tail = next;
+		tail = next;
+		next = ATOMIC_LOAD_PTR(&next->next, ATOMIC_ACQUIRE);
+	}
+	if (next) {
+		q->tail = next;
+		return tail;
+	}
+	if (tail != ATOMIC_LOAD_PTR(&q->head, ATOMIC_ACQUIRE))
+		return (struct mpsc_node*)0; /* a push is in progress */
+	/* tail is the last node: push the stub after it, then it may be popped */
+	mpsc_queue_push(q, &q->stub);
+	next = ATOMIC_LOAD_PTR(&tail->next, ATOMIC_ACQUIRE);
+	if (next) {
+		q->tail = next;
+		return tail;
+	}
+	return next; /* another push is in progress */
+}
+
+/* returns the number of popped nodes stored to the array */
+static unsigned mpsc_queue_pop_batch(
+	struct mpsc_queue *const q/*!=NULL*/,
+	struct mpsc_node *nodes[]/*!=NULL,out*/,
+	const unsigned max)
+{
+	unsigned n = 0;
+	for (; n < max; n++) {
+		nodes[n] = mpsc_queue_pop(q);
+		if (!nodes[n])
+			break;
+	}
+	return n;
+}
+
+/* returns non-zero if the queue is empty, must be called by the consumer */
+A_Force_inline_function
+static int mpsc_queue_is_empty(const struct mpsc_queue *const q/*!=NULL*/)
+{
+	return q->tail == &q->stub && !ATOMIC_LOAD_PTR(&q->stub.next, ATOMIC_ACQUIRE) &&
+		&q->stub == ATOMIC_LOAD_PTR(&q->head, ATOMIC_ACQUIRE);
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int mpsc_queue_pop_unused_[sizeof(&mpsc_queue_pop)];
+typedef int mpsc_queue_pop_batch_unused_[sizeof(&mpsc_queue_pop_batch)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* MPSC_QUEUE_H_INCLUDED */
@@ -0,0 +1,278 @@
+#ifndef PHEAP_H_INCLUDED
+#define PHEAP_H_INCLUDED
+
+/**********************************************************************************
+* Intrusive pairing heap
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* pheap.h */
+
+/* defines:
+
+  struct pheap_node                     - heap node, embedded in an element,
+  struct pheap                          - the heap: pointer to the root node and the comparison function,
+
+  pheap_init(h, less)                   - initialize empty heap, less - compares priorities of two elements,
+  pheap_is_empty(h)                     - check if heap has no elements,
+  pheap_top(h)                          - element with the highest priority (the least one) or NULL, O(1),
+  pheap_insert(h, n)                    - insert element, O(1),
+  pheap_pop(h)                          - remove and return the top element, O(log(N)) amortized,
+  pheap_remove(h, n)                    - remove any element, O(log(N)) amortized,
+  pheap_decrease(h, n)                  - restore the heap after the priority of an element was increased
+                                          (the key was decreased), O(1),
+  pheap_update(h, n)                    - restore the heap after the priority of an element was changed arbitrarily,
+                                          O(log(N)) amortized,
+
+  PHEAP_ENTRY(n, type, member)          - get element containing the node, CONTAINER_OF() (see "ccasts.h"),
+  PHEAP_OPT_ENTRY(n, type, member)      - same as PHEAP_ENTRY(), but returns NULL if n is NULL.
+
+  The heap does not allocate memory: an element is found by its embedded node, so changing the priority
+  of an element needs no lookup.
+*/
+
+/* usage:
+
+struct request {
+	unsigned long long deadline;
+	struct pheap_node node;
+};
+
+static int request_less(const struct pheap_node *const a, const struct pheap_node *const b)
+{
+	return PHEAP_ENTRY(a, const struct request, node)->deadline <
+		PHEAP_ENTRY(b, const struct request, node)->deadline;
+}
+
+struct pheap queue;
+pheap_init(&queue, request_less);
+
+// schedule a request
+pheap_insert(&queue, &r->node);
+
+// make the deadline earlier
+r->deadline = new_deadline;
+pheap_decrease(&queue, &r->node);
+
+// get the most urgent request
+struct request *const next = PHEAP_OPT_ENTRY(pheap_pop(&queue), struct request, node);
+*/
+
+/* Implementation notes:
+
+  1) the heap is a tree in which a node has a list of children: the node points to its first child,
+    children are linked by 'next' and 'prev' pointers, 'prev' of the first child points to the parent,
+  2) two heaps are melded in O(1) by adding one root as the first child of the other,
+  3) after the root is removed, its children are melded in pairs from left to right,
+    then the pairs are melded from right to left (two-pass pairing),
+  4) elements with equal priorities are not ordered. */
+
+#include "ccasts.h" /* for CONTAINER_OF(), ASSERT() */
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pheap_node {
+	struct pheap_node *child;   /* first child */
+	struct pheap_node *next;    /* next sibling */
+	struct pheap_node *prev;    /* previous sibling or the parent for the first child, NULL for the root */
+};
+
+/* returns non-zero if the priority of a is higher than the priority of b (a is less than b) */
+typedef int pheap_less_t(const struct pheap_node *a, const struct pheap_node *b);
+
+struct pheap {
+	struct pheap_node *root;
+	pheap_less_t *less;
+};
+
+/* get element containing the node, n - pointer to const node requires const type */
+#define PHEAP_ENTRY(n, type, member)      CONTAINER_OF(n, type, member)
+#define PHEAP_OPT_ENTRY(n, type, member)  OPT_CONTAINER_OF(n, type, member)
+
+A_Force_inline_function
+static void pheap_init(
+	struct pheap *const h/*!=NULL,out*/,
+	pheap_less_t *const less/*!=NULL*/)
+{
+	h->root = (struct pheap_node*)0;
+	h->less = less;
+}
+
+A_Force_inline_function
+static int pheap_is_empty(const struct pheap *const h/*!=NULL*/)
+{
+	return !h->root;
+}
+
+/* note: like strchr(), returns non-const pointer for a const heap */
+A_Force_inline_function
+static struct pheap_node *pheap_top(const struct pheap *const h/*!=NULL*/)
+{
+	return h->root;
+}
+
+/* meld two trees, returns the root of the resulting tree */
+A_Force_inline_function
+static struct pheap_node *pheap_meld_(
+	const struct pheap *const h/*!=NULL*/,
+	struct pheap_node *a/*!=NULL,root*/,
+	struct pheap_node *b/*!=NULL,root*/)
+{
+	if (h->less(b, a)) {
+		struct pheap_node *const t = a;
+		a = b;
+		b = t;
+	}
+	b->prev = a;
+	b->next = a->child;
+	if (a->child)
+		a->child->prev = b;
+	a->child = b;
+	return a;
+}
+
+/* meld the list of trees via two-pass pairing, returns the root of the resulting tree */
+static struct pheap_node *pheap_merge_pairs_(
+	const struct pheap *const h/*!=NULL*/,
+	struct pheap_node *first/*NULL?*/)
+{
+	struct pheap_node *pairs = (struct pheap_node*)0; /* stack of melded pairs, linked via 'next' */
+	struct pheap_node *r;
+	if (!first)
+		return first;
+	/* first pass: meld pairs from left to right */
+	while (first) {
+		struct pheap_node *const a = first;
+		struct pheap_node *const b = a->next;
+		a->prev = (struct pheap_node*)0;
+		if (!b) {
+			a->next = pairs;
+			pairs = a;
+			break;
+		}
+		first = b->next;
+		a->next = (struct pheap_node*)0;
+		b->next = (struct pheap_node*)0;
+		b->prev = (struct pheap_node*)0;
+		r = pheap_meld_(h, a, b);
+		r->next = pairs;
+		pairs = r;
+	}
+	/* second pass: meld pairs from right to left */
+	r = pairs;
+	pairs = pairs->next;
+	r->next = (struct pheap_node*)0;
+	while (pairs) {
+		struct pheap_node *const p = pairs;
+		pairs = p->next;
+		p->next = (struct pheap_node*)0;
+		r = pheap_meld_(h, r, p);
+	}
+	return r;
+}
+
+/* cut the subtree from the tree, n - not the root */
+A_Force_inline_function
+static void pheap_cut_(struct pheap_node *const n/*!=NULL*/)
+{
+	struct pheap_node *const prev = n->prev;
+	ASSERT(prev); /* element is the root or is not in the heap */
+	if (prev->child == n)
+		prev->child = n->next;
+	else
+		prev->next = n->next;
+	if (n->next)
+		n->next->prev = prev;
+	n->next = (struct pheap_node*)0;
+	n->prev = (struct pheap_node*)0;
+}
+
+A_Force_inline_function
+static void pheap_insert(
+	struct pheap *const h/*!=NULL*/,
+	struct pheap_node *const n/*!=NULL,out*/)
+{
+	n->child = (struct pheap_node*)0;
+	n->next = (struct pheap_node*)0;
+	n->prev = (struct pheap_node*)0;
+	h->root = h->root ? pheap_meld_(h, h->root, n) : n;
+}
+
+/* remove the top element, returns NULL if the heap is empty */
+static struct pheap_node *pheap_pop(struct pheap *const h/*!=NULL*/)
+{
+	struct pheap_node *const n = h->root;
+	if (n)
+		h->root = pheap_merge_pairs_(h, n->child);
+	return n;
+}
+
+/* remove inserted element */
+static void pheap_remove(
+	struct pheap *const h/*!=NULL*/,
+	struct pheap_node *const n/*!=NULL,inserted*/)
+{
+	if (n == h->root)
+		(void)pheap_pop(h);
+	else {
+		struct pheap_node *c;
+		pheap_cut_(n);
+		c = pheap_merge_pairs_(h, n->child);
+		if (c)
+			h->root = pheap_meld_(h, h->root, c);
+	}
+}
+
+/* the priority of inserted element was increased - restore the heap */
+A_Force_inline_function
+static void pheap_decrease(
+	struct pheap *const h/*!=NULL*/,
+	struct pheap_node *const n/*!=NULL,inserted*/)
+{
+	if (n != h->root) {
+		/* the subtree of the element remains valid */
+		pheap_cut_(n);
+		h->root = pheap_meld_(h, h->root, n);
+	}
+}
+
+/* the priority of inserted element was changed - restore the heap */
+static void pheap_update(
+	struct pheap *const h/*!=NULL*/,
+	struct pheap_node *const n/*!=NULL,inserted*/)
+{
+	pheap_remove(h, n);
+	pheap_insert(h, n);
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int pheap_pop_unused_[sizeof(&pheap_pop)];
+typedef int pheap_remove_unused_[sizeof(&pheap_remove)];
+typedef int pheap_update_unused_[sizeof(&pheap_update)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* PHEAP_H_INCLUDED */
@@ -0,0 +1,560 @@
+#ifndef RBTREE_H_INCLUDED
+#define RBTREE_H_INCLUDED
+
+/**********************************************************************************
+* Intrusive red-black tree
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* rbtree.h */
+
+/* defines:
+
+  struct rbtree_node                    - tree node, embedded in an element,
+  struct rbtree                         - the tree: pointer to the root node and to the leftmost node,
+
+  rbtree_init(t)                        - initialize empty tree,
+  rbtree_init_augmented(t, update)      - initialize empty tree with augmented nodes (see below),
+  rbtree_is_empty(t)                    - check if tree has no elements,
+  rbtree_insert(t, n, key, cmp)         - insert element, elements with equal keys are placed after existing ones,
+  rbtree_insert_at(t, parent, link, n)  - insert element at the position found by the caller,
+  rbtree_remove(t, n)                   - remove element,
+  rbtree_find(t, key, cmp)              - find element by key, returns NULL if not found,
+  rbtree_lower_bound(t, key, cmp)       - find the first element not less than the key,
+  rbtree_first(t), rbtree_last(t)       - first/last element or NULL, rbtree_first() is O(1),
+  rbtree_next(n), rbtree_prev(n)        - next/previous element or NULL,
+  rbtree_parent(n)                      - parent node or NULL for the root,
+
+  RBTREE_ENTRY(n, type, member)         - get element containing the node, CONTAINER_OF() (see "ccasts.h"),
+  RBTREE_OPT_ENTRY(n, type, member)     - same as RBTREE_ENTRY(), but returns NULL if n is NULL,
+  RBTREE_FOR_EACH(n, t)                 - iterate over the tree in order of keys.
+
+  The tree does not allocate memory: insert and remove are O(log(N)) and never fail.
+*/
+
+/* usage:
+
+struct timer {
+	unsigned long long expires;
+	struct rbtree_node node;
+};
+
+static int timer_cmp(const void *const key, const struct rbtree_node *const n)
+{
+	const unsigned long long k = *(const unsigned long long*)key;
+	const unsigned long long e = RBTREE_ENTRY(n, const struct timer, node)->expires;
+	return k < e ? -1 : k > e;
+}
+
+struct rbtree timers;
+rbtree_init(&timers);
+
+// arm a timer
+rbtree_insert(&timers, &tm->node, &tm->expires, timer_cmp);
+
+// cancel a timer
+rbtree_remove(&timers, &tm->node);
+
+// get the nearest timer
+struct timer *const nearest = RBTREE_OPT_ENTRY(rbtree_first(&timers), struct timer, node);
+
+// augmented tree: each node keeps the number of nodes in its subtree (order statistics)
+struct item {
+	int key;
+	size_t size;
+	struct rbtree_node node;
+};
+
+static size_t item_size(const struct rbtree_node *const n)
+{
+	return n ? RBTREE_ENTRY(n, const struct item, node)->size : 0;
+}
+
+static void item_update(struct rbtree_node *const n)
+{
+	RBTREE_ENTRY(n, struct item, node)->size = 1 + item_size(n->left) + item_size(n->right);
+}
+
+rbtree_init_augmented(&items, item_update);
+*/
+
+/* Implementation notes:
+
+  1) the color of a node is stored in the low bit of the pointer to the parent node (see "tagged_ptr.h"),
+    so a node is three pointers,
+  2) augmented data of a node must be a function of the node and its children: the update callback
+    recomputes it for a node, assuming that the data of the children is up to date - the tree calls it
+    for the nodes whose subtree has changed, from the bottom up, after each structural change,
+  3) the tree caches the leftmost node, so the nearest timer is found in O(1). */
+
+#include "ccasts.h"     /* for CONTAINER_OF(), ASSERT() */
+#include "tagged_ptr.h" /* for PTR_ADD_TAG() */
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct rbtree_node {
+	struct rbtree_node *parent_color; /* pointer to the parent node, tagged by 1 if the node is black */
+	struct rbtree_node *left;
+	struct rbtree_node *right;
+};
+
+/* recompute augmented data of a node from the node and its children */
+typedef void rbtree_update_t(struct rbtree_node *n);
+
+struct rbtree {
+	struct rbtree_node *root;
+	struct rbtree_node *first;    /* leftmost node */
+	rbtree_update_t *update;      /* NULL if nodes are not augmented */
+};
+
+/* compare the key with the key of a node: returns <0 if the key is less, 0 if equal, >0 if greater */
+typedef int rbtree_cmp_t(const void *key, const struct rbtree_node *n);
+
+#define RBTREE_BLACK_ 1u
+
+A_Force_inline_function
+static struct rbtree_node *rbtree_parent(const struct rbtree_node *const n/*!=NULL*/)
+{
+	return PTR_CLEAR_TAGS(struct rbtree_node, n->parent_color);
+}
+
+/* NULL leaves are black */
+A_Force_inline_function
+static int rbtree_is_black_(const struct rbtree_node *const n/*NULL?*/)
+{
+	return !n || PTR_GET_TAGS(n->parent_color);
+}
+
+A_Force_inline_function
+static void rbtree_set_black_(struct rbtree_node *const n/*!=NULL*/)
+{
+	struct rbtree_node *const p = rbtree_parent(n);
+	n->parent_color = PTR_ADD_TAG(struct rbtree_node, p, RBTREE_BLACK_);
+}
+
+A_Force_inline_function
+static void rbtree_set_red_(struct rbtree_node *const n/*!=NULL*/)
+{
+	n->parent_color = rbtree_parent(n);
+}
+
+/* set parent, preserving the color */
+A_Force_inline_function
+static void rbtree_set_parent_(struct rbtree_node *const n/*!=NULL*/, struct rbtree_node *const p/*NULL?*/)
+{
+	n->parent_color = rbtree_is_black_(n) ? PTR_ADD_TAG(struct rbtree_node, p, RBTREE_BLACK_) : p;
+}
+
+A_Force_inline_function
+static void rbtree_init(struct rbtree *const t/*!=NULL,out*/)
+{
+	t->root = (struct rbtree_node*)0;
+	t->first = (struct rbtree_node*)0;
+	t->update = (rbtree_update_t*)0;
+}
+
+A_Force_inline_function
+static void rbtree_init_augmented(
+	struct rbtree *const t/*!=NULL,out*/,
+	rbtree_update_t *const update/*!=NULL*/)
+{
+	rbtree_init(t);
+	t->update = update;
+}
+
+A_Force_inline_function
+static int rbtree_is_empty(const struct rbtree *const t/*!=NULL*/)
+{
+	return !t->root;
+}
+
+/* note: like strchr(), these functions return non-const pointers for a const tree,
+  to preserve constness, cast the result to a pointer to const or use RBTREE_ENTRY() with a const type */
+
+A_Force_inline_function
+static struct rbtree_node *rbtree_first(const struct rbtree *const t/*!=NULL*/)
+{
+	return t->first;
+}
+
+A_Force_inline_function
+static struct rbtree_node *rbtree_last(const struct rbtree *const t/*!=NULL*/)
+{
+	struct rbtree_node *n = t->root;
+	if (n) {
+		while (n->right)
+			n = n->right;
+	}
+	return n;
+}
+
+static struct rbtree_node *rbtree_next(const struct rbtree_node *n/*!=NULL,inserted*/)
+{
+	struct rbtree_node *p;
+	if (n->right) {
+		p = n->right;
+		while (p->left)
+			p = p->left;
+		return p;
+	}
+	/* go up while coming from the right subtree */
+	while ((p = rbtree_parent(n)) && n == p->right)
+		n = p;
+	return p;
+}
+
+static struct rbtree_node *rbtree_prev(const struct rbtree_node *n/*!=NULL,inserted*/)
+{
+	struct rbtree_node *p;
+	if (n->left) {
+		p = n->left;
+		while (p->right)
+			p = p->right;
+		return p;
+	}
+	while ((p = rbtree_parent(n)) && n == p->left)
+		n = p;
+	return p;
+}
+
+/* replace a child of the parent (or the root) */
+A_Force_inline_function
+static void rbtree_replace_child_(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *const p/*NULL?*/,
+	const struct rbtree_node *const old/*!=NULL*/,
+	struct rbtree_node *const n/*NULL?*/)
+{
+	if (!p)
+		t->root = n;
+	else if (p->left == old)
+		p->left = n;
+	else {
+		ASSERT(p->right == old); /* tree is corrupted */
+		p->right = n;
+	}
+}
+
+/* recompute augmented data of the nodes on the path to the root */
+static void rbtree_propagate_(
+	const struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *n/*NULL?*/)
+{
+	for (; n; n = rbtree_parent(n))
+		t->update(n);
+}
+
+/* x is the root of the subtree, right child of x becomes the root */
+static void rbtree_rotate_left_(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *const x/*!=NULL*/)
+{
+	struct rbtree_node *const y = x->right;
+	struct rbtree_node *const p = rbtree_parent(x);
+	x->right = y->left;
+	if (y->left)
+		rbtree_set_parent_(y->left, x);
+	rbtree_set_parent_(y, p);
+	rbtree_replace_child_(t, p, x, y);
+	y->left = x;
+	rbtree_set_parent_(x, y);
+	if (t->update) {
+		t->update(x);
+		t->update(y);
+	}
+}
+
+static void rbtree_rotate_right_(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *const x/*!=NULL*/)
+{
+	struct rbtree_node *const y = x->left;
+	struct rbtree_node *const p = rbtree_parent(x);
+	x->left = y->right;
+	if (y->right)
+		rbtree_set_parent_(y->right, x);
+	rbtree_set_parent_(y, p);
+	rbtree_replace_child_(t, p, x, y);
+	y->right = x;
+	rbtree_set_parent_(x, y);
+	if (t->update) {
+		t->update(x);
+		t->update(y);
+	}
+}
+
+/* restore red-black properties after inserting red node n */
+static void rbtree_insert_fixup_(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *n/*!=NULL*/)
+{
+	struct rbtree_node *p;
+	while ((p = rbtree_parent(n)) && !rbtree_is_black_(p)) {
+		struct rbtree_node *const g = rbtree_parent(p); /* red node is not the root */
+		if (p == g->left) {
+			struct rbtree_node *const u = g->right;
+			if (!rbtree_is_black_(u)) {
+				rbtree_set_black_(p);
+				rbtree_set_black_(u);
+				rbtree_set_red_(g);
+				n = g;
+				continue;
+			}
+			if (n == p->right) {
+				rbtree_rotate_left_(t, p);
+				p = n;
+			}
+			rbtree_set_black_(p);
+			rbtree_set_red_(g);
+			rbtree_rotate_right_(t, g);
+		}
+		else {
+			struct rbtree_node *const u = g->left;
+			if (!rbtree_is_black_(u)) {
+				rbtree_set_black_(p);
+				rbtree_set_black_(u);
+				rbtree_set_red_(g);
+				n = g;
+				continue;
+			}
+			if (n == p->left) {
+				rbtree_rotate_right_(t, p);
+				p = n;
+			}
+			rbtree_set_black_(p);
+			rbtree_set_red_(g);
+			rbtree_rotate_left_(t, g);
+		}
+		break;
+	}
+	rbtree_set_black_(t->root);
+}
+
+/* insert element at the position found by the caller:
+  parent - NULL for an empty tree, link - &parent->left or &parent->right (or &t->root), *link must be NULL */
+static void rbtree_insert_at(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *const parent/*NULL?*/,
+	struct rbtree_node **const link/*!=NULL*/,
+	struct rbtree_node *const n/*!=NULL,out*/)
+{
+	ASSERT(!*link);
+	ASSERT(parent ? (link == &parent->left || link == &parent->right) : link == &t->root);
+	n->parent_color = parent; /* red */
+	n->left = (struct rbtree_node*)0;
+	n->right = (struct rbtree_node*)0;
+	*link = n;
+	if (!parent || (link == &parent->left && parent == t->first))
+		t->first = n;
+	if (t->update)
+		rbtree_propagate_(t, n);
+	rbtree_insert_fixup_(t, n);
+}
+
+/* insert element, key - key of the element, compared with keys of existing elements via cmp */
+static void rbtree_insert(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *const n/*!=NULL,out*/,
+	const void *const key,
+	rbtree_cmp_t *const cmp/*!=NULL*/)
+{
+	struct rbtree_node *parent = (struct rbtree_node*)0;
+	struct rbtree_node **link = &t->root;
+	while (*link) {
+		parent = *link;
+		link = cmp(key, parent) < 0 ? &parent->left : &parent->right;
+	}
+	rbtree_insert_at(t, parent, link, n);
+}
+
+/* restore red-black properties after removing a black node, n - the node that replaced it, p - its parent */
+static void rbtree_remove_fixup_(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *n/*NULL?*/,
+	struct rbtree_node *p/*NULL?*/)
+{
+	while (n != t->root && rbtree_is_black_(n)) {
+		if (n == p->left) {
+			struct rbtree_node *w = p->right; /* sibling is not NULL: its subtree has a black node */
+			if (!rbtree_is_black_(w)) {
+				rbtree_set_black_(w);
+				rbtree_set_red_(p);
+				rbtree_rotate_left_(t, p);
+				w = p->right;
+			}
+			if (rbtree_is_black_(w->left) && rbtree_is_black_(w->right)) {
+				rbtree_set_red_(w);
+				n = p;
+				p = rbtree_parent(n);
+				continue;
+			}
+			if (rbtree_is_black_(w->right)) {
+				rbtree_set_black_(w->left);
+				rbtree_set_red_(w);
+				rbtree_rotate_right_(t, w);
+				w = p->right;
+			}
+			if (rbtree_is_black_(p))
+				rbtree_set_black_(w);
+			else
+				rbtree_set_red_(w);
+			rbtree_set_black_(p);
+			rbtree_set_black_(w->right);
+			rbtree_rotate_left_(t, p);
+		}
+		else {
+			struct rbtree_node *w = p->left;
+			if (!rbtree_is_black_(w)) {
+				rbtree_set_black_(w);
+				rbtree_set_red_(p);
+				rbtree_rotate_right_(t, p);
+				w = p->left;
+			}
+			if (rbtree_is_black_(w->left) && rbtree_is_black_(w->right)) {
+				rbtree_set_red_(w);
+				n = p;
+				p = rbtree_parent(n);
+				continue;
+			}
+			if (rbtree_is_black_(w->left)) {
+				rbtree_set_black_(w->right);
+				rbtree_set_red_(w);
+				rbtree_rotate_left_(t, w);
+				w = p->left;
+			}
+			if (rbtree_is_black_(p))
+				rbtree_set_black_(w);
+			else
+				rbtree_set_red_(w);
+			rbtree_set_black_(p);
+			rbtree_set_black_(w->left);
+			rbtree_rotate_right_(t, p);
+		}
+		return;
+	}
+	if (n)
+		rbtree_set_black_(n);
+}
+
+/* remove inserted element */
+static void rbtree_remove(
+	struct rbtree *const t/*!=NULL*/,
+	struct rbtree_node *const n/*!=NULL,inserted*/)
+{
+	struct rbtree_node *child, *parent;
+	int black;
+	if (n == t->first)
+		t->first = rbtree_next(n);
+	if (!n->left || !n->right) {
+		child = n->left ? n->left : n->right;
+		parent = rbtree_parent(n);
+		black = rbtree_is_black_(n);
+		if (child)
+			rbtree_set_parent_(child, parent);
+		rbtree_replace_child_(t, parent, n, child);
+	}
+	else {
+		/* replace n with its successor - the leftmost node of the right subtree */
+		struct rbtree_node *s = n->right;
+		while (s->left)
+			s = s->left;
+		black = rbtree_is_black_(s);
+		child = s->right;
+		if (s == n->right)
+			parent = s;
+		else {
+			parent = rbtree_parent(s);
+			parent->left = child;
+			if (child)
+				rbtree_set_parent_(child, parent);
+			s->right = n->right;
+			rbtree_set_parent_(n->right, s);
+		}
+		s->left = n->left;
+		rbtree_set_parent_(n->left, s);
+		s->parent_color = n->parent_color; /* parent and color of the removed node */
+		rbtree_replace_child_(t, rbtree_parent(n), n, s);
+	}
+	/* the successor is on the path from the parent to the root */
+	if (t->update)
+		rbtree_propagate_(t, parent);
+	if (black)
+		rbtree_remove_fixup_(t, child, parent);
+}
+
+/* find an element with the key equal to given one, returns NULL if not found */
+static struct rbtree_node *rbtree_find(
+	const struct rbtree *const t/*!=NULL*/,
+	const void *const key,
+	rbtree_cmp_t *const cmp/*!=NULL*/)
+{
+	struct rbtree_node *n = t->root;
+	while (n) {
+		const int c = cmp(key, n);
+		if (!c)
+			return n;
+		n = c < 0 ? n->left : n->right;
+	}
+	return n;
+}
+
+/* find the first element with the key not less than given one, returns NULL if not found */
+static struct rbtree_node *rbtree_lower_bound(
+	const struct rbtree *const t/*!=NULL*/,
+	const void *const key,
+	rbtree_cmp_t *const cmp/*!=NULL*/)
+{
+	struct rbtree_node *n = t->root, *r = (struct rbtree_node*)0;
+	while (n) {
+		if (cmp(key, n) <= 0) {
+			r = n;
+			n = n->left;
+		}
+		else
+			n = n->right;
+	}
+	return r;
+}
+
+/* get element containing the node, n - pointer to const node requires const type */
+#define RBTREE_ENTRY(n, type, member)      CONTAINER_OF(n, type, member)
+#define RBTREE_OPT_ENTRY(n, type, member)  OPT_CONTAINER_OF(n, type, member)
+
+/* n - iterator, pointer to (const?) struct rbtree_node */
+#define RBTREE_FOR_EACH(n, t) \
+	for ((n) = rbtree_first(t); (n); (n) = rbtree_next(n))
+
+/* suppress warnings about unreferenced static functions */
+typedef int rbtree_next_unused_[sizeof(&rbtree_next)];
+typedef int rbtree_prev_unused_[sizeof(&rbtree_prev)];
+typedef int rbtree_insert_unused_[sizeof(&rbtree_insert)];
+typedef int rbtree_remove_unused_[sizeof(&rbtree_remove)];
+typedef int rbtree_find_unused_[sizeof(&rbtree_find)];
+typedef int rbtree_lower_bound_unused_[sizeof(&rbtree_lower_bound)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* RBTREE_H_INCLUDED */
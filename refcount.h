@@ -0,0 +1,306 @@
+#ifndef REFCOUNT_H_INCLUDED
+#define REFCOUNT_H_INCLUDED
+
+/**********************************************************************************
+* Intrusive reference counting, with biased counting mode
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* refcount.h */
+
+/* defines:
+
+  struct refcount                       - atomic reference counter, embedded in an object,
+
+  refcount_init(r, n)                   - initialize the counter, n - initial number of references,
+  refcount_read(r)                      - current number of references, for diagnostics,
+  refcount_get(r)                       - add a reference,
+  refcount_get_unless_zero(r)           - add a reference if the object is not being destroyed, returns 0 if it is,
+  refcount_put(r)                       - drop a reference, returns non-zero if it was the last one,
+
+  struct refcount_owner                 - per-thread state for biased reference counters,
+  struct refcount_biased                - biased reference counter, embedded in an object,
+
+  refcount_owner_init(o)                - initialize the state of the current thread,
+  refcount_owner_merge(o, release)      - process counters queued to the owner thread by other threads,
+                                          calls release() for objects without references, returns their number,
+  refcount_biased_init(r, o)            - initialize the counter with one reference of the owner thread o,
+  refcount_biased_get(r, self)          - add a reference, self - the state of the current thread,
+  refcount_biased_put(r, self)          - drop a reference, returns non-zero if it was the last one,
+
+  REFCOUNT_ENTRY(r, type, member)       - get object containing the counter, CONTAINER_OF() (see "ccasts.h").
+*/
+
+/* usage:
+
+struct session {
+	struct refcount_biased ref;
+	...
+};
+
+static THREAD_LOCAL struct refcount_owner self;
+
+static void session_free(struct refcount_biased *const r)
+{
+	free(REFCOUNT_ENTRY(r, struct session, ref));
+}
+
+// at thread start
+refcount_owner_init(&self);
+
+// create object owned by the current thread
+refcount_biased_init(&s->ref, &self);
+
+// in any thread
+refcount_biased_get(&s->ref, &self);
+...
+if (refcount_biased_put(&s->ref, &self))
+	session_free(&s->ref);
+
+// periodically, e.g. in the event loop of the owner thread
+(void)refcount_owner_merge(&self, session_free);
+*/
+
+/* Implementation notes:
+
+  1) biased counter has two parts: the count of the owner thread, modified without atomic instructions,
+    and the shared count, modified atomically by other threads, the number of references is their sum,
+  2) references may be passed between threads, so the shared count may become negative: then the thread
+    which made it negative queues the counter to the owner thread - the owner adds its count to the shared
+    one (merges the counts) in refcount_owner_merge(), and the object is released if the sum is zero,
+  3) when the count of the owner drops to zero, the owner merges the counts itself: after that, the counter
+    works as an ordinary atomic one,
+  4) the shared count is stored shifted left by 2 bits, low bits are the flags: REFCOUNT_MERGED_ - counts are
+    merged, REFCOUNT_QUEUED_ - the counter is queued to the owner, the object is not released while queued,
+  5) the owner thread must call refcount_owner_merge() regularly, else objects with negative shared counts
+    are never released, struct refcount_owner must outlive all counters it owns,
+  6) the counter is not padded to a cache line: an object popular among many threads should be owned by
+    the thread that takes most references, so other threads do not need to access it often. */
+
+#include "atomics.h"
+#include "ccasts.h" /* for CONTAINER_OF(), ASSERT() */
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct refcount {
+	long count;
+};
+
+struct refcount_owner;
+
+struct refcount_biased {
+	struct refcount_owner *owner;   /* NULL after counts are merged */
+	unsigned long biased;           /* count of the owner thread */
+	long shared;                    /* shared count << 2 | flags */
+	struct refcount_biased *next;   /* next counter in the queue of the owner */
+};
+
+struct refcount_owner {
+	struct refcount_biased *queue;  /* counters queued by other threads */
+};
+
+typedef void refcount_release_t(struct refcount_biased *r);
+
+#define REFCOUNT_MERGED_ 1
+#define REFCOUNT_QUEUED_ 2
+#define REFCOUNT_ONE_    4
+
+/* get object containing the counter, r - pointer to const counter requires const type */
+#define REFCOUNT_ENTRY(r, type, member) CONTAINER_OF(r, type, member)
+
+A_Force_inline_function
+static void refcount_init(
+	struct refcount *const r/*!=NULL,out*/,
+	const long n/*>0*/)
+{
+	r->count = n;
+}
+
+A_Force_inline_function
+static long refcount_read(const struct refcount *const r/*!=NULL*/)
+{
+	return (long)ATOMIC_LOAD(&r->count, ATOMIC_RELAXED);
+}
+
+A_Force_inline_function
+static void refcount_get(struct refcount *const r/*!=NULL*/)
+{
+	(void)ATOMIC_FETCH_ADD(&r->count, 1, ATOMIC_RELAXED);
+}
+
+/* returns 0 if the counter is zero - the object is being destroyed */
+A_Force_inline_function
+static int refcount_get_unless_zero(struct refcount *const r/*!=NULL*/)
+{
+	long c = (long)ATOMIC_LOAD(&r->count, ATOMIC_RELAXED);
+	do {
+		if (!c)
+			return 0;
+	} while (!ATOMIC_CAS(&r->count, &c, c + 1, ATOMIC_RELAXED, ATOMIC_RELAXED));
+	return 1;
+}
+
+/* returns non-zero if the last reference was dropped - the object must be destroyed */
+A_Force_inline_function
+static int refcount_put(struct refcount *const r/*!=NULL*/)
+{
+	const long c = (long)ATOMIC_FETCH_SUB(&r->count, 1, ATOMIC_RELEASE);
+	ASSERT(c > 0);
+	if (c != 1)
+		return 0;
+	/* all modifications of the object by other threads must be visible */
+	ATOMIC_FENCE(ATOMIC_ACQUIRE);
+	return 1;
+}
+
+A_Force_inline_function
+static void refcount_owner_init(struct refcount_owner *const o/*!=NULL,out*/)
+{
+	o->queue = (struct refcount_biased*)0;
+}
+
+A_Force_inline_function
+static void refcount_biased_init(
+	struct refcount_biased *const r/*!=NULL,out*/,
+	struct refcount_owner *const o/*!=NULL*/)
+{
+	r->owner = o;
+	r->biased = 1;
+	r->shared = 0;
+	r->next = (struct refcount_biased*)0;
+}
+
+/* returns non-zero if the object may be released: counts are merged, the sum is zero, the counter is not queued */
+A_Force_inline_function
+static int refcount_biased_dead_(const long shared)
+{
+	return shared == REFCOUNT_MERGED_;
+}
+
+A_Force_inline_function
+static void refcount_biased_get(
+	struct refcount_biased *const r/*!=NULL*/,
+	const struct refcount_owner *const self/*!=NULL*/)
+{
+	if (ATOMIC_LOAD_PTR(&r->owner, ATOMIC_RELAXED) == self)
+		r->biased++;
+	else
+		(void)ATOMIC_FETCH_ADD(&r->shared, REFCOUNT_ONE_, ATOMIC_RELAXED);
+}
+
+/* the count of the owner thread dropped to zero: merge counts */
+static int refcount_biased_merge_(struct refcount_biased *const r/*!=NULL*/)
+{
+	long s;
+	ATOMIC_STORE_PTR(&r->owner, (struct refcount_owner*)0, ATOMIC_RELAXED);
+	s = (long)ATOMIC_FETCH_OR(&r->shared, REFCOUNT_MERGED_, ATOMIC_ACQ_REL) | REFCOUNT_MERGED_;
+	return refcount_biased_dead_(s);
+}
+
+/* drop a reference in a thread that is not the owner */
+static int refcount_biased_put_shared_(
+	struct refcount_biased *const r/*!=NULL*/,
+	struct refcount_owner *const o/*NULL?*/)
+{
+	long s = (long)ATOMIC_LOAD(&r->shared, ATOMIC_RELAXED);
+	long n;
+	do {
+		n = s - REFCOUNT_ONE_;
+		/* the shared count becomes negative: queue the counter to the owner thread,
+		  the flag is set atomically with the decrement, so the object cannot be released until it is merged */
+		if (n < 0 && !(n & (REFCOUNT_QUEUED_ | REFCOUNT_MERGED_)))
+			n |= REFCOUNT_QUEUED_;
+	} while (!ATOMIC_CAS(&r->shared, &s, n, ATOMIC_RELEASE, ATOMIC_RELAXED));
+	if (refcount_biased_dead_(n)) {
+		ATOMIC_FENCE(ATOMIC_ACQUIRE);
+		return 1;
+	}
+	if ((n ^ s) & REFCOUNT_QUEUED_) {
+		/* the count of the owner is positive, so it has not cleared the pointer to itself */
+		struct refcount_biased *head;
+		ASSERT(o);
+		head = ATOMIC_LOAD_PTR(&o->queue, ATOMIC_RELAXED);
+		do {
+			r->next = head;
+		} while (!ATOMIC_CAS_PTR(&o->queue, &head, r, ATOMIC_RELEASE, ATOMIC_RELAXED));
+	}
+	return 0;
+}
+
+/* returns non-zero if the last reference was dropped - the object must be destroyed */
+A_Force_inline_function
+static int refcount_biased_put(
+	struct refcount_biased *const r/*!=NULL*/,
+	const struct refcount_owner *const self/*!=NULL*/)
+{
+	struct refcount_owner *const o = ATOMIC_LOAD_PTR(&r->owner, ATOMIC_RELAXED);
+	if (o == self) {
+		ASSERT(r->biased);
+		if (--r->biased)
+			return 0;
+		return refcount_biased_merge_(r);
+	}
+	return refcount_biased_put_shared_(r, o);
+}
+
+/* merge counts of queued counters, must be called by the owner thread,
+  returns the number of released objects */
+static unsigned refcount_owner_merge(
+	struct refcount_owner *const o/*!=NULL*/,
+	refcount_release_t *const release/*!=NULL*/)
+{
+	unsigned released = 0;
+	struct refcount_biased *r;
+	if (!ATOMIC_LOAD_PTR(&o->queue, ATOMIC_RELAXED))
+		return 0;
+	r = ATOMIC_EXCHANGE_PTR(&o->queue, (struct refcount_biased*)0, ATOMIC_ACQUIRE);
+	while (r) {
+		struct refcount_biased *const next = r->next;
+		const long b = (long)r->biased*REFCOUNT_ONE_;
+		long s = (long)ATOMIC_LOAD(&r->shared, ATOMIC_RELAXED);
+		long n;
+		r->biased = 0;
+		ATOMIC_STORE_PTR(&r->owner, (struct refcount_owner*)0, ATOMIC_RELAXED);
+		do {
+			n = ((s + b) & ~REFCOUNT_QUEUED_) | REFCOUNT_MERGED_;
+		} while (!ATOMIC_CAS(&r->shared, &s, n, ATOMIC_ACQ_REL, ATOMIC_RELAXED));
+		if (refcount_biased_dead_(n)) {
+			release(r);
+			released++;
+		}
+		r = next;
+	}
+	return released;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int refcount_biased_merge_unused_[sizeof(&refcount_biased_merge_)];
+typedef int refcount_biased_put_shared_unused_[sizeof(&refcount_biased_put_shared_)];
+typedef int refcount_owner_merge_unused_[sizeof(&refcount_owner_merge)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* REFCOUNT_H_INCLUDED */
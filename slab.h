@@ -0,0 +1,323 @@
+#ifndef SLAB_H_INCLUDED
+#define SLAB_H_INCLUDED
+
+/**********************************************************************************
+* Slab allocator of fixed-size objects
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* slab.h */
+
+/* defines:
+
+  struct slab_pool                      - per-thread allocator of objects of the same size,
+
+  slab_pool_create(pp, obj_size)        - create a pool, returns 0, EINVAL or ENOMEM,
+  slab_pool_destroy(pool)               - destroy the pool, by the owner thread,
+  slab_obj_size(pool)                   - size of allocated objects (rounded up obj_size),
+  slab_alloc(pool)                      - allocate an object by the owner thread, returns NULL if out of memory,
+  slab_free(pool, obj)                  - free an object allocated from any pool,
+                                          pool - the pool of the current thread or NULL.
+
+  SLAB_SIZE                             - size and alignment of a slab, power of 2, by default 64K,
+  SLAB_ALIGNED_ALLOC(size, align)       - allocate aligned memory for slabs, by default posix_memalign(),
+  SLAB_ALIGNED_FREE(p)                  - free memory allocated by SLAB_ALIGNED_ALLOC().
+*/
+
+/* usage:
+
+static THREAD_LOCAL struct slab_pool *request_pool;
+
+// at thread start
+int err = slab_pool_create(&request_pool, sizeof(struct request));
+
+// allocate
+struct request *r = (struct request*)slab_alloc(request_pool);
+
+// free, maybe in another thread
+slab_free(request_pool, r);
+
+// at thread exit, objects still in use by other threads remain valid
+slab_pool_destroy(request_pool);
+*/
+
+/* Implementation notes:
+
+  1) a slab is a block of SLAB_SIZE bytes aligned on SLAB_SIZE boundary, the header of the slab points
+    to the owner pool - the slab of an object is found by clearing low bits of the object address,
+  2) free objects are linked in a LIFO free list through their first bytes - allocation is a pointer pop
+    and the most recently freed (cache-warm) object is reused first,
+  3) new slabs are carved lazily: objects are taken from the end of the newest slab only when the
+    free list is empty,
+  4) the free list of the pool is the magazine of the owner thread and is accessed without atomics,
+  5) objects freed by other threads are pushed to the lock-free 'remote' list of the owner pool,
+    the owner takes the whole list with one exchange when its free list is empty - such a stack
+    is not subject to the ABA problem: only the owner pops, and it pops everything at once,
+  6) a destroyed pool with objects still in use is marked "abandoned" by the tagged pointer
+    PTR_MAKE_TAGGED(struct slab_free_, 0, 1) (see "tagged_ptr.h") stored in its 'remote' list head:
+    other threads then only count freed objects, the memory of the pool is released when the last object
+    is freed,
+  7) slabs are not returned to the system until the pool is destroyed. */
+
+#include <stdlib.h> /* for posix_memalign(), free() */
+#include <errno.h>  /* for EINVAL, ENOMEM */
+#ifdef _WIN32
+#include <malloc.h> /* for _aligned_malloc() */
+#endif
+#include "atomics.h"
+#include "tagged_ptr.h"
+#include "layout_asserts.h" /* for CACHE_LINE_SIZE, STATIC_ASSERT_DIFFERENT_CACHE_LINES() */
+#include "asserts.h"
+
+#ifndef SLAB_SIZE
+#define SLAB_SIZE 65536
+#endif
+
+#ifndef SLAB_ALIGNED_ALLOC
+#ifdef _WIN32
+#define SLAB_ALIGNED_ALLOC(size, align) _aligned_malloc(size, align)
+#define SLAB_ALIGNED_FREE(p) _aligned_free(p)
+#else
+#define SLAB_ALIGNED_ALLOC(size, align) slab_posix_memalign_(size, align)
+#define SLAB_ALIGNED_FREE(p) free(p)
+#define SLAB_POSIX_MEMALIGN_
+#endif
+#endif
+
+/* objects are aligned as by malloc() */
+#define SLAB_OBJ_ALIGN_ (2*sizeof(void*))
+
+/* objects start after the slab header */
+#define SLAB_HDR_SIZE_ CACHE_LINE_SIZE
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+STATIC_ASSERT1(!(SLAB_SIZE & (SLAB_SIZE - 1)), slab_size_pow2);
+STATIC_ASSERT1(SLAB_SIZE >= 4096, slab_size_min);
+
+/* free object */
+struct slab_free_ {
+	struct slab_free_ *next;
+};
+
+/* header at the beginning of a slab */
+struct slab_hdr_ {
+	struct slab_pool *pool;     /* owner pool */
+	struct slab_hdr_ *next;     /* next slab of the pool */
+};
+
+struct slab_pool {
+	/* accessed only by the owner thread */
+	struct slab_free_ *free;    /* free objects */
+	char *bump;                 /* not yet carved objects of the newest slab */
+	char *bump_end;
+	struct slab_hdr_ *slabs;    /* all slabs of the pool */
+	size_t obj_size;
+	size_t in_use;              /* number of allocated objects, some may be in the 'remote' list */
+	char pad_[CACHE_LINE_SIZE];
+	/* accessed by other threads */
+	struct slab_free_ *remote;  /* objects freed by other threads */
+	size_t abandoned_left;      /* objects not yet freed after the pool was destroyed */
+};
+
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct slab_pool, in_use, remote);
+
+#define SLAB_ABANDONED_ PTR_MAKE_TAGGED(struct slab_free_, 0, 1)
+
+#ifdef SLAB_POSIX_MEMALIGN_
+static void *slab_posix_memalign_(const size_t size, const size_t align)
+{
+	void *p;
+	return posix_memalign(&p, align, size) ? (void*)0 : p;
+}
+#endif
+
+A_Force_inline_function
+static size_t slab_obj_size(const struct slab_pool *const pool/*!=NULL*/)
+{
+	return pool->obj_size;
+}
+
+A_Force_inline_function
+static struct slab_hdr_ *slab_of_(void *const obj/*!=NULL*/)
+{
+	return (struct slab_hdr_*)ptr_clear_tags_(obj, SLAB_SIZE);
+}
+
+/* returns 0, EINVAL if obj_size is 0 or too big, or ENOMEM */
+static int slab_pool_create(
+	struct slab_pool **const pp/*!=NULL,out*/,
+	size_t obj_size/*>0*/)
+{
+	struct slab_pool *pool;
+	if (!obj_size || obj_size > SLAB_SIZE - SLAB_HDR_SIZE_)
+		return EINVAL;
+	obj_size = (obj_size + SLAB_OBJ_ALIGN_ - 1) & ~(SLAB_OBJ_ALIGN_ - 1);
+	pool = (struct slab_pool*)SLAB_ALIGNED_ALLOC(sizeof(*pool), CACHE_LINE_SIZE);
+	if (!pool)
+		return ENOMEM;
+	pool->free = (struct slab_free_*)0;
+	pool->bump = (char*)0;
+	pool->bump_end = (char*)0;
+	pool->slabs = (struct slab_hdr_*)0;
+	pool->obj_size = obj_size;
+	pool->in_use = 0;
+	pool->remote = (struct slab_free_*)0;
+	pool->abandoned_left = 0;
+	*pp = pool;
+	return 0;
+}
+
+static void slab_pool_release_(struct slab_pool *const pool/*!=NULL*/)
+{
+	struct slab_hdr_ *s = pool->slabs;
+	while (s) {
+		struct slab_hdr_ *const next = s->next;
+		SLAB_ALIGNED_FREE(s);
+		s = next;
+	}
+	SLAB_ALIGNED_FREE(pool);
+}
+
+/* count objects in the list taken from the 'remote' list and append them to the free list */
+static void slab_take_remote_(
+	struct slab_pool *const pool/*!=NULL*/,
+	struct slab_free_ *const list/*!=NULL*/)
+{
+	struct slab_free_ *tail = list;
+	size_t count = 1;
+	for (; tail->next; tail = tail->next)
+		count++;
+	tail->next = pool->free;
+	pool->free = list;
+	ASSERT(pool->in_use >= count);
+	pool->in_use -= count;
+}
+
+static void slab_pool_destroy(struct slab_pool *const pool/*!=NULL*/)
+{
+	struct slab_free_ *const list = (struct slab_free_*)ATOMIC_EXCHANGE_PTR(
+		&pool->remote, SLAB_ABANDONED_, ATOMIC_ACQ_REL);
+	if (list)
+		slab_take_remote_(pool, list);
+	if (pool->in_use) {
+		/* the pool is released by the thread which frees the last object */
+		const size_t left = pool->in_use;
+		if ((size_t)ATOMIC_FETCH_ADD(&pool->abandoned_left, left, ATOMIC_ACQ_REL) + left)
+			return;
+	}
+	slab_pool_release_(pool);
+}
+
+static void *slab_alloc_slow_(struct slab_pool *const pool/*!=NULL*/)
+{
+	char *obj;
+	if (ATOMIC_LOAD_PTR(&pool->remote, ATOMIC_RELAXED)) {
+		struct slab_free_ *const list = (struct slab_free_*)ATOMIC_EXCHANGE_PTR(
+			&pool->remote, (struct slab_free_*)0, ATOMIC_ACQUIRE);
+		struct slab_free_ *f;
+		slab_take_remote_(pool, list);
+		f = pool->free;
+		pool->free = f->next;
+		pool->in_use++;
+		return f;
+	}
+	if (pool->bump == pool->bump_end) {
+		struct slab_hdr_ *const s = (struct slab_hdr_*)SLAB_ALIGNED_ALLOC(SLAB_SIZE, SLAB_SIZE);
+		if (!s)
+			return (void*)0;
+		s->pool = pool;
+		s->next = pool->slabs;
+		pool->slabs = s;
+		pool->bump = (char*)s + SLAB_HDR_SIZE_;
+		pool->bump_end = pool->bump + (SLAB_SIZE - SLAB_HDR_SIZE_)/pool->obj_size*pool->obj_size;
+	}
+	obj = pool->bump;
+	pool->bump = obj + pool->obj_size;
+	pool->in_use++;
+	return obj;
+}
+
+/* allocate an object, must be called by the owner thread of the pool,
+  returns NULL if out of memory */
+A_Force_inline_function
+static void *slab_alloc(struct slab_pool *const pool/*!=NULL*/)
+{
+	struct slab_free_ *const f = pool->free;
+	if (f) {
+		pool->free = f->next;
+		pool->in_use++;
+		return f;
+	}
+	return slab_alloc_slow_(pool);
+}
+
+/* free an object in a thread that does not own its pool */
+static void slab_free_remote_(
+	struct slab_pool *const owner/*!=NULL*/,
+	void *const obj/*!=NULL*/)
+{
+	struct slab_free_ *const f = (struct slab_free_*)obj;
+	struct slab_free_ *head = (struct slab_free_*)ATOMIC_LOAD_PTR(&owner->remote, ATOMIC_RELAXED);
+	do {
+		if (PTR_GET_TAGS(head)) {
+			/* the owner pool was destroyed */
+			if (1 == (size_t)ATOMIC_FETCH_SUB(&owner->abandoned_left, 1, ATOMIC_ACQ_REL))
+				slab_pool_release_(owner);
+			return;
+		}
+		f->next = head;
+	} while (!ATOMIC_CAS_PTR(&owner->remote, &head, f, ATOMIC_RELEASE, ATOMIC_RELAXED));
+}
+
+/* free an object allocated from any pool,
+  pool - the pool of the current thread or NULL if the thread has no pool */
+A_Force_inline_function
+static void slab_free(
+	struct slab_pool *const pool/*NULL?*/,
+	void *const obj/*!=NULL*/)
+{
+	struct slab_pool *const owner = slab_of_(obj)->pool;
+	if (owner == pool) {
+		struct slab_free_ *const f = (struct slab_free_*)obj;
+		ASSERT(pool->in_use);
+		f->next = pool->free;
+		pool->free = f;
+		pool->in_use--;
+	}
+	else
+		slab_free_remote_(owner, obj);
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int slab_pool_create_unused_[sizeof(&slab_pool_create)];
+typedef int slab_pool_destroy_unused_[sizeof(&slab_pool_destroy)];
+typedef int slab_alloc_slow_unused_[sizeof(&slab_alloc_slow_)];
+typedef int slab_free_remote_unused_[sizeof(&slab_free_remote_)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* SLAB_H_INCLUDED */
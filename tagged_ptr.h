@@ -16,6 +16,7 @@
   PTR_MAKE_TAGGED(type, value, tag)
 */
 
+#include <stddef.h> /* for size_t */
 #include "static_asserts.h"
 #include "annotations.h"
 
@@ -23,8 +24,8 @@
   if pointer type is signed, it may be sign-extended during conversion to unsigned long long integer
   - these extra bits should be masked out before converting unsigned long long integer back to a pointer */
 #define PTR_VALUE_MASK \
-	(/* byte has 8 bits */EMBED_ASSERT(255 == (unsigned char)-1) + \
-	/*ull is large enough*/EMBED_ASSERT(sizeof(unsigned long long) >= sizeof(void*)) + \
+	(/* byte has 8 bits */EMBED_ASSERT1(255 == (unsigned char)-1, byte_bits) + \
+	/*ull is large enough*/EMBED_ASSERT1(sizeof(unsigned long long) >= sizeof(void*), ull_size) + \
 	((1llu << (8*sizeof(void*) - 1)) | ~(~0llu << (8*sizeof(void*) - 1))))
 
 A_Const_function
@@ -88,7 +89,7 @@ static inline unsigned ptr_get_tags_(const void *const ptr/*NULL?*/, const unsig
 A_Const_function
 static inline void *ptr_make_tagged_(const unsigned value, const unsigned tag/*>=0*/)
 {
-	return (void*)(value + tag);
+	return (void*)(size_t)(value + tag);
 }
 
 #if defined __cplusplus && __cplusplus >= 201103L
@@ -102,42 +103,45 @@ static inline void *ptr_make_tagged_(const unsigned value, const unsigned tag/*>
 #define ALIGNOF_EXPR(expr) __alignof__(expr)
 #endif /* assume GCC-compatible compiler */
 
+/* note: in C, EMBED_ASSERT() defines a structure named after the source line, so the macros below
+  cannot be used more than once per source line (nor be nested) */
+
 /* add non-zero constant tag to a pointer,
   returns tagged pointer */
 /* 'type' - type of a pointed object */
 /* note: 'type' must have non-zero alignment requirement */
-#define PTR_ADD_TAG(type, ptr, tag) \
-	((type*)ptr_add_tag_(ptr, (tag) +                                                   \
-	/* type must be a type of ptr */0*sizeof((const type*)(const void*)(ptr) - (ptr)) + \
-	/* tag must be non-zero constant */EMBED_ASSERT((tag) > 0) +                        \
-	/* ALIGNOF() must be integer */EMBED_ASSERT(ALIGNOF_EXPR(*(ptr)) <= (unsigned)-1) + \
-	/* tag must be small enough */EMBED_ASSERT(ALIGNOF_EXPR(*(ptr)) > (tag))))
+#define PTR_ADD_TAG(type, ptr, tag)                                                                     \
+	((type*)ptr_add_tag_(ptr, (tag) +                                                                   \
+	/* type must be a type of ptr */0*sizeof((const type*)(const void*)(ptr) - (ptr)) +                 \
+	/* tag must be non-zero constant */EMBED_ASSERT1((tag) > 0, add_tag_nz) +                           \
+	/* ALIGNOF() must be integer */EMBED_ASSERT1(ALIGNOF_EXPR(*(ptr)) <= (unsigned)-1, add_tag_align) + \
+	/* tag must be small enough */EMBED_ASSERT1(ALIGNOF_EXPR(*(ptr)) > (tag), add_tag_small)))
 
 /* remove tags from a (tagged?) pointer,
   returns pointer without tags */
 /* 'type' - type of a pointed object */
-#define PTR_CLEAR_TAGS(type, ptr) \
-	((type*)ptr_clear_tags_(ptr, ALIGNOF_EXPR(*(ptr)) +                                 \
-	/* type must be a type of ptr */0*sizeof((const type*)(const void*)(ptr) - (ptr)) + \
-	/* ALIGNOF() must be integer */EMBED_ASSERT(ALIGNOF_EXPR(*(ptr)) <= (unsigned)-1) + \
-	/* type alignment must be non-zero */EMBED_ASSERT(ALIGNOF_EXPR(*(ptr)))))
+#define PTR_CLEAR_TAGS(type, ptr)                                                                          \
+	((type*)ptr_clear_tags_(ptr, ALIGNOF_EXPR(*(ptr)) +                                                    \
+	/* type must be a type of ptr */0*sizeof((const type*)(const void*)(ptr) - (ptr)) +                    \
+	/* ALIGNOF() must be integer */EMBED_ASSERT1(ALIGNOF_EXPR(*(ptr)) <= (unsigned)-1, clear_tags_align) + \
+	/* type alignment must be non-zero */EMBED_ASSERT1(ALIGNOF_EXPR(*(ptr)), clear_tags_nz)))
 
 /* extract tags from a pointer value,
   returns tags */
-#define PTR_GET_TAGS(ptr) \
-	ptr_get_tags_(ptr, ALIGNOF_EXPR(*(ptr)) +                                           \
-	/* ALIGNOF() must be integer */EMBED_ASSERT(ALIGNOF_EXPR(*(ptr)) <= (unsigned)-1) + \
-	/* type alignment must be non-zero */EMBED_ASSERT(ALIGNOF_EXPR(*(ptr))))
+#define PTR_GET_TAGS(ptr)                                                                                \
+	ptr_get_tags_(ptr, ALIGNOF_EXPR(*(ptr)) +                                                            \
+	/* ALIGNOF() must be integer */EMBED_ASSERT1(ALIGNOF_EXPR(*(ptr)) <= (unsigned)-1, get_tags_align) + \
+	/* type alignment must be non-zero */EMBED_ASSERT1(ALIGNOF_EXPR(*(ptr)), get_tags_nz))
 
 /* make (invalid) tagged pointer,
   such a pointer may be used as an error indicator,
   where 'value' - the error number */
-#define PTR_MAKE_TAGGED(type, value, tag) \
-	((type*)ptr_make_tagged_((value)*ALIGNOF_TYPE(type), (tag) +                      \
-	/* tag must be non-zero constant */EMBED_ASSERT((tag) > 0) +                      \
-	/* ALIGNOF() must be integer */EMBED_ASSERT(ALIGNOF_TYPE(type) <= (unsigned)-1) + \
-	/* tag must be small enough */EMBED_ASSERT(ALIGNOF_TYPE(type) > (tag)) +          \
-	/* value must be non-negative */EMBED_ASSERT((value) >= 0) +                      \
-	/* value must not be too big */EMBED_ASSERT(0 + (value) <= (unsigned)-1/ALIGNOF_TYPE(type))))
+#define PTR_MAKE_TAGGED(type, value, tag)                                                                 \
+	((type*)ptr_make_tagged_((value)*ALIGNOF_TYPE(type), (tag) +                                          \
+	/* tag must be non-zero constant */EMBED_ASSERT1((tag) > 0, make_tagged_nz) +                         \
+	/* ALIGNOF() must be integer */EMBED_ASSERT1(ALIGNOF_TYPE(type) <= (unsigned)-1, make_tagged_align) + \
+	/* tag must be small enough */EMBED_ASSERT1(ALIGNOF_TYPE(type) > (tag), make_tagged_small) +          \
+	/* value must be non-negative */EMBED_ASSERT1((value) >= 0, make_tagged_neg) +                        \
+	/* value must not be too big */EMBED_ASSERT1(0 + (value) <= (unsigned)-1/ALIGNOF_TYPE(type), make_tagged_big)))
 
 #endif /* TAGGED_PTR_H_INCLUDED */
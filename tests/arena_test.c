@@ -0,0 +1,167 @@
+/**********************************************************************************
+* Arena allocator test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* arena_test.c */
+
+/* compile with
+  gcc arena_test.c -o arena_test
+ or
+  gcc -DARENA_HUGE_PAGES arena_test.c -o arena_test
+ or
+  g++ -x c++ arena_test.c -o arena_test
+ and run the test:
+  ./arena_test
+*/
+
+#include <stdio.h>
+#include "../arena.h"
+#include "test_util.h"
+
+#define STRINGS 3000
+
+struct header {
+	const char *name;
+	long long value;
+	short flags;
+};
+
+static char *strs[STRINGS];
+
+static unsigned count_chunks(const struct arena *const a)
+{
+	const struct arena_chunk_ *c;
+	unsigned n = 0;
+	for (c = a->chunk; c; c = c->prev)
+		n++;
+	return n;
+}
+
+static int is_aligned(const void *const p, const size_t align)
+{
+	return !ptr_get_tags_(p, (unsigned)align);
+}
+
+/* string of random length, made of the index */
+static void make_str(char buf[], const unsigned i, const unsigned len)
+{
+	unsigned k;
+	for (k = 0; k < len; k++)
+		buf[k] = (char)('a' + (i + k) % 26);
+	buf[len] = '\0';
+}
+
+static void test_alloc(void)
+{
+	struct arena a;
+	char buf[600];
+	unsigned k;
+	arena_init(&a, 4096);
+	CHECK(!count_chunks(&a));
+
+	/* objects of different types are properly aligned */
+	for (k = 0; k < 1000; k++) {
+		char *const c = ARENA_NEW(&a, char);
+		short *const s = ARENA_NEW(&a, short);
+		double *const d = ARENA_NEW(&a, double);
+		struct header *const h = ARENA_NEW(&a, struct header);
+		long long *const arr = ARENA_NEW_ARRAY(&a, long long, k % 7 + 1);
+		CHECK(c && s && d && h && arr);
+		CHECK(is_aligned(s, ALIGNOF_TYPE(short)));
+		CHECK(is_aligned(d, ALIGNOF_TYPE(double)));
+		CHECK(is_aligned(h, ALIGNOF_TYPE(struct header)));
+		CHECK(is_aligned(arr, ALIGNOF_TYPE(long long)));
+		/* allocated one after another in the same chunk */
+		CHECK((char*)s > c && (char*)s < c + 1 + ALIGNOF_TYPE(short));
+	}
+	{
+		void *const p = arena_alloc(&a, 100, 4096);
+		CHECK(p && is_aligned(p, 4096));
+	}
+	CHECK(!ARENA_NEW_ARRAY(&a, struct header, (size_t)-1/2));
+
+	/* strings do not overlap */
+	for (k = 0; k < STRINGS; k++) {
+		make_str(buf, k, rnd() % 100);
+		strs[k] = arena_strdup(&a, buf);
+		CHECK(strs[k] != NULL);
+	}
+	/* a big object gets its own chunk */
+	{
+		const unsigned n = count_chunks(&a);
+		const size_t size = a.chunk->size; /* more than available in the chunk */
+		char *const big = (char*)arena_alloc(&a, size, 8);
+		CHECK(big != NULL);
+		memset(big, 0xA5, size);
+		CHECK(count_chunks(&a) == n + 1);
+	}
+	rnd_state = 1;
+	for (k = 0; k < STRINGS; k++) {
+		make_str(buf, k, rnd() % 100);
+		CHECK(!strcmp(strs[k], buf));
+	}
+#ifndef ARENA_HUGE_PAGES
+	CHECK(count_chunks(&a) > 10);
+#endif
+
+	/* the current chunk is reused */
+	arena_reset(&a);
+	CHECK(count_chunks(&a) == 1);
+	CHECK(a.cur == (char*)(a.chunk + 1));
+	CHECK(ARENA_NEW(&a, char) == (char*)(a.chunk + 1));
+	arena_destroy(&a);
+	CHECK(!count_chunks(&a));
+	CHECK(!a.cur && !a.end);
+}
+
+static void test_mark(void)
+{
+	struct arena a;
+	struct arena_mark m0, m1, m2;
+	char buf[1100];
+	unsigned k, n;
+	char *p;
+	arena_init(&a, 0);
+	CHECK(a.chunk_size == ARENA_CHUNK_SIZE);
+
+	/* mark of the empty arena */
+	arena_mark(&a, &m0);
+	strs[0] = arena_strdup(&a, "first");
+
+	arena_mark(&a, &m1);
+	n = count_chunks(&a);
+	p = (char*)arena_alloc(&a, 10, 1);
+	for (k = 1; k < STRINGS; k++) {
+		make_str(buf, k, 1000);
+		strs[k] = arena_strdup(&a, buf);
+		CHECK(strs[k] != NULL);
+		if (k == STRINGS/2)
+			arena_mark(&a, &m2);
+	}
+	CHECK(count_chunks(&a) > n);
+
+	/* nested marks are released in reverse order */
+	arena_release(&a, &m2);
+	make_str(buf, STRINGS/2, 1000);
+	CHECK(!strcmp(strs[STRINGS/2], buf));
+	arena_release(&a, &m1);
+	CHECK(count_chunks(&a) == n);
+	CHECK(!strcmp(strs[0], "first"));
+	/* memory after the mark is reused */
+	CHECK(arena_alloc(&a, 10, 1) == p);
+
+	arena_release(&a, &m0);
+	CHECK(!count_chunks(&a));
+	CHECK(!a.cur && !a.end);
+	CHECK(arena_strdup(&a, "again") != NULL);
+	arena_destroy(&a);
+}
+
+int main(void)
+{
+	test_alloc();
+	test_mark();
+	return test_result();
+}
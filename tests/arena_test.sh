@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./arena_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./arena_test.c -o ./arena_test || Exit
+Step && ./arena_test || Exit
+
+Step && $CC -Wall -pedantic -Wextra -DARENA_HUGE_PAGES ./arena_test.c -o ./arena_test_huge || Exit
+Step && ./arena_test_huge || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./arena_test.c -o ./arena_test_cxx || Exit
+Step && ./arena_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
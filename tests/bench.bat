@@ -0,0 +1,43 @@
+@echo off
+setlocal
+set step=0
+
+rem run micro-benchmarks:
+rem  bench.bat [filter]
+rem
+rem results are saved to bench.out, to compare them with previously saved results - use bench.sh
+
+rem 4464: relative include path contains '..'
+rem 4820: '...' bytes padding added after data member '...'
+rem 4514: '...': unreferenced inline function has been removed
+rem 4710: '...': function not inlined
+rem 4711: function '...' selected for automatic inline expansion
+rem 4996: 'fopen': This function or variable may be unsafe
+set "WARN=/Wall /wd4464 /wd4820 /wd4514 /wd4710 /wd4711 /wd4996"
+
+call :StepOk "cl /nologo /TC /O2 /DNDEBUG %WARN% bench.c /Fobench" || exit /b 1
+call :StepOk "cl /nologo /TC /O2 /DNDEBUG %WARN% /DBENCH_DPRINT_TO_LOG bench.c /Fobench_log" || exit /b 1
+call :StepOk "bench.exe %1 > bench.out" || exit /b 1
+call :StepOk "bench_log.exe dprint_log >> bench.out" || exit /b 1
+type bench.out
+
+echo =============== all benchmarks done ===============
+exit /b 0
+
+:StepOk
+echo step: %step%
+set /a step+=1
+rem see gawk-windows/test.bat:execq
+set "x=%~1"
+set "x=%x:>=^>%"
+set "x=%x:&=^&%"
+set "x=%x:^^^>=>%"
+set "x=%x:^^^&=&%"
+set "x=%x:^^^^=^%"
+echo %x:""="%
+set "x=%~1"
+set "x=%x:^^&=&%"
+set "x=%x:^^^^=^%"
+%x:""="% && exit /b 0
+echo failed.
+exit /b 1
@@ -0,0 +1,338 @@
+/**********************************************************************************
+* Micro-benchmarks of hot functions
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* bench.c */
+
+/* compile with
+  gcc -O2 bench.c -o bench
+ or, to measure DBGPRINT() via custom logging function instead of the standard stream:
+  gcc -O2 -DBENCH_DPRINT_TO_LOG bench.c -o bench_log
+
+ and run all benchmarks or only ones whose names contain given substring:
+  ./bench
+  ./bench get_opt
+*/
+
+#if defined __linux__ && !defined _GNU_SOURCE
+#define _GNU_SOURCE /* for sched_setaffinity() */
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "bench.h"
+#include "../bswaps.h"
+#include "../tagged_ptr.h"
+#include "../get_opt.inl"
+
+/* DBGPRINT() prints to the null device */
+static FILE *bench_null_stream = NULL;
+
+#ifdef BENCH_DPRINT_TO_LOG
+#define DPRINT_TO_LOG bench_log
+void bench_log(const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	(void)vfprintf(bench_null_stream, format, args);
+	va_end(args);
+}
+#define BENCH_DPRINT_NAME "dprint_log"
+#else
+#define DPRINT_TO_STREAM bench_null_stream
+#define BENCH_DPRINT_NAME "dprint_stream"
+#endif
+
+#include "../dprint.h"
+#include "../ihash.h" /* after dprint.h: includes it via ccasts.h */
+
+#define BENCH_ARRAY_SIZE 1024
+
+/* ---------------------------- bswaps.h ---------------------------- */
+
+static UINT16_TYPE bench_u16[BENCH_ARRAY_SIZE];
+static UINT32_TYPE bench_u32[BENCH_ARRAY_SIZE];
+static UINT64_TYPE bench_u64[BENCH_ARRAY_SIZE];
+
+static void bench_bswap2(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++)
+			bench_u16[i] = bswap2(bench_u16[i]);
+		BENCH_CLOBBER_MEMORY();
+	}
+}
+
+static void bench_bswap4(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++)
+			bench_u32[i] = bswap4(bench_u32[i]);
+		BENCH_CLOBBER_MEMORY();
+	}
+}
+
+static void bench_bswap8(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++)
+			bench_u64[i] = bswap8(bench_u64[i]);
+		BENCH_CLOBBER_MEMORY();
+	}
+}
+
+static void bench_hswap8(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++)
+			bench_u64[i] = hswap8(bench_u64[i]);
+		BENCH_CLOBBER_MEMORY();
+	}
+}
+
+/* ---------------------------- tagged_ptr.h ---------------------------- */
+
+static int bench_ints[BENCH_ARRAY_SIZE];
+static int *bench_ptrs[BENCH_ARRAY_SIZE];
+
+static void bench_ptr_add_tag(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++)
+			bench_ptrs[i] = PTR_ADD_TAG(int, &bench_ints[i], 1);
+		BENCH_CLOBBER_MEMORY();
+	}
+}
+
+static void bench_ptr_clear_tags(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++)
+			bench_ptrs[i] = PTR_CLEAR_TAGS(int, bench_ptrs[i]);
+		BENCH_CLOBBER_MEMORY();
+	}
+}
+
+static void bench_ptr_get_tags(void *ctx, unsigned long long iters)
+{
+	unsigned tags = 0;
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++)
+			tags += PTR_GET_TAGS(bench_ptrs[i]);
+		BENCH_DO_NOT_OPTIMIZE(tags);
+	}
+}
+
+/* ---------------------------- get_opt.inl ---------------------------- */
+
+#define SHORT_OPTION_a      SHORT_OPT_MODIFIER("aa", SHORT_OPTION_f)
+#define SHORT_OPTION_f      SHORT_OPT_MODIFIER("ff", SHORT_OPTION_l)
+#define SHORT_OPTION_l      SHORT_OPT_MODIFIER("ll", SHORT_OPTION_d)
+#define SHORT_OPTION_d      SHORT_OPT_MODIFIER("dd", SHORT_OPTION_o)
+#define SHORT_OPTION_o      SHORT_OPT_MODIFIER("o",  SHORT_OPTION_v)
+#define SHORT_OPTION_v      SHORT_OPT_MODIFIER("v",  SHORT_OPTION_g)
+#define SHORT_OPTION_g      SHORT_OPT_MODIFIER("g",  DASH_SHORT_OPTION_t)
+#define DASH_SHORT_OPTION_t SHORT_OPT_MODIFIER("t ", SHORT_OPT_NULL)
+
+#define SHORT_OPT_NULL      GET_OPT_TEXT("")
+#define SHORT_OPT_MODIFIER  SHORT_OPT_DEFINER
+
+static const GET_OPT_CHAR bench_short_opts[] = SHORT_OPTION_a;
+
+#define LONG_OPTION_file    LONG_OPT_MODIFIER("file",    1, LONG_OPTION_level)
+#define LONG_OPTION_level   LONG_OPT_MODIFIER("level",   1, LONG_OPTION_debug)
+#define LONG_OPTION_debug   LONG_OPT_MODIFIER("debug",   1, LONG_OPTION_output)
+#define LONG_OPTION_output  LONG_OPT_MODIFIER("output",  1, LONG_OPTION_verbose)
+#define LONG_OPTION_verbose LONG_OPT_MODIFIER("verbose", 0, LONG_OPTION_trace)
+#define LONG_OPTION_trace   LONG_OPT_MODIFIER("trace",   0, LONG_OPTION_help)
+#define LONG_OPTION_help    LONG_OPT_MODIFIER("help",    0, LONG_OPTION_version)
+#define LONG_OPTION_version LONG_OPT_MODIFIER("version", 0, LONG_OPT_NULL)
+
+#define LONG_OPT_NULL       {0,NULL}
+#define LONG_OPT_MODIFIER   LONG_OPT_DEFINER
+
+static const struct long_opt_info bench_long_opts[] = {LONG_OPTION_file};
+
+static GET_OPT_CHAR *bench_argv[] = {
+	GET_OPT_TEXT("prog"), GET_OPT_TEXT("--file"), GET_OPT_TEXT("a.txt"), GET_OPT_TEXT("-b3"), GET_OPT_TEXT("--level=4"),
+	GET_OPT_TEXT("-l"), GET_OPT_TEXT("5"), GET_OPT_TEXT("-d6"), GET_OPT_TEXT("--debug"), GET_OPT_TEXT("7"),
+	GET_OPT_TEXT("-o"), GET_OPT_TEXT("-vg"), GET_OPT_TEXT("--output=9"), GET_OPT_TEXT("-fg"), GET_OPT_TEXT("--verbose"),
+	GET_OPT_TEXT("--version"), GET_OPT_TEXT("-trace"), GET_OPT_TEXT("--help"), GET_OPT_TEXT("param"),
+	GET_OPT_TEXT("-ogv"), GET_OPT_TEXT("--trace"), GET_OPT_TEXT("--unknown"), GET_OPT_TEXT("--"), GET_OPT_TEXT("rest"),
+	NULL
+};
+
+static void bench_get_opt(void *ctx, unsigned long long iters)
+{
+	int sum = 0;
+	(void)ctx;
+	for (; iters; iters--) {
+		struct opt_info i;
+#ifdef GET_OPT_ARGV_NZ
+		opt_info_init(&i, (int)(sizeof(bench_argv)/sizeof(bench_argv[0])) - 1, bench_argv);
+#else
+		opt_info_init(&i, bench_argv);
+#endif
+		while (!opt_info_is_end(&i)) {
+			const int r = get_opt(&i, bench_short_opts, bench_long_opts);
+			sum += r;
+			if (OPT_UNKNOWN == r)
+				opt_skip_unknown(&i);
+			else if (OPT_REST_PARAMS == r)
+				break;
+		}
+		BENCH_DO_NOT_OPTIMIZE(sum);
+	}
+}
+
+static unsigned short bench_long_slots[LONG_OPT_HASH_SIZE(bench_long_opts)];
+static struct opt_index bench_opt_index;
+
+static void bench_get_opt_indexed(void *ctx, unsigned long long iters)
+{
+	int sum = 0;
+	(void)ctx;
+	for (; iters; iters--) {
+		struct opt_info i;
+#ifdef GET_OPT_ARGV_NZ
+		opt_info_init(&i, (int)(sizeof(bench_argv)/sizeof(bench_argv[0])) - 1, bench_argv);
+#else
+		opt_info_init(&i, bench_argv);
+#endif
+		while (!opt_info_is_end(&i)) {
+			const int r = get_opt_indexed(&i, &bench_opt_index);
+			sum += r;
+			if (OPT_UNKNOWN == r)
+				opt_skip_unknown(&i);
+			else if (OPT_REST_PARAMS == r)
+				break;
+		}
+		BENCH_DO_NOT_OPTIMIZE(sum);
+	}
+}
+
+/* ---------------------------- ihash.h ---------------------------- */
+
+struct bench_hitem {
+	unsigned key;
+	struct ihash_node hook;
+};
+
+static struct bench_hitem bench_hitems[BENCH_ARRAY_SIZE];
+static struct ihash bench_htab;
+
+static int bench_hitem_eq(const struct ihash_node *n, const void *key)
+{
+	return IHASH_ENTRY(n, const struct bench_hitem, hook)->key == *(const unsigned*)key;
+}
+
+static void bench_ihash_find(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--) {
+		unsigned i = 0, found = 0;
+		for (; i < BENCH_ARRAY_SIZE; i++) {
+			const unsigned key = (unsigned)bench_u32[i];
+			found += !!ihash_find(&bench_htab, ihash_mix(key), &key, bench_hitem_eq);
+		}
+		BENCH_DO_NOT_OPTIMIZE(found);
+	}
+}
+
+/* ---------------------------- dprint.h ---------------------------- */
+
+static void bench_dprint(void *ctx, unsigned long long iters)
+{
+	(void)ctx;
+	for (; iters; iters--)
+		DBGPRINT("message %d: %s", (int)(iters & 0xff), "text");
+}
+
+/* ------------------------------------------------------------------ */
+
+struct bench_info {
+	const char *name;
+	bench_fn_t *fn;
+};
+
+static const struct bench_info benchmarks[] = {
+	{"bswap2/1024",         bench_bswap2},
+	{"bswap4/1024",         bench_bswap4},
+	{"bswap8/1024",         bench_bswap8},
+	{"hswap8/1024",         bench_hswap8},
+	{"ptr_add_tag/1024",    bench_ptr_add_tag},
+	{"ptr_clear_tags/1024", bench_ptr_clear_tags},
+	{"ptr_get_tags/1024",   bench_ptr_get_tags},
+	{"get_opt/23",          bench_get_opt},
+	{"get_opt_indexed/23",  bench_get_opt_indexed},
+	{"ihash_find/1024",     bench_ihash_find},
+	{BENCH_DPRINT_NAME,     bench_dprint}
+};
+
+int main(int argc, char *argv[])
+{
+	const char *const filter = argc > 1 ? argv[1] : NULL;
+	unsigned i = 0;
+
+	for (; i < BENCH_ARRAY_SIZE; i++) {
+		bench_u16[i] = (UINT16_TYPE)(i*0x9E37u);
+		bench_u32[i] = (UINT32_TYPE)(i*0x9E3779B9u);
+		bench_u64[i] = (UINT64_TYPE)i*0x9E3779B97F4A7C15ull;
+		bench_ptrs[i] = &bench_ints[i];
+	}
+
+	ihash_init(&bench_htab);
+	for (i = 0; i < BENCH_ARRAY_SIZE; i++) {
+		bench_hitems[i].key = (unsigned)bench_u32[i];
+		if (ihash_insert(&bench_htab, &bench_hitems[i].hook, ihash_mix(bench_hitems[i].key))) {
+			fprintf(stderr, "failed to fill hash table\n");
+			return 1;
+		}
+	}
+
+	opt_index_init(&bench_opt_index, bench_short_opts, bench_long_opts,
+		bench_long_slots, sizeof(bench_long_slots)/sizeof(bench_long_slots[0]));
+
+#ifdef _WIN32
+	bench_null_stream = fopen("NUL", "w");
+#else
+	bench_null_stream = fopen("/dev/null", "w");
+#endif
+	if (!bench_null_stream) {
+		fprintf(stderr, "failed to open null device\n");
+		return 1;
+	}
+
+	if (bench_pin_cpu(0))
+		fprintf(stderr, "warning: failed to pin to CPU 0, results may be noisy\n");
+
+	for (i = 0; i < sizeof(benchmarks)/sizeof(benchmarks[0]); i++) {
+		if (bench_selected(benchmarks[i].name, filter))
+			(void)bench_run(benchmarks[i].name, benchmarks[i].fn, NULL);
+	}
+
+	(void)fclose(bench_null_stream);
+	ihash_destroy(&bench_htab);
+	return 0;
+}
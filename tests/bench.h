@@ -0,0 +1,194 @@
+#ifndef BENCH_H_INCLUDED
+#define BENCH_H_INCLUDED
+
+/**********************************************************************************
+* Micro-benchmarks harness
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* bench.h */
+
+/* defines:
+
+  BENCH_DO_NOT_OPTIMIZE(lvalue)        - force the compiler to compute the value and assume it is read,
+  BENCH_CLOBBER_MEMORY()               - force the compiler to assume all memory is read and written,
+  bench_pin_cpu(cpu)                   - bind current thread to given CPU, returns 0 on success,
+  bench_run(name, fn, ctx)             - run benchmark, print its median time per iteration and return it,
+  bench_selected(name, filter)         - check if benchmark name contains filter substring.
+
+  Output format (one line per benchmark):
+    <name> <median> ns/op mad <median absolute deviation> min <min> ns/op
+
+  Note: on Linux, define _GNU_SOURCE before including any headers for sched_setaffinity(),
+    on Windows - #include <windows.h> before this file.
+*/
+
+/* usage:
+
+static void bench_bswap4(void *ctx, unsigned long long iters)
+{
+	unsigned x = *(unsigned*)ctx;
+	for (; iters; iters--) {
+		x = bswap4(x) + 1;
+		BENCH_DO_NOT_OPTIMIZE(x);
+	}
+}
+
+int main(void)
+{
+	unsigned v = 1;
+	(void)bench_pin_cpu(0);
+	(void)bench_run("bswap4", bench_bswap4, &v);
+	return 0;
+}
+*/
+
+/* Implementation notes:
+
+  1) the number of iterations of one repetition is calibrated so that a repetition takes at least BENCH_REP_NS,
+  2) BENCH_WARMUP repetitions are run and discarded, then BENCH_REPS repetitions are timed via cpu_ticks(),
+  3) the median and the median absolute deviation (MAD) are robust against outliers caused by interrupts
+    and preemption, unlike the mean and the standard deviation. */
+
+#include <stdio.h>  /* for printf() */
+#include <string.h> /* for strstr() */
+#include "../cpu_ticks.h"
+
+#ifndef _WIN32
+#ifdef __linux__
+#include <sched.h> /* for sched_setaffinity() */
+#endif
+#endif
+
+/* number of discarded repetitions */
+#ifndef BENCH_WARMUP
+#define BENCH_WARMUP 3
+#endif
+
+/* number of timed repetitions */
+#ifndef BENCH_REPS
+#define BENCH_REPS 21
+#endif
+
+/* minimal duration of one repetition, in nanoseconds */
+#ifndef BENCH_REP_NS
+#define BENCH_REP_NS 2000000
+#endif
+
+#if defined __GNUC__ || defined __clang__
+#define BENCH_DO_NOT_OPTIMIZE(lvalue) __asm__ __volatile__("" : : "r,m"(lvalue) : "memory")
+#define BENCH_CLOBBER_MEMORY()        __asm__ __volatile__("" : : : "memory")
+#elif defined _MSC_VER
+#include <intrin.h> /* for _ReadWriteBarrier() */
+#define BENCH_DO_NOT_OPTIMIZE(lvalue) bench_escape_((const void*)&(lvalue))
+#define BENCH_CLOBBER_MEMORY()        _ReadWriteBarrier()
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined __GNUC__ && !defined __clang__ && defined _MSC_VER
+/* the compiler cannot see that the pointer is not used */
+static const void *volatile bench_sink_ = NULL;
+__declspec(noinline) static void bench_escape_(const void *const p)
+{
+	bench_sink_ = p;
+	_ReadWriteBarrier();
+}
+#endif
+
+/* benchmark function: must execute benchmarked code 'iters' times */
+typedef void bench_fn_t(void *ctx, unsigned long long iters);
+
+/* bind current thread to given CPU, to avoid migrations between CPUs, returns 0 on success, -1 on error */
+static int bench_pin_cpu(const unsigned cpu)
+{
+#ifdef _WIN32
+	return cpu < 8*sizeof(DWORD_PTR) && SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) ? 0 : -1;
+#elif defined __linux__ && defined CPU_SET
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return sched_setaffinity(0, sizeof(set), &set);
+#else
+	(void)cpu;
+	return -1; /* not supported */
+#endif
+}
+
+/* check if benchmark name contains filter substring, NULL filter selects all benchmarks */
+static int bench_selected(const char *const name/*!=NULL*/, const char *const filter/*NULL?*/)
+{
+	return !filter || strstr(name, filter) != NULL;
+}
+
+/* sort small array of values */
+static void bench_sort_(double a[], const unsigned n)
+{
+	unsigned i = 1;
+	for (; i < n; i++) {
+		const double v = a[i];
+		unsigned j = i;
+		for (; j && a[j - 1] > v; j--)
+			a[j] = a[j - 1];
+		a[j] = v;
+	}
+}
+
+/* median of sorted values */
+static double bench_median_(const double a[], const unsigned n/*>0*/)
+{
+	return (n & 1) ? a[n/2] : (a[n/2 - 1] + a[n/2])/2;
+}
+
+/* run benchmark, print statistics of time per iteration, returns median time per iteration, in nanoseconds */
+static double bench_run(const char *const name/*!=NULL*/, bench_fn_t *const fn/*!=NULL*/, void *const ctx)
+{
+	const double ns_per_tick = 1e9/(double)cpu_ticks_hz();
+	unsigned long long iters = 1;
+	double t[BENCH_REPS], d[BENCH_REPS];
+	double median, mad;
+	unsigned i = 0;
+
+	/* calibrate number of iterations */
+	for (;;) {
+		const unsigned long long t0 = cpu_ticks();
+		fn(ctx, iters);
+		if ((double)(cpu_ticks() - t0)*ns_per_tick >= BENCH_REP_NS || iters >= (~0ull >> 2))
+			break;
+		iters *= 2;
+	}
+
+	for (; i < BENCH_WARMUP; i++)
+		fn(ctx, iters);
+
+	for (i = 0; i < BENCH_REPS; i++) {
+		const unsigned long long t0 = cpu_ticks();
+		fn(ctx, iters);
+		t[i] = (double)(cpu_ticks() - t0)*ns_per_tick/(double)iters;
+	}
+
+	bench_sort_(t, BENCH_REPS);
+	median = bench_median_(t, BENCH_REPS);
+	for (i = 0; i < BENCH_REPS; i++)
+		d[i] = t[i] > median ? t[i] - median : median - t[i];
+	bench_sort_(d, BENCH_REPS);
+	mad = bench_median_(d, BENCH_REPS);
+
+	printf("%-32s %12.3f ns/op mad %9.3f min %12.3f ns/op\n", name, median, mad, t[0]);
+	(void)fflush(stdout);
+	return median;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* suppress warnings about unreferenced static functions */
+typedef int bench_pin_cpu_unused_[sizeof(&bench_pin_cpu)];
+typedef int bench_selected_unused_[sizeof(&bench_selected)];
+typedef int bench_run_unused_[sizeof(&bench_run)];
+
+#endif /* BENCH_H_INCLUDED */
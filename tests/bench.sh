@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# run micro-benchmarks:
+#  ./bench.sh [filter]
+#
+# results are saved to bench.out, to compare them with previously saved results, run as
+#  BASELINE=bench_old.out ./bench.sh [filter]
+#
+# the script fails if the median time of any benchmark exceeds baseline one by more than THRESHOLD percents (default: 10)
+
+step=0
+
+test "x$CC" = "x" && CC=gcc
+test "x$CFLAGS" = "x" && CFLAGS="-O2 -DNDEBUG"
+test "x$THRESHOLD" = "x" && THRESHOLD=10
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC $CFLAGS -Wall -pedantic -Wextra ./bench.c -o ./bench || Exit
+Step && $CC $CFLAGS -Wall -pedantic -Wextra -DBENCH_DPRINT_TO_LOG ./bench.c -o ./bench_log || Exit
+Step && ./bench $1 > bench.out || Exit
+# dprint_log benchmark is built separately, run it only if selected by the filter
+case dprint_log in *"$1"*)
+  Step && ./bench_log dprint_log > bench_log.out || Exit
+  Step && grep dprint_log bench_log.out >> bench.out || Exit
+esac
+cat bench.out
+
+if test "x$BASELINE" != "x"; then
+  # compare medians (2nd column) of benchmarks present in both files
+  Step && awk -v threshold=$THRESHOLD '
+    NR == FNR { base[$1] = $2; next }
+    ($1 in base) && base[$1] > 0 {
+      diff = ($2 - base[$1])*100/base[$1]
+      printf "%-32s %12.3f -> %12.3f ns/op %+7.1f%%%s\n", $1, base[$1], $2, diff, (diff > threshold ? "  REGRESSION" : "")
+      if (diff > threshold)
+        failed = 1
+    }
+    END { exit failed }' "$BASELINE" bench.out || Exit
+fi
+
+echo "=============== all benchmarks done ==============="
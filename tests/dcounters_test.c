@@ -0,0 +1,148 @@
+/**********************************************************************************
+* Debug counters test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dcounters_test.c */
+
+/* compile with
+  gcc -pthread dcounters_test.c -o dcounters_test
+ or
+  gcc -DDCOUNTERS_DISABLE dcounters_test.c -o dcounters_test
+ or
+  g++ -pthread -x c++ dcounters_test.c -o dcounters_test
+ and run the test:
+  ./dcounters_test
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define DPRINT_TO_LOG test_log
+#include "../dcounters.h"
+#include "test_util.h"
+
+#define THREADS 4
+#define INCREMENTS 10000
+
+DCOUNTER_DEFINE(reads);
+DCOUNTER_DEFINE(bytes);
+DCOUNTER_DEFINE(never_used);
+
+/* dumped counters */
+static char log_buf[1000];
+
+void test_log(const char *format, ...)
+{
+	const size_t len = strlen(log_buf);
+	va_list args;
+	va_start(args, format);
+	(void)vsnprintf(log_buf + len, sizeof(log_buf) - len, format, args);
+	va_end(args);
+}
+
+#ifndef DCOUNTERS_DISABLE
+static unsigned count_shards(const struct dcounter *const c)
+{
+	const struct dcounter_shard *s = c->shards;
+	unsigned n = 0;
+	for (; s; s = s->next)
+		n++;
+	return n;
+}
+#endif
+
+static void count(void)
+{
+	unsigned k;
+	for (k = 0; k < INCREMENTS; k++) {
+		DCOUNTER_INC(reads);
+		DCOUNTER_ADD(bytes, k);
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI thread_fn(LPVOID arg)
+{
+	(void)arg;
+	count();
+	return 0;
+}
+#else
+static void *thread_fn(void *arg)
+{
+	(void)arg;
+	count();
+	return NULL;
+}
+#endif
+
+static void run_threads(void)
+{
+	unsigned k;
+#ifdef _WIN32
+	HANDLE threads[THREADS];
+	for (k = 0; k < THREADS; k++) {
+		threads[k] = CreateThread(NULL, 0, thread_fn, NULL, 0, NULL);
+		CHECK(threads[k] != NULL);
+	}
+	for (k = 0; k < THREADS; k++) {
+		(void)WaitForSingleObject(threads[k], INFINITE);
+		(void)CloseHandle(threads[k]);
+	}
+#else
+	pthread_t threads[THREADS];
+	for (k = 0; k < THREADS; k++)
+		CHECK(!pthread_create(&threads[k], NULL, thread_fn, NULL));
+	for (k = 0; k < THREADS; k++)
+		CHECK(!pthread_join(threads[k], NULL));
+#endif
+}
+
+int main(void)
+{
+	const unsigned long long sum = INCREMENTS*(INCREMENTS - 1ull)/2;
+
+	/* nothing is dumped before the first increment */
+	DCOUNTERS_DUMP();
+	CHECK(!log_buf[0]);
+
+	run_threads();
+	count();
+
+#ifndef DCOUNTERS_DISABLE
+	CHECK(DCOUNTER_GET(reads) == (THREADS + 1)*INCREMENTS);
+	CHECK(DCOUNTER_GET(bytes) == (THREADS + 1)*sum);
+	CHECK(!DCOUNTER_GET(never_used));
+
+	/* each thread has its own shard */
+	CHECK(count_shards(&reads) == THREADS + 1);
+	CHECK(count_shards(&bytes) == THREADS + 1);
+
+	DCOUNTER_DUMP(reads);
+	CHECK(strstr(log_buf, "counter reads = 50000") != NULL);
+	log_buf[0] = '\0';
+
+	/* only used counters are dumped */
+	DCOUNTERS_DUMP();
+	CHECK(strstr(log_buf, "counter reads = 50000") != NULL);
+	CHECK(strstr(log_buf, "counter bytes = 249975000") != NULL);
+	CHECK(!strstr(log_buf, "never_used"));
+#else
+	CHECK(!DCOUNTER_GET(reads));
+	(void)sum;
+	DCOUNTER_DUMP(reads);
+	DCOUNTERS_DUMP();
+	CHECK(!log_buf[0]);
+#endif
+
+	return test_result();
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./dcounters_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra -pthread ./dcounters_test.c -o ./dcounters_test || Exit
+Step && ./dcounters_test || Exit
+
+Step && $CC -Wall -pedantic -Wextra -pthread -DDCOUNTERS_DISABLE ./dcounters_test.c -o ./dcounters_test_disabled || Exit
+Step && ./dcounters_test_disabled || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra -pthread ./dcounters_test.c -o ./dcounters_test_cxx || Exit
+Step && ./dcounters_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
@@ -0,0 +1,242 @@
+/**********************************************************************************
+* Intrusive lists test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dlist_test.c */
+
+/* compile with
+  gcc dlist_test.c -o dlist_test
+ or
+  g++ -x c++ dlist_test.c -o dlist_test
+ and run the test:
+  ./dlist_test
+*/
+
+/* should not compile:
+  gcc -c dlist_test.c -DBAD...
+*/
+
+#include <stdio.h>
+#include "../dlist.h"
+#include "../hlist.h"
+#include "test_util.h"
+
+struct item {
+	int id;
+	struct dlist_entry link;
+	struct hlist_node hash;
+};
+
+/* check that the list contains given ids, in both directions */
+static int dlist_check(const struct dlist_entry *const head, const int ids[], const unsigned count)
+{
+	const struct dlist_entry *e;
+	unsigned k = 0;
+	DLIST_FOR_EACH(e, head) {
+		const struct item *const it = DLIST_ENTRY(e, const struct item, link);
+		if (k == count || it->id != ids[k++])
+			return 0;
+	}
+	if (k != count)
+		return 0;
+	DLIST_FOR_EACH_REVERSE(e, head) {
+		const struct item *const it = DLIST_ENTRY(e, const struct item, link);
+		if (!k || it->id != ids[--k])
+			return 0;
+	}
+	return 1;
+}
+
+static int hlist_check(const struct hlist_head *const h, const int ids[], const unsigned count)
+{
+	const struct hlist_node *n;
+	unsigned k = 0;
+	HLIST_FOR_EACH(n, h) {
+		const struct item *const it = HLIST_ENTRY(n, const struct item, hash);
+		if (k == count || it->id != ids[k++])
+			return 0;
+	}
+	return k == count;
+}
+
+#ifdef BAD1
+/* non-const element cannot be obtained from const link */
+struct item *bad1(const struct dlist_entry *const e)
+{
+	return DLIST_ENTRY(e, struct item, link);
+}
+#endif
+
+#ifdef BAD2
+struct item *bad2(const struct hlist_node *const n)
+{
+	return HLIST_ENTRY(n, struct item, hash);
+}
+#endif
+
+static void test_dlist(void)
+{
+	struct item items[5];
+	struct dlist_entry head, other;
+	struct dlist_entry *e, *n;
+	int k;
+
+	for (k = 0; k < 5; k++)
+		items[k].id = k;
+
+	dlist_init(&head);
+	dlist_init(&other);
+	CHECK(dlist_is_empty(&head));
+	CHECK(!dlist_is_single(&head));
+	CHECK(!dlist_first(&head) && !dlist_last(&head));
+	CHECK(dlist_check(&head, NULL, 0));
+
+	dlist_add_tail(&head, &items[1].link);
+	CHECK(dlist_is_single(&head));
+	dlist_add_tail(&head, &items[2].link);
+	dlist_add_head(&head, &items[0].link);
+	CHECK(!dlist_is_empty(&head) && !dlist_is_single(&head));
+	{
+		static const int ids[] = {0, 1, 2};
+		CHECK(dlist_check(&head, ids, 3));
+	}
+	CHECK(dlist_first(&head) == &items[0].link);
+	CHECK(dlist_last(&head) == &items[2].link);
+	CHECK(dlist_next(&head, &items[0].link) == &items[1].link);
+	CHECK(!dlist_next(&head, &items[2].link));
+	CHECK(!dlist_prev(&head, &items[0].link));
+	CHECK(DLIST_OPT_ENTRY(dlist_last(&head), struct item, link) == &items[2]);
+	CHECK(DLIST_OPT_ENTRY(dlist_first(&other), struct item, link) == NULL);
+
+	dlist_insert_after(&items[1].link, &items[3].link);
+	dlist_insert_before(&items[0].link, &items[4].link);
+	{
+		static const int ids[] = {4, 0, 1, 3, 2};
+		CHECK(dlist_check(&head, ids, 5));
+	}
+
+	/* LRU: move accessed element to the head */
+	dlist_move_head(&head, &items[3].link);
+	dlist_move_head(&head, &items[3].link);
+	dlist_move_tail(&head, &items[4].link);
+	{
+		static const int ids[] = {3, 0, 1, 2, 4};
+		CHECK(dlist_check(&head, ids, 5));
+	}
+
+	dlist_remove(&items[0].link);
+	dlist_remove_init(&items[2].link);
+	CHECK(dlist_is_empty(&items[2].link));
+	{
+		static const int ids[] = {3, 1, 4};
+		CHECK(dlist_check(&head, ids, 3));
+	}
+
+	/* splice */
+	dlist_add_tail(&other, &items[0].link);
+	dlist_add_tail(&other, &items[2].link);
+	dlist_splice_tail(&head, &other);
+	CHECK(dlist_is_empty(&other));
+	dlist_splice_tail(&head, &other);
+	{
+		static const int ids[] = {3, 1, 4, 0, 2};
+		CHECK(dlist_check(&head, ids, 5));
+	}
+	dlist_remove(&items[1].link);
+	dlist_add_tail(&other, &items[1].link);
+	dlist_splice_head(&head, &other);
+	CHECK(dlist_is_empty(&other));
+	{
+		static const int ids[] = {1, 3, 4, 0, 2};
+		CHECK(dlist_check(&head, ids, 5));
+	}
+
+	/* remove elements while iterating */
+	DLIST_FOR_EACH_SAFE(e, n, &head) {
+		if (DLIST_ENTRY(e, struct item, link)->id & 1)
+			dlist_remove(e);
+	}
+	{
+		static const int ids[] = {4, 0, 2};
+		CHECK(dlist_check(&head, ids, 3));
+	}
+	DLIST_FOR_EACH_SAFE(e, n, &head)
+		dlist_remove_init(e);
+	CHECK(dlist_is_empty(&head));
+}
+
+static void test_hlist(void)
+{
+	static struct hlist_head zeroed; /* zero-initialized head is an empty list */
+	struct item items[5];
+	struct hlist_head h, h2;
+	struct hlist_node *n, *t;
+	int k;
+
+	for (k = 0; k < 5; k++) {
+		items[k].id = k;
+		hlist_node_init(&items[k].hash);
+		CHECK(!hlist_is_linked(&items[k].hash));
+	}
+
+	CHECK(hlist_is_empty(&zeroed));
+	hlist_init(&h);
+	hlist_init(&h2);
+	CHECK(hlist_is_empty(&h));
+	CHECK(!hlist_first(&h));
+	CHECK(hlist_check(&h, NULL, 0));
+
+	hlist_add_head(&h, &items[2].hash);
+	hlist_add_head(&h, &items[0].hash);
+	CHECK(hlist_is_linked(&items[0].hash));
+	hlist_add_after(&items[0].hash, &items[1].hash);
+	hlist_add_after(&items[2].hash, &items[4].hash);
+	hlist_add_before(&items[4].hash, &items[3].hash);
+	{
+		static const int ids[] = {0, 1, 2, 3, 4};
+		CHECK(hlist_check(&h, ids, 5));
+	}
+	CHECK(HLIST_OPT_ENTRY(hlist_first(&h), struct item, hash) == &items[0]);
+	CHECK(HLIST_OPT_ENTRY(hlist_first(&h2), struct item, hash) == NULL);
+
+	/* unlink the first, a middle and the last elements */
+	hlist_remove(&items[0].hash);
+	hlist_remove_init(&items[2].hash);
+	CHECK(!hlist_is_linked(&items[2].hash));
+	hlist_remove(&items[4].hash);
+	{
+		static const int ids[] = {1, 3};
+		CHECK(hlist_check(&h, ids, 2));
+	}
+	hlist_add_before(&items[1].hash, &items[0].hash);
+	{
+		static const int ids[] = {0, 1, 3};
+		CHECK(hlist_check(&h, ids, 3));
+	}
+
+	hlist_move_list(&h, &h2);
+	CHECK(hlist_is_empty(&h));
+	{
+		static const int ids[] = {0, 1, 3};
+		CHECK(hlist_check(&h2, ids, 3));
+	}
+	hlist_remove(&items[0].hash); /* pprev of the first element points into new head */
+	{
+		static const int ids[] = {1, 3};
+		CHECK(hlist_check(&h2, ids, 2));
+	}
+
+	HLIST_FOR_EACH_SAFE(n, t, &h2)
+		hlist_remove_init(n);
+	CHECK(hlist_is_empty(&h2));
+	CHECK(!hlist_is_linked(&items[1].hash) && !hlist_is_linked(&items[3].hash));
+}
+
+int main(void)
+{
+	test_dlist();
+	test_hlist();
+	return test_result();
+}
@@ -0,0 +1,34 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./dlist_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./dlist_test.c -o ./dlist_test || Exit
+Step && ./dlist_test || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./dlist_test.c -o ./dlist_test_cxx || Exit
+Step && ./dlist_test_cxx || Exit
+
+# should not be compiled
+Step && $CC -c dlist_test.c -o dlist_test.o -DBAD1 && Exit
+Step && $CC -c dlist_test.c -o dlist_test.o -DBAD2 && Exit
+Step && $CXX -x c++ -c dlist_test.c -o dlist_test.o -DBAD1 && Exit
+Step && $CXX -x c++ -c dlist_test.c -o dlist_test.o -DBAD2 && Exit
+
+echo "=============== all tests OK ==============="
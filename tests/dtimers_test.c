@@ -0,0 +1,161 @@
+/**********************************************************************************
+* Debug timers test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dtimers_test.c */
+
+/* compile with
+  gcc dtimers_test.c -o dtimers_test
+ or
+  g++ -x c++ dtimers_test.c -o dtimers_test
+ and run the test:
+  ./dtimers_test
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define DPRINT_TO_LOG test_log
+#include "../dtimers.h"
+#include "test_util.h"
+
+DTIMER_DEFINE(known);
+DTIMER_DEFINE(scoped);
+DTIMER_DEFINE(idle);
+
+/* dumped timers */
+static char log_buf[1000];
+
+void test_log(const char *format, ...)
+{
+	const size_t len = strlen(log_buf);
+	va_list args;
+	va_start(args, format);
+	(void)vsnprintf(log_buf + len, sizeof(log_buf) - len, format, args);
+	va_end(args);
+}
+
+/* buckets of given values */
+static unsigned long long buckets[DTIMER_BUCKETS];
+
+static void fill(const unsigned long long first, const unsigned long long last)
+{
+	unsigned long long v = first;
+	memset(buckets, 0, sizeof(buckets));
+	for (; v <= last; v++)
+		buckets[dtimer_bucket_(v)]++;
+}
+
+static void test_buckets(void)
+{
+	unsigned k, b;
+
+	/* small values have own buckets */
+	for (k = 0; k < DTIMER_SUB_BUCKETS; k++) {
+		CHECK(dtimer_bucket_(k) == k);
+		CHECK(dtimer_bucket_max_(k) == k);
+	}
+
+	/* a power of two starts a new bucket */
+	for (k = DTIMER_SUB_BITS; k < DTIMER_MAX_BITS; k++) {
+		const unsigned long long p = 1ull << k;
+		b = dtimer_bucket_(p);
+		CHECK(b % DTIMER_SUB_BUCKETS == 0);
+		CHECK(dtimer_bucket_(p - 1) == b - 1);
+		CHECK(dtimer_bucket_max_(b - 1) == p - 1);
+		CHECK(dtimer_bucket_(p + (p >> DTIMER_SUB_BITS) - 1) == b);
+		CHECK(dtimer_bucket_(p + (p >> DTIMER_SUB_BITS)) == b + 1);
+	}
+
+	/* long durations are recorded into the top bucket */
+	CHECK(dtimer_bucket_max_(DTIMER_BUCKETS - 1) == (1ull << DTIMER_MAX_BITS) - 1);
+	CHECK(dtimer_bucket_((1ull << DTIMER_MAX_BITS) - 1) == DTIMER_BUCKETS - 1);
+	CHECK(dtimer_bucket_(1ull << DTIMER_MAX_BITS) == DTIMER_BUCKETS - 1);
+	CHECK(dtimer_bucket_(~0ull) == DTIMER_BUCKETS - 1);
+
+	/* bucket bounds: relative error is less than 1/DTIMER_SUB_BUCKETS */
+	for (k = 0; k < 100000; k++) {
+		const unsigned long long v = ((unsigned long long)rnd() << 15 | rnd()) >> (rnd() % 30);
+		b = dtimer_bucket_(v);
+		CHECK(v <= dtimer_bucket_max_(b));
+		CHECK(!b || v > dtimer_bucket_max_(b - 1));
+		CHECK(dtimer_bucket_max_(b) - v < (v + DTIMER_SUB_BUCKETS)/DTIMER_SUB_BUCKETS);
+	}
+}
+
+static void test_percentiles(void)
+{
+	/* exact for small values */
+	fill(1, 10);
+	CHECK(dtimer_percentile_(buckets, 10, 10, 500000) == 5);
+	CHECK(dtimer_percentile_(buckets, 10, 10, 990000) == 10);
+	CHECK(dtimer_percentile_(buckets, 10, 10, 0) == 1);
+
+	/* upper bound of the bucket of the value of given rank */
+	fill(1, 1000);
+	CHECK(dtimer_percentile_(buckets, 1000, 1000, 500000) == 511);  /* 500 -> [496, 511] */
+	CHECK(dtimer_percentile_(buckets, 1000, 1000, 990000) == 991);  /* 990 -> [960, 991] */
+	CHECK(dtimer_percentile_(buckets, 1000, 1000, 999000) == 1000); /* 999 -> [992, 1023], limited by max */
+	CHECK(dtimer_percentile_(buckets, 1000, 1000, 1000000) == 1000);
+
+	/* values of the top bucket are reported as the max */
+	memset(buckets, 0, sizeof(buckets));
+	buckets[dtimer_bucket_(100)] = 99;
+	buckets[dtimer_bucket_(1ull << 45)] = 1;
+	CHECK(dtimer_percentile_(buckets, 100, 1ull << 45, 500000) == 103);
+	CHECK(dtimer_percentile_(buckets, 100, 1ull << 45, 990000) == 103);
+	CHECK(dtimer_percentile_(buckets, 100, 1ull << 45, 999000) == 1ull << 45);
+}
+
+static void test_record(void)
+{
+	unsigned k;
+
+	/* nothing is dumped before the first measurement */
+	DTIMERS_DUMP();
+	CHECK(!log_buf[0]);
+
+	for (k = 1; k <= 1000; k++)
+		DTIMER_RECORD(known, k);
+	CHECK(known_dtimer_hist_ && known.hists == known_dtimer_hist_);
+	CHECK(known_dtimer_hist_->count == 1000);
+	CHECK(known_dtimer_hist_->sum == 500500);
+	CHECK(known_dtimer_hist_->max == 1000);
+	CHECK(known_dtimer_hist_->buckets[dtimer_bucket_(500)] == 16);
+
+	DTIMER_BEGIN(scoped);
+	DTIMER_END(scoped);
+#if defined __cplusplus || defined __GNUC__ || defined __clang__
+	{
+		SCOPED_TIMER(scoped);
+	}
+#else
+	DTIMER_RECORD(scoped, 1);
+#endif
+	CHECK(scoped_dtimer_hist_ && scoped_dtimer_hist_->count == 2);
+
+	DTIMER_DUMP(idle);
+	CHECK(strstr(log_buf, "timer idle: no measurements") != NULL);
+	log_buf[0] = '\0';
+
+	/* only used timers are dumped */
+	DTIMERS_DUMP();
+	CHECK(strstr(log_buf, "timer known: count=1000 mean=") != NULL);
+	CHECK(strstr(log_buf, "timer scoped: count=2 mean=") != NULL);
+	CHECK(!strstr(log_buf, "idle"));
+}
+
+int main(void)
+{
+	test_buckets();
+	test_percentiles();
+	test_record();
+	return test_result();
+}
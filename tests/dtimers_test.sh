@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./dtimers_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./dtimers_test.c -o ./dtimers_test || Exit
+Step && ./dtimers_test || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./dtimers_test.c -o ./dtimers_test_cxx || Exit
+Step && ./dtimers_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
@@ -0,0 +1,196 @@
+/**********************************************************************************
+* Trace events test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* dtrace_test.c */
+
+/* compile with
+  gcc -pthread -DDTRACE_ENABLE dtrace_test.c -o dtrace_test
+ or
+  gcc dtrace_test.c -o dtrace_test
+ or
+  g++ -pthread -DDTRACE_ENABLE -x c++ dtrace_test.c -o dtrace_test
+ and run the test:
+  ./dtrace_test
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#define DTRACE_BUFFER_EVENTS 256
+#include "../dtrace.h"
+#include "test_util.h"
+
+#define THREADS 2
+#define ITERATIONS 50
+#define OVERFLOW_EVENTS 300
+
+DTRACE_STATE_DEFINE;
+
+/* written JSON */
+static char json[1 << 18];
+
+static void work(void)
+{
+	unsigned k;
+	DTRACE_THREAD_NAME("worker");
+	for (k = 0; k < ITERATIONS; k++) {
+#if defined __cplusplus || defined __GNUC__ || defined __clang__
+		DTRACE_SCOPE("item");
+#else
+		DTRACE_BEGIN("item");
+#endif
+		DTRACE_BEGIN("lock");
+		DTRACE_END("lock");
+		DTRACE_INSTANT("log");
+#if !defined __cplusplus && !defined __GNUC__ && !defined __clang__
+		DTRACE_END("item");
+#endif
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI thread_fn(LPVOID arg)
+{
+	(void)arg;
+	work();
+	return 0;
+}
+#else
+static void *thread_fn(void *arg)
+{
+	(void)arg;
+	work();
+	return NULL;
+}
+#endif
+
+static void run_threads(void)
+{
+	unsigned k;
+#ifdef _WIN32
+	HANDLE threads[THREADS];
+	for (k = 0; k < THREADS; k++) {
+		threads[k] = CreateThread(NULL, 0, thread_fn, NULL, 0, NULL);
+		CHECK(threads[k] != NULL);
+	}
+	for (k = 0; k < THREADS; k++) {
+		(void)WaitForSingleObject(threads[k], INFINITE);
+		(void)CloseHandle(threads[k]);
+	}
+#else
+	pthread_t threads[THREADS];
+	for (k = 0; k < THREADS; k++)
+		CHECK(!pthread_create(&threads[k], NULL, thread_fn, NULL));
+	for (k = 0; k < THREADS; k++)
+		CHECK(!pthread_join(threads[k], NULL));
+#endif
+}
+
+/* write recorded events to the json[] */
+static size_t write_json(void)
+{
+	size_t len = 0;
+	FILE *const f = tmpfile();
+	CHECK(f != NULL);
+	if (f) {
+		DTRACE_WRITE_JSON(f); /* may be used as a statement */
+		rewind(f);
+		CHECK(!DTRACE_WRITE_JSON(f));
+		rewind(f);
+		len = fread(json, 1, sizeof(json) - 1, f);
+		(void)fclose(f);
+	}
+	json[len] = '\0';
+	return len;
+}
+
+#ifdef DTRACE_ENABLE
+
+static unsigned count_str(const char *const s)
+{
+	const char *p = json;
+	unsigned n = 0;
+	for (; (p = strstr(p, s)) != NULL; p++)
+		n++;
+	return n;
+}
+
+/* check that each event is a separate JSON object and timestamps of a thread do not decrease */
+static void check_events(void)
+{
+	unsigned prev_tid = 0;
+	double prev_ts = 0.0;
+	const char *line = strchr(json, '\n');
+	for (; line && line[1] != ']'; line = strchr(line + 1, '\n')) {
+		const char *const end = strchr(line + 1, '\n');
+		const char *const ts = strstr(line, "\"ts\":");
+		const char *const tid = strstr(line, "\"tid\":");
+		CHECK(line[1] == '{');
+		CHECK(end && (end[-1] == ',' ? end[-2] : end[-1]) == '}');
+		CHECK(tid && tid < end);
+		if (ts && ts < end && tid && tid < end) {
+			double t = 0.0;
+			unsigned i = 0;
+			CHECK(sscanf(ts + 5, "%lf", &t) == 1);
+			CHECK(sscanf(tid + 6, "%u", &i) == 1);
+			CHECK(t >= 0.0);
+			CHECK(i != prev_tid || t >= prev_ts);
+			prev_tid = i;
+			prev_ts = t;
+		}
+	}
+}
+
+#endif /* DTRACE_ENABLE */
+
+int main(void)
+{
+	const char prefix[] = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	const char suffix[] = "\n]}\n";
+	unsigned k;
+	size_t len;
+
+	run_threads();
+
+	/* names are escaped */
+	DTRACE_INSTANT("say \"hi\"\n");
+
+	/* excessive events are dropped */
+	for (k = 1; k < OVERFLOW_EVENTS; k++)
+		DTRACE_INSTANT("overflow");
+
+	len = write_json();
+
+#ifdef DTRACE_ENABLE
+	CHECK(len > sizeof(prefix) + sizeof(suffix));
+	CHECK(!strncmp(json, prefix, sizeof(prefix) - 1));
+	CHECK(len >= sizeof(suffix) - 1 && !strcmp(json + len - (sizeof(suffix) - 1), suffix));
+	CHECK(count_str("\"name\":\"thread_name\",\"ph\":\"M\"") == THREADS);
+	CHECK(count_str("\"name\":\"worker\"") == THREADS);
+	CHECK(count_str("\"name\":\"item\",\"ph\":\"B\"") == THREADS*ITERATIONS);
+	CHECK(count_str("\"name\":\"item\",\"ph\":\"E\"") == THREADS*ITERATIONS);
+	CHECK(count_str("\"ph\":\"B\"") == 2*THREADS*ITERATIONS);
+	CHECK(count_str("\"ph\":\"E\"") == 2*THREADS*ITERATIONS);
+	CHECK(count_str("\"name\":\"log\",\"ph\":\"i\"") == THREADS*ITERATIONS);
+	CHECK(count_str("\"name\":\"say \\\"hi\\\"\\u000a\",\"ph\":\"i\"") == 1);
+	CHECK(count_str("\"name\":\"overflow\"") == DTRACE_BUFFER_EVENTS - 1);
+	CHECK(count_str("\"name\":\"dropped 44 events\",\"ph\":\"i\"") == 1);
+	CHECK(count_str("\"s\":\"t\"") == THREADS*ITERATIONS + DTRACE_BUFFER_EVENTS + 1);
+	check_events();
+#else
+	CHECK(!len);
+	(void)prefix;
+	(void)suffix;
+#endif
+
+	return test_result();
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./dtrace_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra -pthread -DDTRACE_ENABLE ./dtrace_test.c -o ./dtrace_test || Exit
+Step && ./dtrace_test || Exit
+
+Step && $CC -Wall -pedantic -Wextra -pthread ./dtrace_test.c -o ./dtrace_test_disabled || Exit
+Step && ./dtrace_test_disabled || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra -pthread -DDTRACE_ENABLE ./dtrace_test.c -o ./dtrace_test_cxx || Exit
+Step && ./dtrace_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
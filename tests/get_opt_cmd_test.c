@@ -0,0 +1,274 @@
+/**********************************************************************************
+* Subcommands dispatch test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_cmd_test.c */
+
+/* compile with
+  gcc get_opt_cmd_test.c -o get_opt_cmd_test
+ or
+  gcc -DGET_OPT_ARGV_NZ get_opt_cmd_test.c -o get_opt_cmd_test
+ and run the test:
+  ./get_opt_cmd_test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../get_opt.inl"
+#include "../get_opt_cmd.inl"
+#include "test_util.h"
+
+/* options of "add" subcommand */
+
+#define ADD_SHORT_f       SHORT_OPT_MODIFIER("ff", SHORT_OPT_NULL)
+#define ADD_LONG_force    LONG_OPT_MODIFIER("force", 0, ADD_LONG_name)
+#define ADD_LONG_name     LONG_OPT_MODIFIER("name", 1, LONG_OPT_NULL)
+
+/* options of "remove" subcommand */
+
+#define RM_SHORT_r        SHORT_OPT_MODIFIER("r", SHORT_OPT_NULL)
+#define RM_LONG_all       LONG_OPT_MODIFIER("all", 0, LONG_OPT_NULL)
+
+/* options of "exec" subcommand, other options are delegated to "add" options parser */
+
+#define EXEC_SHORT_v      SHORT_OPT_MODIFIER("v", SHORT_OPT_NULL)
+
+/* subcommands */
+
+#define CMD_add           LONG_OPT_MODIFIER("add",    0, CMD_remove)
+#define CMD_remove        LONG_OPT_MODIFIER("remove", 0, CMD_list)
+#define CMD_list          LONG_OPT_MODIFIER("list",   0, CMD_exec)
+#define CMD_exec          LONG_OPT_MODIFIER("exec",   0, LONG_OPT_NULL)
+
+#define SHORT_OPT_NULL      GET_OPT_TEXT("")
+#define SHORT_OPT_MODIFIER  SHORT_OPT_DEFINER
+#define LONG_OPT_NULL       {0,NULL}
+#define LONG_OPT_MODIFIER   LONG_OPT_DEFINER
+
+static const GET_OPT_CHAR add_short_opts[] = ADD_SHORT_f;
+static const struct long_opt_info add_long_opts[] = {ADD_LONG_force};
+static const GET_OPT_CHAR rm_short_opts[] = RM_SHORT_r;
+static const struct long_opt_info rm_long_opts[] = {RM_LONG_all};
+static const GET_OPT_CHAR exec_short_opts[] = EXEC_SHORT_v;
+static const struct long_opt_info cmd_names[] = {CMD_add};
+
+#undef  LONG_OPT_NULL
+#undef  LONG_OPT_MODIFIER
+#define LONG_OPT_MODIFIER   LONG_OPT_ENCODER
+#undef  SHORT_OPT_NULL
+#undef  SHORT_OPT_MODIFIER
+#define SHORT_OPT_MODIFIER  SHORT_OPT_ENCODER
+
+/* result of the last handler call */
+static char result[256];
+
+/* arguments of the last run */
+static GET_OPT_CHAR **run_argv;
+
+static void append(const char *s)
+{
+	const size_t n = strlen(result);
+	if (n + strlen(s) < sizeof(result))
+		strcpy(result + n, s);
+}
+
+#define SHORT_OPT_NULL      SHORT_OPT_END_POS(add_short_opts)
+#define LONG_OPT_NULL       LONG_OPT_END_IDX(add_long_opts)
+
+/* parse one option of "add" subcommand, returns 0 if the option is unknown */
+static int add_option(struct opt_info *i)
+{
+	switch (get_opt(i, add_short_opts, add_long_opts)) {
+		case ADD_SHORT_f:
+			append(" f:");
+			append(i->value ? i->value : "<null>");
+			return 1;
+		case ADD_LONG_force:
+			append(" force");
+			return 1;
+		case ADD_LONG_name:
+			append(" name:");
+			append(i->value ? i->value : "<null>");
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+static int cmd_add(struct opt_info *i, const struct opt_cmd *cmd)
+{
+	append("add");
+	while (!opt_info_is_end(i)) {
+		switch (get_opt_indexed(i, cmd->x)) {
+			case ADD_SHORT_f:
+				append(" f:");
+				append(i->value ? i->value : "<null>");
+				break;
+			case ADD_LONG_force:
+				append(" force");
+				break;
+			case ADD_LONG_name:
+				append(" name:");
+				append(i->value ? i->value : "<null>");
+				break;
+			case OPT_PARAMETER:
+				append(" param:");
+				append(i->value);
+				break;
+			case OPT_UNKNOWN:
+				append(" unknown");
+				opt_skip_unknown(i);
+				break;
+			default:
+				return 1;
+		}
+	}
+	return 0;
+}
+
+#undef  SHORT_OPT_NULL
+#undef  LONG_OPT_NULL
+#define SHORT_OPT_NULL      SHORT_OPT_END_POS(rm_short_opts)
+#define LONG_OPT_NULL       LONG_OPT_END_IDX(rm_long_opts)
+
+static int cmd_remove(struct opt_info *i, const struct opt_cmd *cmd)
+{
+	append("remove");
+	while (!opt_info_is_end(i)) {
+		switch (get_opt(i, cmd->short_opts, cmd->long_opts)) {
+			case RM_SHORT_r:
+				append(" r");
+				break;
+			case RM_LONG_all:
+				append(" all");
+				break;
+			case OPT_PARAMETER:
+				append(" param:");
+				append(i->value);
+				break;
+			default:
+				return 1;
+		}
+	}
+	return 0;
+}
+
+static int cmd_list(struct opt_info *i, const struct opt_cmd *cmd)
+{
+	(void)cmd;
+	append("list");
+	return opt_info_is_end(i) ? 0 : 1;
+}
+
+#undef  SHORT_OPT_NULL
+#define SHORT_OPT_NULL      SHORT_OPT_END_POS(exec_short_opts)
+
+/* tokenize arguments after the subcommand name, delegate unknown options to "add" options parser */
+static int cmd_exec(struct opt_info *i, const struct opt_cmd *cmd)
+{
+	struct opt_token tokens[16];
+	unsigned n, k;
+	append("exec");
+	n = opt_tokenize(i, run_argv, cmd->short_opts, NULL, NULL, tokens, sizeof(tokens)/sizeof(tokens[0]));
+	if (n > sizeof(tokens)/sizeof(tokens[0]))
+		return 1;
+	for (k = 0; k < n;) {
+		switch (tokens[k].opt) {
+			case EXEC_SHORT_v:
+				append(" v");
+				break;
+			case OPT_PARAMETER:
+				append(" param:");
+				append(tokens[k].value);
+				break;
+			case OPT_UNKNOWN:
+				opt_token_reparse(i, run_argv, &tokens[k]);
+				if (!add_option(i))
+					return 1;
+				k = opt_token_resume(i, run_argv, tokens, n, k);
+				continue;
+			default:
+				return 1;
+		}
+		k++;
+	}
+	return 0;
+}
+
+#undef  LONG_OPT_NULL
+#define LONG_OPT_NULL       LONG_OPT_END_IDX(cmd_names)
+
+static struct opt_index add_index;
+static unsigned short add_long_slots[LONG_OPT_HASH_SIZE(add_long_opts)];
+
+static const struct opt_cmd cmds[] = {
+	{add_short_opts, add_long_opts, cmd_add, &add_index, add_long_slots, LONG_OPT_HASH_SIZE(add_long_opts)},
+	{rm_short_opts, rm_long_opts, cmd_remove, NULL, NULL, 0},
+	{NULL, NULL, cmd_list, NULL, NULL, 0},
+	{exec_short_opts, NULL, cmd_exec, NULL, NULL, 0}
+};
+
+/* dispatch the command line, returns handler result or -1 if subcommand is not found */
+static int run(const struct opt_cmd_table *t, GET_OPT_CHAR *argv[])
+{
+	struct opt_info i;
+	const struct opt_cmd *cmd;
+	int argc = 0;
+	while (argv[argc])
+		argc++;
+#ifdef GET_OPT_ARGV_NZ
+	opt_info_init(&i, argc, argv);
+#else
+	opt_info_init(&i, argv);
+	(void)argc;
+#endif
+	result[0] = '\0';
+	run_argv = argv;
+	cmd = opt_info_is_end(&i) ? NULL : opt_cmd_select(t, &i);
+	return cmd ? cmd->handler(&i, cmd) : -1;
+}
+
+int main(void)
+{
+	static unsigned short slots[LONG_OPT_HASH_SIZE(cmd_names)];
+	static GET_OPT_CHAR *argv1[] = {GET_OPT_TEXT("prog"), GET_OPT_TEXT("add"), GET_OPT_TEXT("-fx"),
+		GET_OPT_TEXT("--force"), GET_OPT_TEXT("--name"), GET_OPT_TEXT("n"), GET_OPT_TEXT("-r"), GET_OPT_TEXT("p"), NULL};
+	static GET_OPT_CHAR *argv2[] = {GET_OPT_TEXT("prog"), GET_OPT_TEXT("remove"), GET_OPT_TEXT("-r"),
+		GET_OPT_TEXT("--all"), GET_OPT_TEXT("x"), NULL};
+	static GET_OPT_CHAR *argv3[] = {GET_OPT_TEXT("prog"), GET_OPT_TEXT("list"), NULL};
+	static GET_OPT_CHAR *argv4[] = {GET_OPT_TEXT("prog"), GET_OPT_TEXT("lis"), NULL};
+	static GET_OPT_CHAR *argv5[] = {GET_OPT_TEXT("prog"), GET_OPT_TEXT("list=1"), NULL};
+	static GET_OPT_CHAR *argv6[] = {GET_OPT_TEXT("prog"), NULL};
+	static GET_OPT_CHAR *argv7[] = {GET_OPT_TEXT("prog"), GET_OPT_TEXT("--add"), NULL};
+	static GET_OPT_CHAR *argv8[] = {GET_OPT_TEXT("prog"), GET_OPT_TEXT("exec"), GET_OPT_TEXT("-vfx"),
+		GET_OPT_TEXT("--name"), GET_OPT_TEXT("n"), GET_OPT_TEXT("p"), NULL};
+	struct opt_cmd_table t;
+
+	opt_cmd_table_init(&t, cmd_names, cmds, slots, sizeof(slots)/sizeof(slots[0]));
+
+	CHECK(opt_cmd_find(&t, GET_OPT_TEXT("add")) == &cmds[0]);
+	CHECK(opt_cmd_find(&t, GET_OPT_TEXT("remove")) == &cmds[1]);
+	CHECK(opt_cmd_find(&t, GET_OPT_TEXT("list")) == &cmds[2]);
+	CHECK(opt_cmd_find(&t, GET_OPT_TEXT("exec")) == &cmds[3]);
+	CHECK(opt_cmd_find(&t, GET_OPT_TEXT("")) == NULL);
+	CHECK(opt_cmd_find(&t, GET_OPT_TEXT("addd")) == NULL);
+
+	/* index of "add" is not initialized until it is selected */
+	CHECK(add_index.short_opts == NULL);
+	CHECK(0 == run(&t, argv1) && !strcmp(result, "add f:x force name:n unknown param:p"));
+	CHECK(add_index.short_opts == add_short_opts);
+
+	CHECK(0 == run(&t, argv2) && !strcmp(result, "remove r all param:x"));
+	CHECK(0 == run(&t, argv3) && !strcmp(result, "list"));
+	CHECK(-1 == run(&t, argv4));
+	CHECK(-1 == run(&t, argv5));
+	CHECK(-1 == run(&t, argv6));
+	CHECK(-1 == run(&t, argv7));
+
+	/* tokens of the subcommand arguments are indexes in the whole argv[] */
+	CHECK(0 == run(&t, argv8) && !strcmp(result, "exec v f:x name:n param:p"));
+
+	return test_result();
+}
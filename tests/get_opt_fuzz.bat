@@ -0,0 +1,56 @@
+@echo off
+setlocal
+set step=0
+
+rem differential testing of get_opt() on random inputs,
+rem number of inputs and the seed may be specified, e.g.:
+rem get_opt_fuzz.bat 1000000 12345
+
+rem 4464: relative include path contains '..'
+rem 4820: '...' bytes padding added after data member '...'
+rem 4996: 'fopen': This function or variable may be unsafe
+set "WARN=/Wall /wd4464 /wd4820 /wd4996"
+
+set "COUNT=%~1"
+if "%COUNT%"=="" set "COUNT=200000"
+set "SEED=%~2"
+if "%SEED%"=="" set "SEED=1"
+
+call :StepOk "cl /nologo /O2 /TC %WARN% get_opt_fuzz.c /Foget_opt_fuzz" || exit /b 1
+call :StepOk "get_opt_fuzz.exe -r %COUNT% %SEED%" || exit /b 1
+
+call :StepOk "cl /nologo /O2 /TC %WARN% /DGET_OPT_ARGV_NZ get_opt_fuzz.c /Foget_opt_fuzz_nz" || exit /b 1
+call :StepOk "get_opt_fuzz_nz.exe -r %COUNT% %SEED%" || exit /b 1
+
+call :StepOk "cl /nologo /O2 /TC %WARN% /DGET_OPT_WIDE_CHAR_SUPPORT get_opt_fuzz.c /Foget_opt_fuzz_w" || exit /b 1
+call :StepOk "get_opt_fuzz_w.exe -r %COUNT% %SEED%" || exit /b 1
+
+call :StepOk "cl /nologo /O2 /TC %WARN% /DGET_OPT_WIDE_CHAR_SUPPORT /DGET_OPT_ARGV_NZ get_opt_fuzz.c /Foget_opt_fuzz_w_nz" || exit /b 1
+call :StepOk "get_opt_fuzz_w_nz.exe -r %COUNT% %SEED%" || exit /b 1
+
+call :StepOk "cl /nologo /O2 /TC %WARN% /DGET_OPT_UTF8 get_opt_fuzz.c /Foget_opt_fuzz_u" || exit /b 1
+call :StepOk "get_opt_fuzz_u.exe -r %COUNT% %SEED%" || exit /b 1
+
+call :StepOk "cl /nologo /O2 /TC %WARN% /DGET_OPT_UTF8 /DGET_OPT_NO_SIMD /DGET_OPT_ARGV_NZ get_opt_fuzz.c /Foget_opt_fuzz_u_nz" || exit /b 1
+call :StepOk "get_opt_fuzz_u_nz.exe -r %COUNT% %SEED%" || exit /b 1
+
+echo =============== all tests OK ===============
+exit /b 0
+
+:StepOk
+echo step: %step%
+set /a step+=1
+rem see gawk-windows/test.bat:execq
+set "x=%~1"
+set "x=%x:>=^>%"
+set "x=%x:&=^&%"
+set "x=%x:^^^>=>%"
+set "x=%x:^^^&=&%"
+set "x=%x:^^^^=^%"
+echo %x:""="%
+set "x=%~1"
+set "x=%x:^^&=&%"
+set "x=%x:^^^^=^%"
+%x:""="% && exit /b 0
+echo failed.
+exit /b 1
@@ -0,0 +1,369 @@
+/**********************************************************************************
+* Fuzzing and differential testing of get_opt()
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_fuzz.c */
+
+/* Checks that optimized variants of options lookup - get_opt_indexed() and opt_tokenize() - parse
+  the command line exactly as the reference get_opt(), which scans options tables linearly.
+
+  An input is decoded as follows:
+    bytes up to the first '\0'     - short options format string, dashes are removed,
+    bytes up to the next '\0'      - long options, separated by '\n', '=' before a name - option expects a value,
+    the rest, separated by '\0'    - command line arguments.
+
+  Build with libFuzzer:
+    clang -g -O1 -fsanitize=fuzzer,address -DGET_OPT_FUZZ_LIBFUZZER get_opt_fuzz.c -o get_opt_fuzz
+    ./get_opt_fuzz
+
+  Build for AFL or to check given inputs:
+    afl-gcc get_opt_fuzz.c -o get_opt_fuzz
+    afl-fuzz -i in -o out ./get_opt_fuzz @@
+
+  Or run on random inputs, e.g. 100000 inputs generated from the seed 1:
+    gcc get_opt_fuzz.c -o get_opt_fuzz
+    ./get_opt_fuzz -r 100000 1
+
+  Other variants: -DGET_OPT_ARGV_NZ, -DGET_OPT_WIDE_CHAR_SUPPORT, -DGET_OPT_UTF8, -DGET_OPT_NO_SIMD.
+
+  On a mismatch, the input is printed and the program aborts.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef GET_OPT_WIDE_CHAR_SUPPORT
+#include <wchar.h>
+#endif
+#include "../get_opt.inl"
+
+#define FUZZ_MAX_LONG_OPTS 64
+#define FUZZ_MAX_ARGS      64
+#define FUZZ_MAX_CHARS     4096
+
+/* decoded input */
+struct fuzz_input {
+	GET_OPT_CHAR chars[FUZZ_MAX_CHARS];
+	GET_OPT_CHAR *short_opts;
+	struct long_opt_info long_opts[FUZZ_MAX_LONG_OPTS + 1];
+	GET_OPT_CHAR *argv[FUZZ_MAX_ARGS + 2];
+	int argc;
+};
+
+/* state of parsing after a get_opt() call */
+struct fuzz_step {
+	int ret;
+	long arg0; /* i.arg - argv, before the call */
+	long arg;  /* i.arg - argv */
+	long sopt; /* i.sopt - argv[arg], or -1 */
+	const GET_OPT_CHAR *value;
+};
+
+static const unsigned char *fuzz_data = NULL;
+static size_t fuzz_size = 0;
+
+static void fuzz_fail(const char *const what)
+{
+	size_t k = 0;
+	fprintf(stderr, "mismatch: %s, input (%u bytes):", what, (unsigned)fuzz_size);
+	for (; k < fuzz_size; k++)
+		fprintf(stderr, " %02x", fuzz_data[k]);
+	fprintf(stderr, "\n");
+	abort();
+}
+
+static GET_OPT_CHAR fuzz_char(const unsigned char c)
+{
+#ifdef GET_OPT_WIDE_CHAR_SUPPORT
+	/* also check characters outside of the table of short options */
+	return (GET_OPT_CHAR)(c < 0x80 ? c : c + 0x300);
+#else
+	return (GET_OPT_CHAR)c;
+#endif
+}
+
+/* decode input, returns 0 if the input is too big */
+static int fuzz_decode(struct fuzz_input *const in, const unsigned char *data, const size_t size)
+{
+	const unsigned char *const end = data + size;
+	GET_OPT_CHAR *w = in->chars;
+	GET_OPT_CHAR *const wend = in->chars + FUZZ_MAX_CHARS;
+	unsigned n = 0;
+
+	/* short options */
+	in->short_opts = w;
+	for (; data < end && *data; data++) {
+		if ('-' != *data) {
+			if (w == wend - 1)
+				return 0;
+			*w++ = fuzz_char(*data);
+		}
+	}
+	*w++ = 0;
+	if (data < end)
+		data++;
+
+	/* long options */
+	while (data < end && *data) {
+		GET_OPT_CHAR *const name = w;
+		unsigned len = 0;
+		int bad = 0;
+		for (; data < end && *data && '\n' != *data; data++) {
+			if (w == wend - 1)
+				return 0;
+			if ('=' == *data && w != name)
+				bad = 1; /* '=' is not allowed in the name */
+			*w++ = fuzz_char(*data);
+		}
+		*w++ = 0;
+		if (data < end && '\n' == *data)
+			data++;
+		len = (unsigned)(w - name - 1) - ('=' == *name);
+		if (!bad && len) {
+			if (n == FUZZ_MAX_LONG_OPTS)
+				return 0;
+			in->long_opts[n].len = len;
+			in->long_opts[n].name = name;
+			n++;
+		}
+	}
+	in->long_opts[n].len = 0;
+	in->long_opts[n].name = NULL;
+	if (data < end)
+		data++;
+
+	/* arguments */
+	in->argv[0] = w;
+	*w++ = 0;
+	in->argc = 1;
+	while (data < end) {
+		if (in->argc == FUZZ_MAX_ARGS + 1 || w == wend)
+			return 0;
+		in->argv[in->argc++] = w;
+		for (; data < end && *data; data++) {
+			if (w == wend - 1)
+				return 0;
+			*w++ = fuzz_char(*data);
+		}
+		*w++ = 0;
+		if (data < end)
+			data++;
+	}
+	in->argv[in->argc] = NULL;
+	return 1;
+}
+
+/* check if value is defined after get_opt() returned given code:
+  for parameters and options that may have a value */
+static int fuzz_has_value(const struct fuzz_input *const in, const int ret)
+{
+	if (OPT_PARAMETER == ret)
+		return 1;
+	if (ret < 0)
+		return 0;
+	if (IS_LONG_OPT(ret))
+		return 1;
+	{
+		const GET_OPT_CHAR *const o = &in->short_opts[DECODE_OPT(ret)];
+		const unsigned n = opt_char_len_(o);
+		return opt_char_eq_(o, o + n, n);
+	}
+}
+
+static void fuzz_init(struct opt_info *const i, const struct fuzz_input *const in)
+{
+#ifdef GET_OPT_ARGV_NZ
+	opt_info_init(i, in->argc, in->argv);
+#else
+	opt_info_init(i, in->argv);
+#endif
+}
+
+/* parse the command line via get_opt() or get_opt_indexed(), returns number of steps */
+static unsigned fuzz_parse(
+	const struct fuzz_input *const in,
+	const struct opt_index *const x/*NULL?*/,
+	struct fuzz_step steps[])
+{
+	struct opt_info i;
+	unsigned n = 0;
+	fuzz_init(&i, in);
+	while (!opt_info_is_end(&i)) {
+		struct fuzz_step *const s = &steps[n++];
+		s->arg0 = (long)(i.arg - in->argv);
+		s->ret = x ? get_opt_indexed(&i, x) : get_opt(&i, in->short_opts, in->long_opts);
+		s->arg = (long)(i.arg - in->argv);
+		s->sopt = i.sopt ? (long)(i.sopt - *i.arg) : -1;
+		s->value = OPT_UNKNOWN == s->ret ? NULL : i.value;
+		if (OPT_UNKNOWN == s->ret)
+			opt_skip_unknown(&i);
+		else if (OPT_REST_PARAMS == s->ret)
+			break;
+	}
+	return n;
+}
+
+static void fuzz_compare_tokens(
+	const struct fuzz_input *const in,
+	const struct opt_index *const x/*NULL?*/,
+	const struct fuzz_step steps[],
+	const unsigned nsteps)
+{
+	static struct opt_token tokens[FUZZ_MAX_CHARS + FUZZ_MAX_ARGS];
+	struct opt_info i;
+	unsigned n, k = 0, t = 0;
+	fuzz_init(&i, in);
+	n = opt_tokenize(&i, in->argv, in->short_opts, in->long_opts, x, tokens, sizeof(tokens)/sizeof(tokens[0]));
+	if (!opt_info_is_end(&i))
+		fuzz_fail("opt_tokenize: not all arguments parsed");
+	for (; k < nsteps; k++, t++) {
+		if (t >= n || tokens[t].opt != steps[k].ret || tokens[t].arg != (unsigned)steps[k].arg0)
+			fuzz_fail("opt_tokenize: option");
+		if (fuzz_has_value(in, steps[k].ret) && tokens[t].value != steps[k].value)
+			fuzz_fail("opt_tokenize: value");
+		if (OPT_UNKNOWN == steps[k].ret &&
+			(tokens[t].value ? tokens[t].value - in->argv[tokens[t].arg] : -1) != steps[k].sopt)
+		{
+			fuzz_fail("opt_tokenize: unknown option");
+		}
+	}
+	/* rest parameters */
+	if (nsteps && OPT_REST_PARAMS == steps[nsteps - 1].ret) {
+		int a = (int)steps[nsteps - 1].arg;
+		for (; a < in->argc; a++, t++) {
+			if (t >= n || OPT_PARAMETER != tokens[t].opt || tokens[t].value != in->argv[a] || tokens[t].arg != (unsigned)a)
+				fuzz_fail("opt_tokenize: rest parameter");
+		}
+	}
+	if (t != n)
+		fuzz_fail("opt_tokenize: number of tokens");
+}
+
+static int fuzz_one(const unsigned char *const data, const size_t size)
+{
+	static struct fuzz_input in;
+	static struct fuzz_step ref[FUZZ_MAX_CHARS + FUZZ_MAX_ARGS];
+	static struct fuzz_step opt[FUZZ_MAX_CHARS + FUZZ_MAX_ARGS];
+	static unsigned short long_slots[LONG_OPT_HASH_POW2_(2*FUZZ_MAX_LONG_OPTS)];
+	struct opt_index x;
+	unsigned n, k;
+
+	fuzz_data = data;
+	fuzz_size = size;
+	if (!fuzz_decode(&in, data, size))
+		return 0;
+
+	opt_index_init(&x, in.short_opts, in.long_opts, long_slots, sizeof(long_slots)/sizeof(long_slots[0]));
+
+	n = fuzz_parse(&in, NULL, ref);
+	if (fuzz_parse(&in, &x, opt) != n)
+		fuzz_fail("get_opt_indexed: number of steps");
+	for (k = 0; k < n; k++) {
+		if (ref[k].ret != opt[k].ret || ref[k].arg != opt[k].arg || ref[k].sopt != opt[k].sopt)
+			fuzz_fail("get_opt_indexed: state");
+		if (fuzz_has_value(&in, ref[k].ret) && ref[k].value != opt[k].value)
+			fuzz_fail("get_opt_indexed: value");
+	}
+
+	fuzz_compare_tokens(&in, NULL, ref, n);
+	fuzz_compare_tokens(&in, &x, ref, n);
+	return 0;
+}
+
+#ifdef GET_OPT_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size);
+
+int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size)
+{
+	return fuzz_one(data, size);
+}
+
+#else /* !GET_OPT_FUZZ_LIBFUZZER */
+
+/* xorshift64* */
+static unsigned long long fuzz_rand_state = 1;
+
+static unsigned fuzz_rand(const unsigned n/*>0*/)
+{
+	fuzz_rand_state ^= fuzz_rand_state >> 12;
+	fuzz_rand_state ^= fuzz_rand_state << 25;
+	fuzz_rand_state ^= fuzz_rand_state >> 27;
+	return (unsigned)((fuzz_rand_state*2685821657736338717ull) >> 33) % n;
+}
+
+/* generate random input from a small alphabet, so options often match */
+static size_t fuzz_generate(unsigned char buf[], const size_t max)
+{
+	static const char alphabet[] = "abcdeab-- =\n\xc3\xe9\xa9";
+	size_t n = 0;
+	const unsigned nshort = fuzz_rand(8);
+	const unsigned nlong = fuzz_rand(8);
+	const unsigned nargs = fuzz_rand(12);
+	unsigned k;
+	for (k = 0; k < nshort && n < max; k++)
+		buf[n++] = (unsigned char)alphabet[fuzz_rand(sizeof(alphabet) - 1)];
+	if (n < max)
+		buf[n++] = 0;
+	for (k = 0; k < nlong && n < max; k++) {
+		unsigned len = 1 + fuzz_rand(4);
+		if (fuzz_rand(2) && n < max)
+			buf[n++] = '=';
+		for (; len && n < max; len--)
+			buf[n++] = (unsigned char)"abcde"[fuzz_rand(5)];
+		if (n < max)
+			buf[n++] = '\n';
+	}
+	if (n < max)
+		buf[n++] = 0;
+	for (k = 0; k < nargs && n < max; k++) {
+		unsigned len = fuzz_rand(7);
+		if (fuzz_rand(3) && n < max)
+			buf[n++] = '-';
+		if (fuzz_rand(3) && n < max)
+			buf[n++] = '-';
+		for (; len && n < max; len--)
+			buf[n++] = (unsigned char)alphabet[fuzz_rand(sizeof(alphabet) - 1)];
+		if (k + 1 < nargs && n < max)
+			buf[n++] = 0;
+	}
+	return n;
+}
+
+int main(int argc, char *argv[])
+{
+	static unsigned char buf[FUZZ_MAX_CHARS];
+	if (argc > 2 && !strcmp(argv[1], "-r")) {
+		/* random inputs */
+		const unsigned long count = strtoul(argv[2], NULL, 10);
+		unsigned long k = 0;
+		fuzz_rand_state = argc > 3 ? strtoull(argv[3], NULL, 10) | 1 : 1;
+		for (; k < count; k++)
+			(void)fuzz_one(buf, fuzz_generate(buf, sizeof(buf)));
+		printf("%lu random inputs checked\n", count);
+	}
+	else if (argc > 1) {
+		/* inputs from files */
+		int a = 1;
+		for (; a < argc; a++) {
+			size_t size;
+			FILE *const f = fopen(argv[a], "rb");
+			if (!f) {
+				fprintf(stderr, "failed to open %s\n", argv[a]);
+				return 1;
+			}
+			size = fread(buf, 1, sizeof(buf), f);
+			(void)fclose(f);
+			(void)fuzz_one(buf, size);
+		}
+	}
+	else {
+		/* input from stdin */
+		(void)fuzz_one(buf, fread(buf, 1, sizeof(buf), stdin));
+	}
+	return 0;
+}
+
+#endif /* !GET_OPT_FUZZ_LIBFUZZER */
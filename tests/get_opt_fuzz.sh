@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# differential testing of get_opt() on random inputs,
+# number of inputs and the seed may be specified, e.g.:
+# ./get_opt_fuzz.sh 1000000 12345
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+
+count=${1:-200000}
+seed=${2:-1}
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -O2 -Wall -pedantic -Wextra ./get_opt_fuzz.c -o ./get_opt_fuzz || Exit
+Step && ./get_opt_fuzz -r $count $seed || Exit
+
+Step && $CC -O2 -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_fuzz.c -o ./get_opt_fuzz_nz || Exit
+Step && ./get_opt_fuzz_nz -r $count $seed || Exit
+
+Step && $CC -O2 -DGET_OPT_WIDE_CHAR_SUPPORT -Wall -pedantic -Wextra ./get_opt_fuzz.c -o ./get_opt_fuzz_w || Exit
+Step && ./get_opt_fuzz_w -r $count $seed || Exit
+
+Step && $CC -O2 -DGET_OPT_WIDE_CHAR_SUPPORT -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_fuzz.c -o ./get_opt_fuzz_w_nz || Exit
+Step && ./get_opt_fuzz_w_nz -r $count $seed || Exit
+
+Step && $CC -O2 -DGET_OPT_UTF8 -Wall -pedantic -Wextra ./get_opt_fuzz.c -o ./get_opt_fuzz_u || Exit
+Step && ./get_opt_fuzz_u -r $count $seed || Exit
+
+Step && $CC -O2 -DGET_OPT_UTF8 -DGET_OPT_NO_SIMD -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_fuzz.c -o ./get_opt_fuzz_u_nz || Exit
+Step && ./get_opt_fuzz_u_nz -r $count $seed || Exit
+
+echo "=============== all tests OK ==============="
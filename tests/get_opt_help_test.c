@@ -0,0 +1,129 @@
+/**********************************************************************************
+* Options help text and suggestions test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_help_test.c */
+
+/* compile with
+  gcc get_opt_help_test.c -o get_opt_help_test
+ and run the test:
+  ./get_opt_help_test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../get_opt.inl"
+#include "../get_opt_help.inl"
+#include "test_util.h"
+
+#define SHORT_OPTION_f      SHORT_OPT_MODIFIER_H("ff", "-f FILE", "read input from FILE", SHORT_OPTION_v)
+#define SHORT_OPTION_v      SHORT_OPT_MODIFIER("v", SHORT_OPTION_h)
+#define SHORT_OPTION_h      SHORT_OPT_MODIFIER_H("h", "-h", "print help", SHORT_OPT_NULL)
+
+#define LONG_OPTION_file    LONG_OPT_MODIFIER_H("file", 1, "=FILE", "read input from FILE", LONG_OPTION_level)
+#define LONG_OPTION_level   LONG_OPT_MODIFIER("level", 1, LONG_OPTION_output)
+#define LONG_OPTION_output  LONG_OPT_MODIFIER_H("output", 1, "=FILE", "write output to FILE", LONG_OPTION_verbose)
+#define LONG_OPTION_verbose LONG_OPT_MODIFIER_H("verbose", 0, "", "print more messages", LONG_OPTION_version)
+#define LONG_OPTION_version LONG_OPT_MODIFIER_H("version", 0, "", "print version", LONG_OPT_NULL)
+
+/* 1) options */
+
+#define SHORT_OPT_NULL        GET_OPT_TEXT("")
+#define SHORT_OPT_MODIFIER    SHORT_OPT_DEFINER
+#define SHORT_OPT_MODIFIER_H  SHORT_OPT_DEFINER_H
+
+static const GET_OPT_CHAR short_opts[] = SHORT_OPTION_f;
+
+#define LONG_OPT_NULL         {0, NULL}
+#define LONG_OPT_MODIFIER     LONG_OPT_DEFINER
+#define LONG_OPT_MODIFIER_H   LONG_OPT_DEFINER_H
+
+static const struct long_opt_info long_opts[] = {LONG_OPTION_file};
+
+/* 2) help text */
+
+#undef  SHORT_OPT_NULL
+#undef  SHORT_OPT_MODIFIER
+#undef  SHORT_OPT_MODIFIER_H
+#define SHORT_OPT_NULL        ""
+#define SHORT_OPT_MODIFIER    SHORT_OPT_NO_HELP
+#define SHORT_OPT_MODIFIER_H  SHORT_OPT_HELP
+
+#undef  LONG_OPT_NULL
+#undef  LONG_OPT_MODIFIER
+#undef  LONG_OPT_MODIFIER_H
+#define LONG_OPT_NULL         ""
+#define LONG_OPT_MODIFIER     LONG_OPT_NO_HELP
+#define LONG_OPT_MODIFIER_H   LONG_OPT_HELP
+
+static const char help[] = "usage: prog [options]\n" SHORT_OPTION_f LONG_OPTION_file;
+
+/* 3) encoded options */
+
+#undef  SHORT_OPT_NULL
+#undef  SHORT_OPT_MODIFIER
+#undef  SHORT_OPT_MODIFIER_H
+#define SHORT_OPT_NULL        SHORT_OPT_END_POS(short_opts)
+#define SHORT_OPT_MODIFIER    SHORT_OPT_ENCODER
+#define SHORT_OPT_MODIFIER_H  SHORT_OPT_ENCODER_H
+
+#undef  LONG_OPT_NULL
+#undef  LONG_OPT_MODIFIER
+#undef  LONG_OPT_MODIFIER_H
+#define LONG_OPT_NULL         LONG_OPT_END_IDX(long_opts)
+#define LONG_OPT_MODIFIER     LONG_OPT_ENCODER
+#define LONG_OPT_MODIFIER_H   LONG_OPT_ENCODER_H
+
+static const char expected_help[] =
+	"usage: prog [options]\n"
+	"  -f FILE\n"
+	"        read input from FILE\n"
+	"  -h\n"
+	"        print help\n"
+	"  --file=FILE\n"
+	"        read input from FILE\n"
+	"  --output=FILE\n"
+	"        write output to FILE\n"
+	"  --verbose\n"
+	"        print more messages\n"
+	"  --version\n"
+	"        print version\n";
+
+/* check that option is suggested for given unknown option */
+static int suggests(const GET_OPT_CHAR *arg, unsigned max_dist, int opt)
+{
+	const struct long_opt_info *const lo = opt_suggest(arg, long_opts, max_dist);
+	return opt < 0 ? !lo : lo && LONG_OPT((int)(lo - long_opts)) == opt;
+}
+
+int main(void)
+{
+	CHECK(!strcmp(help, expected_help));
+
+	/* encoded options are the same as without help text */
+	CHECK(SHORT_OPTION_f == SHORT_OPT(0));
+	CHECK(SHORT_OPTION_v == SHORT_OPT(2));
+	CHECK(SHORT_OPTION_h == SHORT_OPT(3));
+	CHECK(LONG_OPTION_file == LONG_OPT(0));
+	CHECK(LONG_OPTION_level == LONG_OPT(1));
+	CHECK(LONG_OPTION_version == LONG_OPT(4));
+	CHECK(!GET_OPT_MEMCMP(short_opts, GET_OPT_TEXT("ffvh"), sizeof(short_opts)));
+
+	CHECK(suggests(GET_OPT_TEXT("--fiel"), 2, LONG_OPTION_file));
+	CHECK(suggests(GET_OPT_TEXT("--fiel=abc"), 2, LONG_OPTION_file));
+	CHECK(suggests(GET_OPT_TEXT("-fil"), 2, LONG_OPTION_file));
+	CHECK(suggests(GET_OPT_TEXT("levle"), 1, LONG_OPTION_level));
+	CHECK(suggests(GET_OPT_TEXT("--outptu"), 1, LONG_OPTION_output));
+	CHECK(suggests(GET_OPT_TEXT("--verbos"), 2, LONG_OPTION_verbose));
+	CHECK(suggests(GET_OPT_TEXT("--versio"), 2, LONG_OPTION_version));
+	CHECK(suggests(GET_OPT_TEXT("--versian"), 2, LONG_OPTION_version));
+	CHECK(suggests(GET_OPT_TEXT("--version"), 0, LONG_OPTION_version));
+	CHECK(suggests(GET_OPT_TEXT("--xyz"), 2, -1));
+	CHECK(suggests(GET_OPT_TEXT("--lvl"), 1, -1));
+	CHECK(suggests(GET_OPT_TEXT("--"), 2, -1));
+	CHECK(suggests(GET_OPT_TEXT("--=x"), 2, -1));
+
+	return test_result();
+}
@@ -0,0 +1,25 @@
+#!/bin/bash
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./get_opt_help_test.c -o ./get_opt_help_test || Exit
+Step && ./get_opt_help_test || Exit
+
+Step && $CXX -Wall -pedantic -Wextra -x c++ ./get_opt_help_test.c -o ./get_opt_help_test_cxx || Exit
+Step && ./get_opt_help_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
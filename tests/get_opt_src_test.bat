@@ -0,0 +1,58 @@
+@echo off
+setlocal
+set step=0
+
+rem 4464: relative include path contains '..'
+rem 4820: '...' bytes padding added after data member '...'
+set "WARN=/Wall /wd4464 /wd4820"
+
+set "ARGS=get_opt_src_test.conf --level=3 -v --bad param -- -x"
+
+call :StepOk "cl /nologo /TC %WARN% get_opt_test.c /Foget_opt_test" || exit /b 1
+call :StepOk "get_opt_test.exe %TEST% > get_opt.out" || exit /b 1
+call :StepOk "fc get_opt.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_ARGV_NZ get_opt_test.c /Foget_opt_test_nz" || exit /b 1
+call :StepOk "get_opt_test_nz.exe %TEST% > get_opt_nz.out" || exit /b 1
+call :StepOk "fc get_opt_nz.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_INDEXED get_opt_test.c /Foget_opt_test_idx" || exit /b 1
+call :StepOk "get_opt_test_idx.exe %TEST% > get_opt_idx.out" || exit /b 1
+call :StepOk "fc get_opt_idx.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_INDEXED /DGET_OPT_ARGV_NZ get_opt_test.c /Foget_opt_test_idx_nz" || exit /b 1
+call :StepOk "get_opt_test_idx_nz.exe %TEST% > get_opt_idx_nz.out" || exit /b 1
+call :StepOk "fc get_opt_idx_nz.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_RSP get_opt_test.c /Foget_opt_test_rsp" || exit /b 1
+call :StepOk "get_opt_test_rsp.exe @get_opt_test.rsp > get_opt_rsp.out" || exit /b 1
+call :StepOk "fc get_opt_rsp.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_TOKENS get_opt_test.c /Foget_opt_test_tok" || exit /b 1
+call :StepOk "get_opt_test_tok.exe %TEST% > get_opt_tok.out" || exit /b 1
+call :StepOk "fc get_opt_tok.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_TOKENS /DGET_OPT_TEST_INDEXED /DGET_OPT_ARGV_NZ get_opt_test.c /Foget_opt_test_tok_idx_nz" || exit /b 1
+call :StepOk "get_opt_test_tok_idx_nz.exe %TEST% > get_opt_tok_idx_nz.out" || exit /b 1
+call :StepOk "fc get_opt_tok_idx_nz.out get_opt_test.out" || exit /b 1
+
+echo =============== all tests OK ===============
+exit /b 0
+
+:StepOk
+echo step: %step%
+set /a step+=1
+rem see gawk-windows/test.bat:execq
+set "x=%~1"
+set "x=%x:>=^>%"
+set "x=%x:&=^&%"
+set "x=%x:^^^>=>%"
+set "x=%x:^^^&=&%"
+set "x=%x:^^^^=^%"
+echo %x:""="%
+set "x=%~1"
+set "x=%x:^^&=&%"
+set "x=%x:^^^^=^%"
+%x:""="% && exit /b 0
+echo failed.
+exit /b 1
@@ -0,0 +1,160 @@
+/**********************************************************************************
+* Options from environment and configuration file test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_src_test.c */
+
+/* compile with
+  gcc get_opt_src_test.c -o get_opt_src_test
+ or, to look up options via the index
+  gcc -DGET_OPT_TEST_INDEXED get_opt_src_test.c -o get_opt_src_test
+
+ and run the test:
+  ./get_opt_src_test get_opt_src_test.conf --level=3 -v param
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../asserts.h"
+#include "../get_opt.inl"
+#include "../get_opt_rsp.inl"
+#include "../get_opt_src.inl"
+
+int main(int argc, char *argv[])
+{
+#define SHORT_OPTION_v      SHORT_OPT_MODIFIER("v", SHORT_OPT_NULL)
+
+#define SHORT_OPT_NULL      GET_OPT_TEXT("")
+#define SHORT_OPT_MODIFIER  SHORT_OPT_DEFINER
+
+	static const GET_OPT_CHAR short_opts[] = SHORT_OPTION_v;
+
+#define LONG_OPTION_file      LONG_OPT_MODIFIER("file",      1, LONG_OPTION_level)
+#define LONG_OPTION_level     LONG_OPT_MODIFIER("level",     1, LONG_OPTION_debug)
+#define LONG_OPTION_debug     LONG_OPT_MODIFIER("debug",     1, LONG_OPTION_output)
+#define LONG_OPTION_output    LONG_OPT_MODIFIER("output",    1, LONG_OPTION_log_level)
+#define LONG_OPTION_log_level LONG_OPT_MODIFIER("log-level", 1, LONG_OPTION_verbose)
+#define LONG_OPTION_verbose   LONG_OPT_MODIFIER("verbose",   0, LONG_OPT_NULL)
+
+#define LONG_OPT_NULL       {0,NULL}
+#define LONG_OPT_MODIFIER   LONG_OPT_DEFINER
+
+	static const struct long_opt_info long_opts[] = {LONG_OPTION_file};
+
+#undef  SHORT_OPT_NULL
+#undef  SHORT_OPT_MODIFIER
+
+#define SHORT_OPT_NULL      SHORT_OPT_END_POS(short_opts)
+#define SHORT_OPT_MODIFIER  SHORT_OPT_ENCODER
+
+#undef  LONG_OPT_NULL
+#undef  LONG_OPT_MODIFIER
+
+#define LONG_OPT_NULL       LONG_OPT_END_IDX(long_opts)
+#define LONG_OPT_MODIFIER   LONG_OPT_ENCODER
+
+	static GET_OPT_CHAR *envp[] = {
+		GET_OPT_TEXT("PATH=/bin"),
+		GET_OPT_TEXT("TEST_LEVEL=2"),
+		GET_OPT_TEXT("TEST_LOG_LEVEL=warn"),
+		GET_OPT_TEXT("TEST_VERBOSE"),
+		GET_OPT_TEXT("TEST_UNKNOWN=1"),
+		GET_OPT_TEXT("TEST_=empty"),
+		GET_OPT_TEXT("TEST_LEVEL_WITH_VERY_LONG_NAME_EXCEEDING_THE_LIMIT_OF_SIXTY_FOUR_CHARACTERS=3"),
+		GET_OPT_TEXT("TESTLEVEL=4"),
+		NULL
+	};
+
+	static const char *const sources[] = {"argv", "conf", "env"};
+
+#ifdef GET_OPT_TEST_INDEXED
+	static unsigned short long_slots[LONG_OPT_HASH_SIZE(long_opts)];
+	struct opt_index x;
+	const struct opt_index *const px = &x;
+#else
+	const struct opt_index *const px = NULL;
+#endif
+
+	struct opt_token tokens[32];
+	struct opt_rsp_file conf;
+	struct opt_info i;
+	const char *level = "<default>";
+	unsigned n = 0, k;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <conf> [options]\n", argv[0]);
+		return 1;
+	}
+
+#ifdef GET_OPT_TEST_INDEXED
+	opt_index_init(&x, short_opts, long_opts, long_slots, sizeof(long_slots)/sizeof(long_slots[0]));
+#endif
+
+	if (opt_conf_load(&conf, argv[1])) {
+		fprintf(stderr, "failed to load %s\n", argv[1]);
+		return 1;
+	}
+
+	/* precedence: configuration file < environment < command line */
+	n += opt_conf_tokenize(&conf, long_opts, px, tokens, 32);
+	ASSERT(n <= 32);
+	n += opt_env_tokenize(envp, GET_OPT_TEXT("TEST_"), long_opts, px, tokens + n, 32 - n);
+	ASSERT(n <= 32);
+#ifdef GET_OPT_ARGV_NZ
+	opt_info_init(&i, argc - 1, argv + 1);
+#else
+	opt_info_init(&i, argv + 1);
+#endif
+	n += opt_tokenize(&i, argv + 1, short_opts, long_opts, px, tokens + n, 32 - n);
+	ASSERT(n <= 32);
+
+	/* tokenizing again gives the same result */
+	if (opt_conf_tokenize(&conf, long_opts, px, tokens, 32) != conf.count) {
+		fprintf(stderr, "assert!\n");
+		return 1;
+	}
+
+	for (k = 0; k < n; k++) {
+		const struct opt_token *const t = &tokens[k];
+		const char *const source = sources[OPT_TOKEN_SOURCE(t->arg) >> 30];
+		const char *const value = t->value ? t->value : "<null>";
+		switch (t->opt) {
+			case SHORT_OPTION_v:
+			case LONG_OPTION_verbose:
+				printf("%s: verbose\n", source);
+				break;
+			case LONG_OPTION_file:
+				printf("%s: file:%s\n", source, value);
+				break;
+			case LONG_OPTION_level:
+				printf("%s: level:%s\n", source, value);
+				level = value;
+				break;
+			case LONG_OPTION_debug:
+				printf("%s: debug:%s\n", source, value);
+				break;
+			case LONG_OPTION_output:
+				printf("%s: output:%s\n", source, value);
+				break;
+			case LONG_OPTION_log_level:
+				printf("%s: log-level:%s\n", source, value);
+				break;
+			case OPT_UNKNOWN:
+				printf("%s: unknown #%u: '%s'\n", source, OPT_TOKEN_INDEX(t->arg), value);
+				break;
+			case OPT_PARAMETER:
+				printf("%s: parameter: %s\n", source, value);
+				break;
+			case OPT_REST_PARAMS:
+				break;
+			default:
+				fprintf(stderr, "assert!\n");
+				return 1;
+		}
+	}
+	printf("level = %s\n", level);
+	opt_conf_free(&conf);
+	return 0;
+}
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+args='get_opt_src_test.conf --level=3 -v --bad param -- -x'
+
+Step && $CC -Wall -pedantic -Wextra ./get_opt_src_test.c -o ./get_opt_src_test || Exit
+Step && ./get_opt_src_test $args > get_opt_src.out || Exit
+Step && diff ./get_opt_src.out ./get_opt_src_test.out || Exit
+
+Step && $CC -DGET_OPT_TEST_INDEXED -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_src_test.c -o ./get_opt_src_test_idx_nz || Exit
+Step && ./get_opt_src_test_idx_nz $args > get_opt_src_idx_nz.out || Exit
+Step && diff ./get_opt_src_idx_nz.out ./get_opt_src_test.out || Exit
+
+echo "=============== all tests OK ==============="
@@ -16,6 +16,26 @@ call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_ARGV_NZ get_opt_test.c /Foget_opt_
 call :StepOk "get_opt_test_nz.exe %TEST% > get_opt_nz.out" || exit /b 1
 call :StepOk "fc get_opt_nz.out get_opt_test.out" || exit /b 1
 
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_INDEXED get_opt_test.c /Foget_opt_test_idx" || exit /b 1
+call :StepOk "get_opt_test_idx.exe %TEST% > get_opt_idx.out" || exit /b 1
+call :StepOk "fc get_opt_idx.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_INDEXED /DGET_OPT_ARGV_NZ get_opt_test.c /Foget_opt_test_idx_nz" || exit /b 1
+call :StepOk "get_opt_test_idx_nz.exe %TEST% > get_opt_idx_nz.out" || exit /b 1
+call :StepOk "fc get_opt_idx_nz.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_RSP get_opt_test.c /Foget_opt_test_rsp" || exit /b 1
+call :StepOk "get_opt_test_rsp.exe @get_opt_test.rsp > get_opt_rsp.out" || exit /b 1
+call :StepOk "fc get_opt_rsp.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_TOKENS get_opt_test.c /Foget_opt_test_tok" || exit /b 1
+call :StepOk "get_opt_test_tok.exe %TEST% > get_opt_tok.out" || exit /b 1
+call :StepOk "fc get_opt_tok.out get_opt_test.out" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_TEST_TOKENS /DGET_OPT_TEST_INDEXED /DGET_OPT_ARGV_NZ get_opt_test.c /Foget_opt_test_tok_idx_nz" || exit /b 1
+call :StepOk "get_opt_test_tok_idx_nz.exe %TEST% > get_opt_tok_idx_nz.out" || exit /b 1
+call :StepOk "fc get_opt_tok_idx_nz.out get_opt_test.out" || exit /b 1
+
 echo =============== all tests OK ===============
 exit /b 0
 
@@ -10,16 +10,27 @@
   gcc get_opt_test.c -o get_opt_test
  or
   gcc -DGET_OPT_ARGV_NZ get_opt_test.c -o get_opt_test
+ or, to test get_opt_indexed()
+  gcc -DGET_OPT_TEST_INDEXED get_opt_test.c -o get_opt_test
+ or, to test expansion of response files
+  gcc -DGET_OPT_TEST_RSP get_opt_test.c -o get_opt_test
+ or, to test opt_tokenize()
+  gcc -DGET_OPT_TEST_TOKENS get_opt_test.c -o get_opt_test
 
  and run the test:
   ./get_opt_test --help 3 --file 2 -b3 --level=4 -l 5 -d6 --debug 7 -o 8 -vr --output=9 -fg -f g\
     --verbose 1 --verbose=4 -g 3 -g1 -9 - --trace --trace q --trace=v -t -tra -trace -h 6 -ogv- -- 4 -b --y 9
+ or, with response file:
+  ./get_opt_test @get_opt_test.rsp
 */
 
 #include <stdio.h>
 #include <string.h>
 #include "../asserts.h"
 #include "../get_opt.inl"
+#ifdef GET_OPT_TEST_RSP
+#include "../get_opt_rsp.inl"
+#endif
 
 int main(int argc, char *argv[])
 {
@@ -71,7 +82,29 @@ int main(int argc, char *argv[])
 #define LONG_OPT_NULL       LONG_OPT_END_IDX(long_opts)
 #define LONG_OPT_MODIFIER   LONG_OPT_ENCODER
 
+#ifdef GET_OPT_TEST_INDEXED
+	static unsigned short long_slots[LONG_OPT_HASH_SIZE(long_opts)];
+	struct opt_index x;
+#endif
+
 	struct opt_info i;
+#ifdef GET_OPT_TEST_TOKENS
+	struct opt_token tokens[128];
+	unsigned n, k;
+#endif
+#ifdef GET_OPT_TEST_RSP
+	struct opt_rsp r;
+	int bad_arg;
+	if (opt_rsp_expand(&r, argc, argv, &bad_arg)) {
+		fprintf(stderr, "failed to read response file: %s\n", argv[bad_arg]);
+		return 1;
+	}
+	argc = r.argc;
+	argv = r.argv;
+#endif
+#ifdef GET_OPT_TEST_INDEXED
+	opt_index_init(&x, short_opts, long_opts, long_slots, sizeof(long_slots)/sizeof(long_slots[0]));
+#endif
 #ifdef GET_OPT_ARGV_NZ
 	fputs("nz\n", stderr);
 	opt_info_init(&i, argc, argv);
@@ -81,8 +114,30 @@ int main(int argc, char *argv[])
 	(void)argc;
 #endif
 
+#ifdef GET_OPT_TEST_TOKENS
+#ifdef GET_OPT_TEST_INDEXED
+	n = opt_tokenize(&i, argv, NULL, NULL, &x, tokens, sizeof(tokens)/sizeof(tokens[0]));
+#else
+	n = opt_tokenize(&i, argv, short_opts, long_opts, NULL, tokens, sizeof(tokens)/sizeof(tokens[0]));
+#endif
+	if (n > sizeof(tokens)/sizeof(tokens[0])) {
+		fprintf(stderr, "too many tokens: %u\n", n);
+		return 1;
+	}
+	for (k = 0; k < n; k++) {
+		/* set parsing state as it would be after get_opt() */
+		i.arg = &argv[tokens[k].arg];
+		i.value = tokens[k].value;
+		i.sopt = OPT_UNKNOWN == tokens[k].opt ? tokens[k].value : NULL;
+		switch (tokens[k].opt) {
+#else
 	while (!opt_info_is_end(&i)) {
+#ifdef GET_OPT_TEST_INDEXED
+		switch (get_opt_indexed(&i, &x)) {
+#else
 		switch (get_opt(&i, short_opts, long_opts)) {
+#endif
+#endif
 			case SHORT_OPTION_a:
 				printf("a:%s\n", i.value ? i.value : "<null>");
 				break;
@@ -133,13 +188,19 @@ int main(int argc, char *argv[])
 				printf("parameter: %s\n", i.value);
 				break;
 			case OPT_REST_PARAMS:
+#ifndef GET_OPT_TEST_TOKENS
+				/* else - rest parameters follow as OPT_PARAMETER tokens */
 				for (; !opt_info_is_end(&i); i.arg++)
 					printf("parameter: %s\n", *i.arg);
+#endif
 				break;
 			default:
 				fprintf(stderr, "assert!\n");
 				return 1;
 		}
 	}
+#ifdef GET_OPT_TEST_RSP
+	opt_rsp_free(&r);
+#endif
 	return 0;
 }
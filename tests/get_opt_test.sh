@@ -30,4 +30,24 @@ Step && $CC -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_test.c -o ./get_
 Step && ./get_opt_test_nz "$test1" $test2 > get_opt_nz.out || Exit
 Step && diff ./get_opt_nz.out ./get_opt_test.out || Exit
 
+Step && $CC -DGET_OPT_TEST_INDEXED -Wall -pedantic -Wextra ./get_opt_test.c -o ./get_opt_test_idx || Exit
+Step && ./get_opt_test_idx "$test1" $test2 > get_opt_idx.out || Exit
+Step && diff ./get_opt_idx.out ./get_opt_test.out || Exit
+
+Step && $CC -DGET_OPT_TEST_INDEXED -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_test.c -o ./get_opt_test_idx_nz || Exit
+Step && ./get_opt_test_idx_nz "$test1" $test2 > get_opt_idx_nz.out || Exit
+Step && diff ./get_opt_idx_nz.out ./get_opt_test.out || Exit
+
+Step && $CC -DGET_OPT_TEST_RSP -Wall -pedantic -Wextra ./get_opt_test.c -o ./get_opt_test_rsp || Exit
+Step && ./get_opt_test_rsp @get_opt_test.rsp > get_opt_rsp.out || Exit
+Step && diff ./get_opt_rsp.out ./get_opt_test.out || Exit
+
+Step && $CC -DGET_OPT_TEST_TOKENS -Wall -pedantic -Wextra ./get_opt_test.c -o ./get_opt_test_tok || Exit
+Step && ./get_opt_test_tok "$test1" $test2 > get_opt_tok.out || Exit
+Step && diff ./get_opt_tok.out ./get_opt_test.out || Exit
+
+Step && $CC -DGET_OPT_TEST_TOKENS -DGET_OPT_TEST_INDEXED -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_test.c -o ./get_opt_test_tok_idx_nz || Exit
+Step && ./get_opt_test_tok_idx_nz "$test1" $test2 > get_opt_tok_idx_nz.out || Exit
+Step && diff ./get_opt_tok_idx_nz.out ./get_opt_test.out || Exit
+
 echo "=============== all tests OK ==============="
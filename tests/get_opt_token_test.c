@@ -0,0 +1,182 @@
+/**********************************************************************************
+* Delegation of unknown option tokens test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_token_test.c */
+
+/* compile with
+  gcc get_opt_token_test.c -o get_opt_token_test
+ or
+  gcc -DGET_OPT_ARGV_NZ get_opt_token_test.c -o get_opt_token_test
+ or
+  gcc -DGET_OPT_UTF8 get_opt_token_test.c -o get_opt_token_test
+ and run the test:
+  ./get_opt_token_test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../get_opt.inl"
+#include "test_util.h"
+
+/* options of the main program: "-v", "-o value", "--verbose", "--output=value" */
+#define MAIN_v          SHORT_OPT_MODIFIER("v", MAIN_o)
+#define MAIN_o          SHORT_OPT_MODIFIER("oo", MAIN_SHORT_NULL)
+#define MAIN_verbose    LONG_OPT_MODIFIER("verbose", 0, MAIN_output)
+#define MAIN_output     LONG_OPT_MODIFIER("output", 1, MAIN_LONG_NULL)
+
+/* options of a module, unknown to the main program: "-x value", "-y", "--foo=value", "--bar" */
+#define MOD_x           SHORT_OPT_MODIFIER("xx", MOD_y)
+#define MOD_y           SHORT_OPT_MODIFIER("y", MOD_SHORT_NULL)
+#define MOD_foo         LONG_OPT_MODIFIER("foo", 1, MOD_bar)
+#define MOD_bar         LONG_OPT_MODIFIER("bar", 0, MOD_LONG_NULL)
+
+#define MAIN_SHORT_NULL     GET_OPT_TEXT("")
+#define MOD_SHORT_NULL      GET_OPT_TEXT("")
+#define SHORT_OPT_MODIFIER  SHORT_OPT_DEFINER
+#define MAIN_LONG_NULL      {0,NULL}
+#define MOD_LONG_NULL       {0,NULL}
+#define LONG_OPT_MODIFIER   LONG_OPT_DEFINER
+
+static const GET_OPT_CHAR main_short_opts[] = MAIN_v;
+static const struct long_opt_info main_long_opts[] = {MAIN_verbose};
+static const GET_OPT_CHAR mod_short_opts[] = MOD_x;
+static const struct long_opt_info mod_long_opts[] = {MOD_foo};
+
+#undef  MAIN_SHORT_NULL
+#undef  MOD_SHORT_NULL
+#undef  SHORT_OPT_MODIFIER
+#undef  MAIN_LONG_NULL
+#undef  MOD_LONG_NULL
+#undef  LONG_OPT_MODIFIER
+#define MAIN_SHORT_NULL     SHORT_OPT_END_POS(main_short_opts)
+#define MOD_SHORT_NULL      SHORT_OPT_END_POS(mod_short_opts)
+#define SHORT_OPT_MODIFIER  SHORT_OPT_ENCODER
+#define MAIN_LONG_NULL      LONG_OPT_END_IDX(main_long_opts)
+#define MOD_LONG_NULL       LONG_OPT_END_IDX(mod_long_opts)
+#define LONG_OPT_MODIFIER   LONG_OPT_ENCODER
+
+static char result[256];
+
+static void append(const char *s)
+{
+	const size_t n = strlen(result);
+	if (n + strlen(s) < sizeof(result))
+		strcpy(result + n, s);
+}
+
+/* re-parse an unknown option by the module, returns 0 if the option is unknown to the module too */
+static int module_option(struct opt_info *i)
+{
+	switch (get_opt(i, mod_short_opts, mod_long_opts)) {
+		case MOD_x:
+			append(" mod:x:");
+			append(i->value ? i->value : "<null>");
+			return 1;
+		case MOD_y:
+			append(" mod:y");
+			return 1;
+		case MOD_foo:
+			append(" mod:foo:");
+			append(i->value ? i->value : "<null>");
+			return 1;
+		case MOD_bar:
+			append(" mod:bar");
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+/* tokenize the command line, via the index if x != NULL, delegate unknown options to the module,
+  results are appended to the result string */
+static const char *run(const struct opt_index *x/*NULL?*/, GET_OPT_CHAR *argv[])
+{
+	struct opt_token tokens[32];
+	struct opt_info i;
+	unsigned n, k;
+	int argc = 0;
+	while (argv[argc])
+		argc++;
+#ifdef GET_OPT_ARGV_NZ
+	opt_info_init(&i, argc, argv);
+#else
+	opt_info_init(&i, argv);
+	(void)argc;
+#endif
+	result[0] = '\0';
+	n = opt_tokenize(&i, argv, main_short_opts, main_long_opts, x, tokens, sizeof(tokens)/sizeof(tokens[0]));
+	if (n > sizeof(tokens)/sizeof(tokens[0]))
+		return "too many tokens";
+	for (k = 0; k < n;) {
+		const struct opt_token *const t = &tokens[k];
+		switch (t->opt) {
+			case MAIN_v:
+			case MAIN_verbose:
+				append(" v");
+				break;
+			case MAIN_o:
+			case MAIN_output:
+				append(" o:");
+				append(t->value ? t->value : "<null>");
+				break;
+			case OPT_PARAMETER:
+				append(" param:");
+				append(t->value);
+				break;
+			case OPT_REST_PARAMS:
+				append(" --");
+				break;
+			case OPT_UNKNOWN:
+				opt_token_reparse(&i, argv, t);
+				if (!module_option(&i)) {
+					append(" unknown:");
+					append(t->value ? t->value : argv[t->arg]);
+				}
+				k = opt_token_resume(&i, argv, tokens, n, k);
+				continue;
+			default:
+				append(" ?");
+				return result;
+		}
+		k++;
+	}
+	return result + (' ' == result[0]);
+}
+
+int main(void)
+{
+	static unsigned short long_slots[LONG_OPT_HASH_SIZE(main_long_opts)];
+	/* the module consumes a separate value */
+	static GET_OPT_CHAR *argv1[] = {"prog", "-v", "--foo", "val", "-x", "sep", "-o", "out", NULL};
+	/* the module consumes the rest of the bundle */
+	static GET_OPT_CHAR *argv2[] = {"prog", "-vxVALUE", "-vxVAL", "VAL", "--verbose", NULL};
+	/* the module stops in the middle of the bundle */
+	static GET_OPT_CHAR *argv3[] = {"prog", "-vyv", "-vyyv", "-v\xd0\xb6yv", NULL};
+	/* the module does not consume anything extra */
+	static GET_OPT_CHAR *argv4[] = {"prog", "--foo=x", "val", "-x", "-v", "--bar", "--", "-y", NULL};
+	/* options unknown to the module too */
+	static GET_OPT_CHAR *argv5[] = {"prog", "--unknown", "p", "-vq", "-q", "--output", "o", NULL};
+	struct opt_index x;
+	unsigned k;
+
+	opt_index_init(&x, main_short_opts, main_long_opts, long_slots, sizeof(long_slots)/sizeof(long_slots[0]));
+
+	for (k = 0; k < 2; k++) {
+		const struct opt_index *const px = k ? &x : NULL;
+		CHECK(!strcmp(run(px, argv1), "v mod:foo:val mod:x:sep o:out"));
+		CHECK(!strcmp(run(px, argv2), "v mod:x:VALUE v mod:x:VAL param:VAL v"));
+#ifdef GET_OPT_UTF8
+		CHECK(!strcmp(run(px, argv3), "v mod:y v v mod:y mod:y v v unknown:\xd0\xb6yv mod:y v"));
+#else
+		/* each byte of a multi-byte character is a separate option */
+		CHECK(!strcmp(run(px, argv3), "v mod:y v v mod:y mod:y v v unknown:\xd0\xb6yv unknown:\xb6yv mod:y v"));
+#endif
+		CHECK(!strcmp(run(px, argv4), "mod:foo:x param:val mod:x:<null> v mod:bar -- param:-y"));
+		CHECK(!strcmp(run(px, argv5), "unknown:--unknown param:p v unknown:q unknown:-q o:o"));
+	}
+
+	return test_result();
+}
@@ -0,0 +1,37 @@
+@echo off
+setlocal
+set step=0
+
+rem 4464: relative include path contains '..'
+rem 4820: '...' bytes padding added after data member '...'
+set "WARN=/Wall /wd4464 /wd4820"
+
+call :StepOk "cl /nologo /TC %WARN% get_opt_utf8_test.c /Foget_opt_utf8_test" || exit /b 1
+call :StepOk "get_opt_utf8_test.exe" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_NO_SIMD get_opt_utf8_test.c /Foget_opt_utf8_test_nosimd" || exit /b 1
+call :StepOk "get_opt_utf8_test_nosimd.exe" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DGET_OPT_ARGV_NZ get_opt_utf8_test.c /Foget_opt_utf8_test_nz" || exit /b 1
+call :StepOk "get_opt_utf8_test_nz.exe" || exit /b 1
+
+echo =============== all tests OK ===============
+exit /b 0
+
+:StepOk
+echo step: %step%
+set /a step+=1
+rem see gawk-windows/test.bat:execq
+set "x=%~1"
+set "x=%x:>=^>%"
+set "x=%x:&=^&%"
+set "x=%x:^^^>=>%"
+set "x=%x:^^^&=&%"
+set "x=%x:^^^^=^%"
+echo %x:""="%
+set "x=%~1"
+set "x=%x:^^&=&%"
+set "x=%x:^^^^=^%"
+%x:""="% && exit /b 0
+echo failed.
+exit /b 1
@@ -0,0 +1,179 @@
+/**********************************************************************************
+* UTF-8 options parsing test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_utf8_test.c */
+
+/* compile with
+  gcc get_opt_utf8_test.c -o get_opt_utf8_test
+ or
+  gcc -DGET_OPT_NO_SIMD get_opt_utf8_test.c -o get_opt_utf8_test
+ or
+  gcc -DGET_OPT_ARGV_NZ get_opt_utf8_test.c -o get_opt_utf8_test
+ and run the test:
+  ./get_opt_utf8_test
+*/
+
+#define GET_OPT_UTF8
+
+#include <stdio.h>
+#include <string.h>
+#include "../get_opt.inl"
+#include "test_util.h"
+
+/* "-\xc3\xa9" (e acute) expects a value, "-\xd0\xb6" (cyrillic zhe) and "-x" - not,
+  "-\xe2\x82\xac" (euro sign) - the first letter of long option started with one dash */
+#define SHORT_e_acute   SHORT_OPT_MODIFIER("\xc3\xa9\xc3\xa9", SHORT_x)
+#define SHORT_x         SHORT_OPT_MODIFIER("x", SHORT_zhe)
+#define SHORT_zhe       SHORT_OPT_MODIFIER("\xd0\xb6", SHORT_euro)
+#define SHORT_euro      SHORT_OPT_MODIFIER("\xe2\x82\xac ", SHORT_OPT_NULL)
+
+/* "--gr\xc3\xb6\xc3\x9f" ("size" in german) */
+#define LONG_size       LONG_OPT_MODIFIER("gr\xc3\xb6\xc3\x9f" "e", 1, LONG_euro)
+#define LONG_euro       LONG_OPT_MODIFIER("\xe2\x82\xac" "uro", 1, LONG_verbose)
+#define LONG_verbose    LONG_OPT_MODIFIER("verbose", 0, LONG_OPT_NULL)
+
+#define SHORT_OPT_NULL      GET_OPT_TEXT("")
+#define SHORT_OPT_MODIFIER  SHORT_OPT_DEFINER
+#define LONG_OPT_NULL       {0,NULL}
+#define LONG_OPT_MODIFIER   LONG_OPT_DEFINER
+
+static const GET_OPT_CHAR short_opts[] = SHORT_e_acute;
+static const struct long_opt_info long_opts[] = {LONG_size};
+
+#undef  SHORT_OPT_NULL
+#undef  SHORT_OPT_MODIFIER
+#undef  LONG_OPT_NULL
+#undef  LONG_OPT_MODIFIER
+#define SHORT_OPT_NULL      SHORT_OPT_END_POS(short_opts)
+#define SHORT_OPT_MODIFIER  SHORT_OPT_ENCODER
+#define LONG_OPT_NULL       LONG_OPT_END_IDX(long_opts)
+#define LONG_OPT_MODIFIER   LONG_OPT_ENCODER
+
+static char result[256];
+
+static void append(const char *s)
+{
+	const size_t n = strlen(result);
+	if (n + strlen(s) < sizeof(result))
+		strcpy(result + n, s);
+}
+
+/* parse the command line, via the index if x != NULL, results are appended to the result string */
+static const char *run(const struct opt_index *x/*NULL?*/, GET_OPT_CHAR *argv[])
+{
+	struct opt_info i;
+	int argc = 0;
+	while (argv[argc])
+		argc++;
+#ifdef GET_OPT_ARGV_NZ
+	opt_info_init(&i, argc, argv);
+#else
+	opt_info_init(&i, argv);
+	(void)argc;
+#endif
+	result[0] = '\0';
+	while (!opt_info_is_end(&i)) {
+		switch (x ? get_opt_indexed(&i, x) : get_opt(&i, short_opts, long_opts)) {
+			case SHORT_e_acute:
+				append(" e:");
+				append(i.value ? i.value : "<null>");
+				break;
+			case SHORT_x:
+				append(" x");
+				break;
+			case SHORT_zhe:
+				append(" zhe");
+				break;
+			case SHORT_euro:
+				append(" <euro>");
+				break;
+			case LONG_size:
+				append(" size:");
+				append(i.value ? i.value : "<null>");
+				break;
+			case LONG_euro:
+				append(" euro:");
+				append(i.value ? i.value : "<null>");
+				break;
+			case LONG_verbose:
+				append(" verbose");
+				break;
+			case OPT_PARAMETER:
+				append(" param:");
+				append(i.value);
+				break;
+			case OPT_UNKNOWN:
+				append(" unknown:");
+				append(i.sopt ? i.sopt : *i.arg);
+				opt_skip_unknown(&i);
+				break;
+			default:
+				append(" ?");
+				return result;
+		}
+	}
+	return result + (' ' == result[0]);
+}
+
+/* check the end of long option name at different alignments and lengths - for the SIMD scan */
+static void check_long_end(void)
+{
+	union {
+		char buf[128];
+		double align;
+	} u;
+	unsigned off, len;
+	for (off = 0; off < 32; off++) {
+		for (len = 0; len < 64; len++) {
+			memset(u.buf, 'a', sizeof(u.buf));
+			u.buf[off + len] = '\0';
+			CHECK(opt_long_end_(u.buf + off) == u.buf + off + len);
+			u.buf[off + len] = '=';
+			u.buf[off + len + 1] = '\0';
+			CHECK(opt_long_end_(u.buf + off) == u.buf + off + len);
+			/* a '=' or '\0' before the name is ignored */
+			if (off) {
+				u.buf[off - 1] = '\0';
+				CHECK(opt_long_end_(u.buf + off) == u.buf + off + len);
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	static unsigned short long_slots[LONG_OPT_HASH_SIZE(long_opts)];
+	static GET_OPT_CHAR *argv1[] = {"prog", "-\xc3\xa9" "abc", "-\xc3\xa9", "v", "-x\xd0\xb6x", "-x\xc3\xa9" "val", NULL};
+	static GET_OPT_CHAR *argv2[] = {"prog", "--gr\xc3\xb6\xc3\x9f" "e=10", "-\xe2\x82\xac" "uro=5", "--verbose", "p", NULL};
+	static GET_OPT_CHAR *argv3[] = {"prog", "-\xc3\xa8", "-x\xc3\xa8\xd0\xb6", "-\xa9", "-x\xc3", NULL};
+	static GET_OPT_CHAR *argv4[] = {"prog", "-x\xe2\x82\xac" "uro=1", "--gr\xc3\xb6\xc3\x9f", "--verbose-and-a-very-long-name=1", NULL};
+	static GET_OPT_CHAR *argv5[] = {"prog", "-\xd0", "-\xe2\x82", "-\xc3\xa9", NULL};
+	struct opt_index x;
+	unsigned k;
+
+	opt_index_init(&x, short_opts, long_opts, long_slots, sizeof(long_slots)/sizeof(long_slots[0]));
+
+	/* option positions are byte offsets */
+	CHECK(SHORT_e_acute == SHORT_OPT(0));
+	CHECK(SHORT_x == SHORT_OPT(4));
+	CHECK(SHORT_zhe == SHORT_OPT(5));
+	CHECK(SHORT_euro == SHORT_OPT(7));
+
+	for (k = 0; k < 2; k++) {
+		const struct opt_index *const px = k ? &x : NULL;
+		CHECK(!strcmp(run(px, argv1), "e:abc e:v x zhe x x e:val"));
+		CHECK(!strcmp(run(px, argv2), "size:10 euro:5 verbose param:p"));
+		/* e grave has the same lead byte as e acute */
+		CHECK(!strcmp(run(px, argv3), "unknown:-\xc3\xa8 x unknown:\xc3\xa8\xd0\xb6 zhe unknown:-\xa9 x unknown:\xc3"));
+		CHECK(!strcmp(run(px, argv4), "x euro:1 unknown:--gr\xc3\xb6\xc3\x9f unknown:--verbose-and-a-very-long-name=1"));
+		/* truncated sequences */
+		CHECK(!strcmp(run(px, argv5), "unknown:-\xd0 unknown:-\xe2\x82 e:<null>"));
+	}
+
+	check_long_end();
+
+	return test_result();
+}
@@ -0,0 +1,27 @@
+#!/bin/bash
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./get_opt_utf8_test.c -o ./get_opt_utf8_test || Exit
+Step && ./get_opt_utf8_test || Exit
+
+Step && $CC -DGET_OPT_NO_SIMD -Wall -pedantic -Wextra ./get_opt_utf8_test.c -o ./get_opt_utf8_test_nosimd || Exit
+Step && ./get_opt_utf8_test_nosimd || Exit
+
+Step && $CC -DGET_OPT_ARGV_NZ -Wall -pedantic -Wextra ./get_opt_utf8_test.c -o ./get_opt_utf8_test_nz || Exit
+Step && ./get_opt_utf8_test_nz || Exit
+
+echo "=============== all tests OK ==============="
@@ -0,0 +1,160 @@
+/**********************************************************************************
+* Option values conversion test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* get_opt_val_test.c */
+
+/* compile with
+  gcc get_opt_val_test.c -o get_opt_val_test
+ and run the test:
+  ./get_opt_val_test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../get_opt.inl"
+#include "../get_opt_val.inl"
+#include "test_util.h"
+
+#define T(s) GET_OPT_TEXT(s)
+
+static int check_uint(const GET_OPT_CHAR *v, unsigned long long max, int err, unsigned long long expected)
+{
+	unsigned long long x = 12345;
+	const int e = opt_val_uint(v, 0, max, &x);
+	return e == err && x == (e ? 12345 : expected);
+}
+
+static int check_int(const GET_OPT_CHAR *v, long long min, long long max, int err, long long expected)
+{
+	long long x = 12345;
+	const int e = opt_val_int(v, min, max, &x);
+	return e == err && x == (e ? 12345 : expected);
+}
+
+static int check_size(const GET_OPT_CHAR *v, int err, unsigned long long expected)
+{
+	unsigned long long x = 12345;
+	const int e = opt_val_size(v, ~0ull, &x);
+	return e == err && x == (e ? 12345 : expected);
+}
+
+static int check_duration(const GET_OPT_CHAR *v, unsigned long long unit, int err, unsigned long long expected)
+{
+	unsigned long long x = 12345;
+	const int e = opt_val_duration(v, unit, ~0ull, &x);
+	return e == err && x == (e ? 12345 : expected);
+}
+
+static int check_bool(const GET_OPT_CHAR *v, int err, int expected)
+{
+	int x = 12345;
+	const int e = opt_val_bool(v, &x);
+	return e == err && x == (e ? 12345 : expected);
+}
+
+int main(void)
+{
+#define COLOR_red     LONG_OPT_MODIFIER("red",   0, COLOR_green)
+#define COLOR_green   LONG_OPT_MODIFIER("green", 0, COLOR_blue)
+#define COLOR_blue    LONG_OPT_MODIFIER("blue",  0, LONG_OPT_NULL)
+
+#define LONG_OPT_NULL       {0,NULL}
+#define LONG_OPT_MODIFIER   LONG_OPT_DEFINER
+
+	static const struct long_opt_info colors[] = {COLOR_red};
+
+#undef  LONG_OPT_NULL
+#undef  LONG_OPT_MODIFIER
+
+#define LONG_OPT_NULL       LONG_OPT_END_IDX(colors)
+#define LONG_OPT_MODIFIER   LONG_OPT_ENCODER
+
+	static unsigned short slots[LONG_OPT_HASH_SIZE(colors)];
+	struct long_opt_hash h;
+	int c = -1;
+
+	CHECK(check_uint(T("0"), ~0ull, 0, 0));
+	CHECK(check_uint(T("42"), ~0ull, 0, 42));
+	CHECK(check_uint(T("0x1F"), ~0ull, 0, 31));
+	CHECK(check_uint(T("0XfF"), ~0ull, 0, 255));
+	CHECK(check_uint(T("18446744073709551615"), ~0ull, 0, ~0ull));
+	CHECK(check_uint(T("18446744073709551616"), ~0ull, ERANGE, 0));
+	CHECK(check_uint(T("0xFFFFFFFFFFFFFFFF"), ~0ull, 0, ~0ull));
+	CHECK(check_uint(T("0x10000000000000000"), ~0ull, ERANGE, 0));
+	CHECK(check_uint(T("10"), 9, ERANGE, 0));
+	CHECK(check_uint(NULL, 9, EINVAL, 0));
+	CHECK(check_uint(T(""), 9, EINVAL, 0));
+	CHECK(check_uint(T(" 1"), 9, EINVAL, 0));
+	CHECK(check_uint(T("1 "), 9, EINVAL, 0));
+	CHECK(check_uint(T("0x"), 9, EINVAL, 0));
+	CHECK(check_uint(T("-1"), 9, EINVAL, 0));
+	CHECK(check_uint(T("1.5"), 9, EINVAL, 0));
+
+	CHECK(check_int(T("-42"), -100, 100, 0, -42));
+	CHECK(check_int(T("+42"), -100, 100, 0, 42));
+	CHECK(check_int(T("-0"), -100, 100, 0, 0));
+	CHECK(check_int(T("-0x10"), -100, 100, 0, -16));
+	CHECK(check_int(T("-101"), -100, 100, ERANGE, 0));
+	CHECK(check_int(T("9223372036854775807"), -1 - 0x7FFFFFFFFFFFFFFFll, 0x7FFFFFFFFFFFFFFFll, 0, 0x7FFFFFFFFFFFFFFFll));
+	CHECK(check_int(T("9223372036854775808"), -1 - 0x7FFFFFFFFFFFFFFFll, 0x7FFFFFFFFFFFFFFFll, ERANGE, 0));
+	CHECK(check_int(T("-9223372036854775808"), -1 - 0x7FFFFFFFFFFFFFFFll, 0x7FFFFFFFFFFFFFFFll, 0, -1 - 0x7FFFFFFFFFFFFFFFll));
+	CHECK(check_int(T("-9223372036854775809"), -1 - 0x7FFFFFFFFFFFFFFFll, 0x7FFFFFFFFFFFFFFFll, ERANGE, 0));
+	CHECK(check_int(T("-"), -100, 100, EINVAL, 0));
+	CHECK(check_int(T("--1"), -100, 100, EINVAL, 0));
+
+	CHECK(check_size(T("4096"), 0, 4096));
+	CHECK(check_size(T("100B"), 0, 100));
+	CHECK(check_size(T("64K"), 0, 65536));
+	CHECK(check_size(T("64kb"), 0, 65536));
+	CHECK(check_size(T("2GiB"), 0, 2ull << 30));
+	CHECK(check_size(T("3m"), 0, 3ull << 20));
+	CHECK(check_size(T("15E"), 0, 15ull << 60));
+	CHECK(check_size(T("16E"), ERANGE, 0));
+	CHECK(check_size(T("1KK"), EINVAL, 0));
+	CHECK(check_size(T("1iB"), EINVAL, 0));
+	CHECK(check_size(T("1Ki"), EINVAL, 0));
+	CHECK(check_size(T("K"), EINVAL, 0));
+
+	CHECK(check_duration(T("150ms"), 0, 0, 150000000));
+	CHECK(check_duration(T("1h30m"), 0, 0, 5400000000000ull));
+	CHECK(check_duration(T("2s500ms"), 0, 0, 2500000000ull));
+	CHECK(check_duration(T("7ns"), 0, 0, 7));
+	CHECK(check_duration(T("7US"), 0, 0, 7000));
+	CHECK(check_duration(T("1d"), 0, 0, 86400000000000ull));
+	CHECK(check_duration(T("5"), 0, EINVAL, 0));
+	CHECK(check_duration(T("5"), 1000000, 0, 5000000));
+	CHECK(check_duration(T("1s5"), 1000000, EINVAL, 0));
+	CHECK(check_duration(T("1x"), 1000000, EINVAL, 0));
+	CHECK(check_duration(T("1n"), 0, EINVAL, 0));
+	CHECK(check_duration(T("s"), 0, EINVAL, 0));
+	CHECK(check_duration(T("300000d"), 0, ERANGE, 0));
+	CHECK(check_duration(T("18446744073709551615ns1ns"), 0, ERANGE, 0));
+
+	CHECK(check_bool(NULL, 0, 1));
+	CHECK(check_bool(T("yes"), 0, 1));
+	CHECK(check_bool(T("ON"), 0, 1));
+	CHECK(check_bool(T("True"), 0, 1));
+	CHECK(check_bool(T("1"), 0, 1));
+	CHECK(check_bool(T("no"), 0, 0));
+	CHECK(check_bool(T("off"), 0, 0));
+	CHECK(check_bool(T("FALSE"), 0, 0));
+	CHECK(check_bool(T("0"), 0, 0));
+	CHECK(check_bool(T("y"), EINVAL, 0));
+	CHECK(check_bool(T("yess"), EINVAL, 0));
+	CHECK(check_bool(T(""), EINVAL, 0));
+
+	long_opt_hash_init(&h, colors, slots, sizeof(slots)/sizeof(slots[0]));
+	CHECK(!opt_val_enum(T("green"), colors, NULL, &c) && COLOR_green == c);
+	CHECK(!opt_val_enum(T("blue"), colors, &h, &c) && COLOR_blue == c);
+	CHECK(!opt_val_enum(T("red"), colors, &h, &c) && COLOR_red == c);
+	CHECK(EINVAL == opt_val_enum(T("gree"), colors, NULL, &c) && COLOR_red == c);
+	CHECK(EINVAL == opt_val_enum(T("black"), colors, &h, &c));
+	CHECK(EINVAL == opt_val_enum(T("red=1"), colors, &h, &c));
+	CHECK(EINVAL == opt_val_enum(T(""), colors, &h, &c));
+	CHECK(EINVAL == opt_val_enum(NULL, colors, &h, &c));
+
+	return test_result();
+}
@@ -0,0 +1,166 @@
+/**********************************************************************************
+* Intrusive hash table test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* ihash_test.c */
+
+/* compile with
+  gcc ihash_test.c -o ihash_test
+ or
+  gcc -DIHASH_NO_SIMD ihash_test.c -o ihash_test
+ or
+  g++ -x c++ ihash_test.c -o ihash_test
+ and run the test:
+  ./ihash_test
+*/
+
+#include <stdio.h>
+#include "../ihash.h"
+#include "test_util.h"
+
+#define ITEMS 5000
+
+struct item {
+	unsigned key;
+	int inserted;
+	int visited;
+	struct ihash_node hook;
+};
+
+static struct item items[ITEMS];
+
+static int item_eq(const struct ihash_node *const n, const void *const key)
+{
+	const struct item *const it = IHASH_ENTRY(n, const struct item, hook);
+	return it->key == *(const unsigned*)key;
+}
+
+/* hash function, may be made weak to get collisions */
+static unsigned hash_bits = 0; /* 0 - all bits of the mixed key */
+
+static size_t key_hash(const unsigned key)
+{
+	const size_t h = ihash_mix(key);
+	return hash_bits ? h & (((size_t)1 << hash_bits) - 1) : h;
+}
+
+static struct item *find(const struct ihash *const t, const unsigned key)
+{
+	return IHASH_OPT_ENTRY(ihash_find(t, key_hash(key), &key, item_eq), struct item, hook);
+}
+
+/* check that the table contains exactly the inserted items */
+static void check_all(const struct ihash *const t)
+{
+	size_t pos = 0, count = 0;
+	struct ihash_node *n;
+	unsigned k;
+	for (k = 0; k < ITEMS; k++)
+		items[k].visited = 0;
+	while ((n = ihash_next(t, &pos)) != NULL) {
+		struct item *const it = IHASH_ENTRY(n, struct item, hook);
+		CHECK(it->inserted);
+		CHECK(!it->visited);
+		it->visited = 1;
+		count++;
+	}
+	CHECK(count == ihash_count(t));
+	for (k = 0; k < ITEMS; k++) {
+		CHECK(items[k].visited == items[k].inserted);
+		CHECK(find(t, items[k].key) == (items[k].inserted ? &items[k] : NULL));
+	}
+}
+
+/* randomly insert and remove items, compare with the model */
+static void test_random(const unsigned bits, const unsigned ops)
+{
+	struct ihash t;
+	size_t count = 0;
+	unsigned k, migrated = 0;
+
+	hash_bits = bits;
+	for (k = 0; k < ITEMS; k++) {
+		items[k].key = k*7u + 3u;
+		items[k].inserted = 0;
+	}
+
+	ihash_init(&t);
+	CHECK(!ihash_count(&t));
+	CHECK(!find(&t, 3));
+
+	for (k = 0; k < ops; k++) {
+		struct item *const it = &items[rnd() % ITEMS];
+		/* bias to insertions in the first half */
+		const int ins = k < ops/2 ? (rnd() % 4 != 0) : (rnd() % 2 != 0);
+		if (ins && !it->inserted) {
+			CHECK(!find(&t, it->key));
+			CHECK(!ihash_insert(&t, &it->hook, key_hash(it->key)));
+			it->inserted = 1;
+			count++;
+		}
+		else if (!ins && it->inserted) {
+			CHECK(find(&t, it->key) == it);
+			ihash_remove(&t, &it->hook);
+			it->inserted = 0;
+			count--;
+		}
+		CHECK(ihash_count(&t) == count);
+		if (t.old.slots) {
+			migrated++;
+			/* elements may be found in any of the tables */
+			CHECK(find(&t, it->key) == (it->inserted ? it : NULL));
+		}
+		if (k % 1000 == 0)
+			check_all(&t);
+	}
+	check_all(&t);
+
+	/* the table has grown incrementally */
+	CHECK(migrated);
+
+	/* remove all elements while the table may be migrating */
+	for (k = 0; k < ITEMS; k++) {
+		if (items[k].inserted) {
+			ihash_remove(&t, &items[k].hook);
+			items[k].inserted = 0;
+		}
+	}
+	CHECK(!ihash_count(&t));
+	check_all(&t);
+
+	ihash_destroy(&t);
+	CHECK(!ihash_count(&t));
+}
+
+/* all elements have the same hash */
+static void test_collisions(void)
+{
+	struct ihash t;
+	struct item its[100];
+	unsigned k;
+
+	ihash_init(&t);
+	for (k = 0; k < 100; k++) {
+		its[k].key = k;
+		CHECK(!ihash_insert(&t, &its[k].hook, 12345));
+	}
+	for (k = 0; k < 100; k++)
+		CHECK(ihash_find(&t, 12345, &its[k].key, item_eq) == &its[k].hook);
+	CHECK(!ihash_find(&t, 12345, &k, item_eq));
+	for (k = 0; k < 100; k += 2)
+		ihash_remove(&t, &its[k].hook);
+	for (k = 0; k < 100; k++)
+		CHECK(ihash_find(&t, 12345, &its[k].key, item_eq) == (k & 1 ? &its[k].hook : NULL));
+	CHECK(ihash_count(&t) == 50);
+	ihash_destroy(&t);
+}
+
+int main(void)
+{
+	test_random(0, 100000);
+	test_random(10, 50000); /* many equal fingerprints and group collisions */
+	test_collisions();
+	return test_result();
+}
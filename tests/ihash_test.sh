@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./ihash_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./ihash_test.c -o ./ihash_test || Exit
+Step && ./ihash_test || Exit
+
+Step && $CC -Wall -pedantic -Wextra -DIHASH_NO_SIMD ./ihash_test.c -o ./ihash_test_nosimd || Exit
+Step && ./ihash_test_nosimd || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./ihash_test.c -o ./ihash_test_cxx || Exit
+Step && ./ihash_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
@@ -0,0 +1,95 @@
+/**********************************************************************************
+* Check compilation of layout_asserts.h
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* layout_asserts_test.c */
+
+/* should compile without errors:
+  gcc -c layout_asserts_test.c
+  g++ -c layout_asserts_test.c
+*/
+
+/* should not compile:
+  gcc -c layout_asserts_test.c -DBAD...
+*/
+
+/* should not compile:
+  g++ -c layout_asserts_test.c -DBAD...
+*/
+
+#include "../layout_asserts.h"
+
+struct S {
+	int a;
+	int b;
+	char pad[CACHE_LINE_SIZE - sizeof(int)];
+	int c;
+};
+
+struct P {
+	char a;
+	int b;
+};
+
+struct N {
+	int a;
+	int b;
+	char c[8];
+};
+
+STATIC_ASSERT_SIZE_LE(struct N, 16);
+STATIC_ASSERT_SIZE_LE(struct S, 2*CACHE_LINE_SIZE);
+
+STATIC_ASSERT_SAME_CACHE_LINE(struct S, a, b);
+STATIC_ASSERT_SAME_CACHE_LINE(struct S, b, a);
+STATIC_ASSERT_SAME_CACHE_LINE(struct S, a, a);
+
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct S, a, c);
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct S, c, b);
+
+STATIC_ASSERT_NO_PADDING(struct N, a, b, c);
+STATIC_ASSERT_NO_PADDING(struct S, a, b, pad, c);
+
+void f(void);
+void f(void)
+{
+	/* may be placed inside a function */
+	STATIC_ASSERT_NO_PADDING(struct N, c, b, a);
+}
+
+#ifdef BAD1
+/* size of the structure exceeds given limit */
+STATIC_ASSERT_SIZE_LE(struct N, 15);
+#endif
+
+#ifdef BAD2
+/* 'a' and 'c' are in different cache lines */
+STATIC_ASSERT_SAME_CACHE_LINE(struct S, a, c);
+#endif
+
+#ifdef BAD3
+/* 'pad' spans two cache lines */
+STATIC_ASSERT_SAME_CACHE_LINE(struct S, a, pad);
+#endif
+
+#ifdef BAD4
+/* 'a' and 'b' share the same cache line */
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct S, a, b);
+#endif
+
+#ifdef BAD5
+/* 'pad' shares cache lines with 'a' and 'c' */
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct S, pad, c);
+#endif
+
+#ifdef BAD6
+/* there are padding bytes after 'a' */
+STATIC_ASSERT_NO_PADDING(struct P, a, b);
+#endif
+
+#ifdef BAD7
+/* not all members are listed */
+STATIC_ASSERT_NO_PADDING(struct N, a, b);
+#endif
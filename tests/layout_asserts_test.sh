@@ -0,0 +1,44 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./layout_asserts_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+# should be compiled
+Step && $CC  -Wall -pedantic -Wextra -c layout_asserts_test.c || Exit
+Step && $CXX -Wall -pedantic -Wextra -c layout_asserts_test.c || Exit
+
+# should not be compiled
+Step && $CC -c layout_asserts_test.c -DBAD1 && Exit
+Step && $CC -c layout_asserts_test.c -DBAD2 && Exit
+Step && $CC -c layout_asserts_test.c -DBAD3 && Exit
+Step && $CC -c layout_asserts_test.c -DBAD4 && Exit
+Step && $CC -c layout_asserts_test.c -DBAD5 && Exit
+Step && $CC -c layout_asserts_test.c -DBAD6 && Exit
+Step && $CC -c layout_asserts_test.c -DBAD7 && Exit
+
+# should not be compiled
+Step && $CXX -c layout_asserts_test.c -DBAD1 && Exit
+Step && $CXX -c layout_asserts_test.c -DBAD2 && Exit
+Step && $CXX -c layout_asserts_test.c -DBAD3 && Exit
+Step && $CXX -c layout_asserts_test.c -DBAD4 && Exit
+Step && $CXX -c layout_asserts_test.c -DBAD5 && Exit
+Step && $CXX -c layout_asserts_test.c -DBAD6 && Exit
+Step && $CXX -c layout_asserts_test.c -DBAD7 && Exit
+
+echo "=============== all tests OK ==============="
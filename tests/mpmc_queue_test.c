@@ -0,0 +1,121 @@
+/**********************************************************************************
+* Bounded MPMC queue test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* mpmc_queue_test.c */
+
+/* compile with
+  gcc mpmc_queue_test.c -o mpmc_queue_test
+ or
+  g++ -x c++ mpmc_queue_test.c -o mpmc_queue_test
+ and run the test:
+  ./mpmc_queue_test
+*/
+
+#include <stdio.h>
+#include "../mpmc_queue.h"
+#include "test_util.h"
+
+#define CAPACITY 64
+#define ITEMS 1000
+
+static unsigned items[ITEMS];
+
+static void test_init(void)
+{
+	struct mpmc_queue q;
+	CHECK(mpmc_queue_init(&q, 0) == EINVAL);
+	CHECK(mpmc_queue_init(&q, 1) == EINVAL);
+	CHECK(mpmc_queue_init(&q, 100) == EINVAL);
+	CHECK(!mpmc_queue_init(&q, 2));
+	CHECK(!mpmc_queue_pop(&q));
+	CHECK(mpmc_queue_push(&q, &items[0]));
+	CHECK(mpmc_queue_push(&q, &items[1]));
+	CHECK(!mpmc_queue_push(&q, &items[2])); /* full */
+	CHECK(mpmc_queue_pop(&q) == &items[0]);
+	CHECK(mpmc_queue_push(&q, &items[2]));
+	CHECK(mpmc_queue_pop(&q) == &items[1]);
+	CHECK(mpmc_queue_pop(&q) == &items[2]);
+	CHECK(!mpmc_queue_pop(&q));
+	mpmc_queue_destroy(&q);
+}
+
+/* pointers are popped in order of pushes, the ring wraps around many times */
+static void test_fifo(void)
+{
+	struct mpmc_queue q;
+	unsigned k, pushed = 0, popped = 0;
+	CHECK(!mpmc_queue_init(&q, CAPACITY));
+	for (k = 0; k < ITEMS; k++)
+		items[k] = k;
+	for (k = 0; k < 100000; k++) {
+		void *ptrs[CAPACITY + 10];
+		const size_t n = rnd() % (CAPACITY + 10) + 1;
+		size_t i, count;
+		switch (rnd() % 4) {
+			case 0: {
+				const int ok = mpmc_queue_push(&q, &items[pushed % ITEMS]);
+				CHECK(ok == (pushed - popped < CAPACITY));
+				pushed += (unsigned)ok;
+				break;
+			}
+			case 1: {
+				const unsigned *const p = (const unsigned*)mpmc_queue_pop(&q);
+				if (pushed == popped)
+					CHECK(!p);
+				else
+					CHECK(p && *p == popped++ % ITEMS);
+				break;
+			}
+			case 2:
+				for (i = 0; i < n; i++)
+					ptrs[i] = &items[(pushed + i) % ITEMS];
+				count = mpmc_queue_push_batch(&q, ptrs, n);
+				CHECK(count == (n < CAPACITY - (pushed - popped) ? n : CAPACITY - (pushed - popped)));
+				pushed += (unsigned)count;
+				break;
+			default:
+				count = mpmc_queue_pop_batch(&q, ptrs, n);
+				CHECK(count == (n < pushed - popped ? n : pushed - popped));
+				for (i = 0; i < count; i++)
+					CHECK(*(const unsigned*)ptrs[i] == popped++ % ITEMS);
+				break;
+		}
+	}
+	CHECK(pushed > 10000);
+	mpmc_queue_destroy(&q);
+}
+
+/* a consumer reserved a cell, but has not emptied it yet */
+static void test_pop_in_progress(void)
+{
+	struct mpmc_queue q;
+	void *ptrs[4];
+	size_t count;
+	CHECK(!mpmc_queue_init(&q, 4));
+	ptrs[0] = &items[0];
+	ptrs[1] = &items[1];
+	ptrs[2] = &items[2];
+	ptrs[3] = &items[3];
+	CHECK(mpmc_queue_push_batch(&q, ptrs, 4) == 4);
+	/* reserve the first cell */
+	CHECK(mpmc_queue_reserve_(&q, &q.deq, 1, 1, &count) == 0 && count == 1);
+	CHECK(mpmc_queue_pop_batch(&q, ptrs, 4) == 3);
+	CHECK(ptrs[0] == &items[1] && ptrs[2] == &items[3]);
+	/* the cell is not free until emptied */
+	CHECK(!mpmc_queue_push(&q, &items[4]));
+	ATOMIC_STORE(&q.cells[0].seq, 0 + q.mask + 1, ATOMIC_RELEASE);
+	CHECK(mpmc_queue_push(&q, &items[4]));
+	CHECK(mpmc_queue_pop(&q) == &items[4]);
+	mpmc_queue_destroy(&q);
+}
+
+int main(void)
+{
+	test_init();
+	test_fifo();
+	test_pop_in_progress();
+	return test_result();
+}
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./mpmc_queue_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./mpmc_queue_test.c -o ./mpmc_queue_test || Exit
+Step && ./mpmc_queue_test || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./mpmc_queue_test.c -o ./mpmc_queue_test_cxx || Exit
+Step && ./mpmc_queue_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
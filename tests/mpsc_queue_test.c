@@ -0,0 +1,127 @@
+/**********************************************************************************
+* Intrusive MPSC queue test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* mpsc_queue_test.c */
+
+/* compile with
+  gcc mpsc_queue_test.c -o mpsc_queue_test
+ or
+  g++ -x c++ mpsc_queue_test.c -o mpsc_queue_test
+ and run the test:
+  ./mpsc_queue_test
+*/
+
+/* should not compile:
+  gcc -c mpsc_queue_test.c -DBAD...
+*/
+
+#include <stdio.h>
+#include "../mpsc_queue.h"
+#include "test_util.h"
+
+#define MSGS 1000
+
+struct msg {
+	unsigned id;
+	struct mpsc_node node;
+};
+
+static struct msg msgs[MSGS];
+
+#ifdef BAD1
+/* non-const message cannot be obtained from const node */
+struct msg *bad1(const struct mpsc_node *const n)
+{
+	return MPSC_ENTRY(n, struct msg, node);
+}
+#endif
+
+static void test_fifo(void)
+{
+	struct mpsc_queue q;
+	unsigned k, pushed = 0, popped = 0;
+	mpsc_queue_init(&q);
+	CHECK(mpsc_queue_is_empty(&q));
+	CHECK(!mpsc_queue_pop(&q));
+
+	/* single message */
+	msgs[0].id = 0;
+	mpsc_queue_push(&q, &msgs[0].node);
+	CHECK(!mpsc_queue_is_empty(&q));
+	CHECK(mpsc_queue_pop(&q) == &msgs[0].node);
+	CHECK(mpsc_queue_is_empty(&q));
+	CHECK(!mpsc_queue_pop(&q));
+
+	/* messages are popped in order of pushes */
+	for (k = 0; k < 100000; k++) {
+		if (pushed - popped < MSGS && rnd() % 2) {
+			struct msg *const m = &msgs[pushed % MSGS];
+			m->id = pushed++;
+			mpsc_queue_push(&q, &m->node);
+		}
+		else {
+			const struct msg *const m = MPSC_OPT_ENTRY(mpsc_queue_pop(&q), const struct msg, node);
+			if (pushed == popped)
+				CHECK(!m);
+			else
+				CHECK(m && m->id == popped++);
+		}
+		CHECK(mpsc_queue_is_empty(&q) == (pushed == popped));
+	}
+}
+
+/* a push is in progress: the previous head is not linked yet */
+static void test_push_in_progress(void)
+{
+	struct mpsc_queue q;
+	struct mpsc_node *prev;
+	mpsc_queue_init(&q);
+	mpsc_queue_push(&q, &msgs[0].node);
+	mpsc_queue_push(&q, &msgs[1].node);
+
+	/* first half of the push */
+	msgs[2].node.next = NULL;
+	prev = ATOMIC_EXCHANGE_PTR(&q.head, &msgs[2].node, ATOMIC_ACQ_REL);
+	CHECK(prev == &msgs[1].node);
+
+	CHECK(mpsc_queue_pop(&q) == &msgs[0].node);
+	CHECK(!mpsc_queue_pop(&q)); /* msgs[1] cannot be popped until it is linked */
+	CHECK(!mpsc_queue_is_empty(&q));
+
+	/* second half */
+	ATOMIC_STORE_PTR(&prev->next, &msgs[2].node, ATOMIC_RELEASE);
+	CHECK(mpsc_queue_pop(&q) == &msgs[1].node);
+	CHECK(mpsc_queue_pop(&q) == &msgs[2].node);
+	CHECK(mpsc_queue_is_empty(&q));
+}
+
+static void test_batch(void)
+{
+	struct mpsc_queue q;
+	struct mpsc_node *nodes[MSGS];
+	unsigned k;
+	mpsc_queue_init(&q);
+	mpsc_queue_push(&q, &msgs[0].node);
+	/* chain of messages */
+	for (k = 1; k < 9; k++)
+		msgs[k].node.next = &msgs[k + 1].node;
+	mpsc_queue_push_batch(&q, &msgs[1].node, &msgs[9].node);
+	mpsc_queue_push(&q, &msgs[10].node);
+	CHECK(mpsc_queue_pop_batch(&q, nodes, 5) == 5);
+	CHECK(mpsc_queue_pop_batch(&q, nodes + 5, MSGS) == 6);
+	for (k = 0; k < 11; k++)
+		CHECK(nodes[k] == &msgs[k].node);
+	CHECK(!mpsc_queue_pop_batch(&q, nodes, MSGS));
+	CHECK(mpsc_queue_is_empty(&q));
+}
+
+int main(void)
+{
+	test_fifo();
+	test_push_in_progress();
+	test_batch();
+	return test_result();
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./mpsc_queue_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./mpsc_queue_test.c -o ./mpsc_queue_test || Exit
+Step && ./mpsc_queue_test || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./mpsc_queue_test.c -o ./mpsc_queue_test_cxx || Exit
+Step && ./mpsc_queue_test_cxx || Exit
+
+# should not be compiled
+Step && $CC -c mpsc_queue_test.c -o mpsc_queue_test.o -DBAD1 && Exit
+Step && $CXX -x c++ -c mpsc_queue_test.c -o mpsc_queue_test.o -DBAD1 && Exit
+
+echo "=============== all tests OK ==============="
@@ -0,0 +1,182 @@
+/**********************************************************************************
+* Intrusive pairing heap test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* pheap_test.c */
+
+/* compile with
+  gcc pheap_test.c -o pheap_test
+ or
+  g++ -x c++ pheap_test.c -o pheap_test
+ and run the test:
+  ./pheap_test
+*/
+
+/* should not compile:
+  gcc -c pheap_test.c -DBAD...
+*/
+
+#include <stdio.h>
+#include "../pheap.h"
+#include "test_util.h"
+
+#define ITEMS 1000
+
+struct request {
+	unsigned deadline;
+	int queued;
+	struct pheap_node node;
+};
+
+static struct request reqs[ITEMS];
+
+static int request_less(const struct pheap_node *const a, const struct pheap_node *const b)
+{
+	return PHEAP_ENTRY(a, const struct request, node)->deadline <
+		PHEAP_ENTRY(b, const struct request, node)->deadline;
+}
+
+#ifdef BAD1
+/* non-const element cannot be obtained from const node */
+struct request *bad1(const struct pheap_node *const n)
+{
+	return PHEAP_ENTRY(n, struct request, node);
+}
+#endif
+
+/* check heap order and links of the subtree, returns the number of nodes */
+static unsigned check_subtree(const struct pheap_node *const n, const struct pheap_node *const prev)
+{
+	const struct pheap_node *c, *p = n;
+	unsigned count = 1;
+	if (n->prev != prev)
+		failed++;
+	for (c = n->child; c; p = c, c = c->next) {
+		if (request_less(c, n))
+			failed++;
+		count += check_subtree(c, p);
+	}
+	return count;
+}
+
+/* the top is the least queued element */
+static void check_heap(const struct pheap *const h, const unsigned count)
+{
+	const struct pheap_node *const top = pheap_top(h);
+	unsigned k, min = ~0u;
+	for (k = 0; k < ITEMS; k++) {
+		if (reqs[k].queued && reqs[k].deadline < min)
+			min = reqs[k].deadline;
+	}
+	CHECK(pheap_is_empty(h) == !count);
+	if (top) {
+		CHECK(PHEAP_ENTRY(top, const struct request, node)->deadline == min);
+		CHECK(!top->next);
+		CHECK(check_subtree(top, NULL) == count);
+	}
+}
+
+static void test_random(void)
+{
+	struct pheap h;
+	unsigned k, count = 0;
+
+	pheap_init(&h, request_less);
+	CHECK(!pheap_top(&h));
+	CHECK(!pheap_pop(&h));
+
+	for (k = 0; k < 50000; k++) {
+		struct request *const r = &reqs[rnd() % ITEMS];
+		switch (rnd() % 6) {
+			case 0:
+			case 1:
+				if (!r->queued) {
+					r->deadline = rnd();
+					pheap_insert(&h, &r->node);
+					r->queued = 1;
+					count++;
+				}
+				break;
+			case 2: {
+				struct request *const t = PHEAP_OPT_ENTRY(pheap_pop(&h), struct request, node);
+				if (t) {
+					CHECK(t->queued);
+					t->queued = 0;
+					count--;
+				}
+				break;
+			}
+			case 3:
+				if (r->queued) {
+					pheap_remove(&h, &r->node);
+					r->queued = 0;
+					count--;
+				}
+				break;
+			case 4:
+				if (r->queued) {
+					r->deadline -= r->deadline ? rnd() % r->deadline : 0;
+					pheap_decrease(&h, &r->node);
+				}
+				break;
+			default:
+				if (r->queued) {
+					r->deadline = rnd();
+					pheap_update(&h, &r->node);
+				}
+				break;
+		}
+		if (k % 100 == 0)
+			check_heap(&h, count);
+	}
+	check_heap(&h, count);
+
+	/* elements are popped in order of priorities */
+	{
+		unsigned prev = 0;
+		struct pheap_node *n;
+		while ((n = pheap_pop(&h)) != NULL) {
+			struct request *const r = PHEAP_ENTRY(n, struct request, node);
+			CHECK(prev <= r->deadline);
+			prev = r->deadline;
+			r->queued = 0;
+			count--;
+		}
+	}
+	CHECK(!count);
+	CHECK(pheap_is_empty(&h));
+}
+
+/* sort via the heap */
+static void test_sort(void)
+{
+	struct pheap h;
+	const unsigned removed = ((ITEMS - 1)*7919u) % ITEMS; /* deadline of the last element */
+	unsigned k;
+	pheap_init(&h, request_less);
+	for (k = 0; k < ITEMS; k++) {
+		reqs[k].deadline = (k*7919u) % ITEMS; /* permutation */
+		pheap_insert(&h, &reqs[k].node);
+	}
+	/* move the last element to the top, then remove it */
+	reqs[ITEMS - 1].deadline = 0;
+	pheap_decrease(&h, &reqs[ITEMS - 1].node);
+	CHECK(!PHEAP_ENTRY(pheap_top(&h), struct request, node)->deadline);
+	pheap_remove(&h, &reqs[ITEMS - 1].node);
+	for (k = 0; k < ITEMS; k++) {
+		if (k != removed) {
+			const struct pheap_node *const n = pheap_pop(&h);
+			CHECK(n && PHEAP_ENTRY(n, const struct request, node)->deadline == k);
+		}
+	}
+	CHECK(pheap_is_empty(&h));
+}
+
+int main(void)
+{
+	test_random();
+	test_sort();
+	return test_result();
+}
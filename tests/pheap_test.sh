@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./pheap_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./pheap_test.c -o ./pheap_test || Exit
+Step && ./pheap_test || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./pheap_test.c -o ./pheap_test_cxx || Exit
+Step && ./pheap_test_cxx || Exit
+
+# should not be compiled
+Step && $CC -c pheap_test.c -o pheap_test.o -DBAD1 && Exit
+Step && $CXX -x c++ -c pheap_test.c -o pheap_test.o -DBAD1 && Exit
+
+echo "=============== all tests OK ==============="
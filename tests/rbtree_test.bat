@@ -0,0 +1,39 @@
+@echo off
+setlocal
+set step=0
+
+rem 4464: relative include path contains '..'
+rem 4820: '...' bytes padding added after data member '...'
+rem 4514: '...': unreferenced inline function has been removed
+rem 4710: '...': function not inlined
+set "WARN=/Wall /wd4464 /wd4820 /wd4514 /wd4710"
+
+call :StepOk "cl /nologo /TC %WARN% rbtree_test.c /Forbtree_test" || exit /b 1
+call :StepOk "rbtree_test.exe" || exit /b 1
+
+call :StepOk "cl /nologo /TP %WARN% rbtree_test.c /Forbtree_test_cxx" || exit /b 1
+call :StepOk "rbtree_test_cxx.exe" || exit /b 1
+
+rem should not be compiled (constness is not checked by CONTAINER_OF() in C)
+(call :StepFail "cl /nologo /TP /c %WARN% rbtree_test.c /DBAD1") || exit /b 1
+
+echo =============== all tests OK ===============
+exit /b 0
+
+:StepOk
+echo step: %step%
+set /a step+=1
+echo %~1
+%~1 && exit /b 0
+goto :ErrExit
+
+:StepFail
+echo step: %step%
+set /a step+=1
+echo %~1
+%~1 || exit /b 0
+goto :ErrExit
+
+:ErrExit
+echo failed.
+exit /b 1
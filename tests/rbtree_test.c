@@ -0,0 +1,267 @@
+/**********************************************************************************
+* Intrusive red-black tree test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* rbtree_test.c */
+
+/* compile with
+  gcc rbtree_test.c -o rbtree_test
+ or
+  g++ -x c++ rbtree_test.c -o rbtree_test
+ and run the test:
+  ./rbtree_test
+*/
+
+/* should not compile:
+  gcc -c rbtree_test.c -DBAD...
+*/
+
+#include <stdio.h>
+#include "../rbtree.h"
+#include "test_util.h"
+
+#define ITEMS 2000
+
+/* interval [key, end], augmented by the size of the subtree and max end in the subtree */
+struct item {
+	unsigned key;
+	unsigned end;
+	int inserted;
+	unsigned size;
+	unsigned max_end;
+	struct rbtree_node node;
+};
+
+static struct item items[ITEMS];
+
+static int item_cmp(const void *const key, const struct rbtree_node *const n)
+{
+	const unsigned k = *(const unsigned*)key;
+	const unsigned e = RBTREE_ENTRY(n, const struct item, node)->key;
+	return k < e ? -1 : k > e;
+}
+
+static unsigned item_size(const struct rbtree_node *const n)
+{
+	return n ? RBTREE_ENTRY(n, const struct item, node)->size : 0;
+}
+
+static void item_update(struct rbtree_node *const n)
+{
+	struct item *const it = RBTREE_ENTRY(n, struct item, node);
+	it->size = 1 + item_size(n->left) + item_size(n->right);
+	it->max_end = it->end;
+	if (n->left && RBTREE_ENTRY(n->left, struct item, node)->max_end > it->max_end)
+		it->max_end = RBTREE_ENTRY(n->left, struct item, node)->max_end;
+	if (n->right && RBTREE_ENTRY(n->right, struct item, node)->max_end > it->max_end)
+		it->max_end = RBTREE_ENTRY(n->right, struct item, node)->max_end;
+}
+
+#ifdef BAD1
+/* non-const element cannot be obtained from const node */
+struct item *bad1(const struct rbtree_node *const n)
+{
+	return RBTREE_ENTRY(n, struct item, node);
+}
+#endif
+
+/* check red-black properties and augmented data, returns black height of the subtree or -1 */
+static int check_subtree(const struct rbtree *const t, const struct rbtree_node *const n, const struct rbtree_node *const parent)
+{
+	int lh, rh;
+	if (!n)
+		return 1;
+	if (rbtree_parent(n) != parent)
+		return -1;
+	if (!rbtree_is_black_(n) && (!rbtree_is_black_(n->left) || !rbtree_is_black_(n->right)))
+		return -1; /* red node has a red child */
+	if (n->left && item_cmp(&RBTREE_ENTRY(n->left, const struct item, node)->key, n) > 0)
+		return -1;
+	if (n->right && item_cmp(&RBTREE_ENTRY(n->right, const struct item, node)->key, n) < 0)
+		return -1;
+	lh = check_subtree(t, n->left, n);
+	rh = check_subtree(t, n->right, n);
+	if (lh < 0 || lh != rh)
+		return -1;
+	if (t->update) {
+		const struct item *const it = RBTREE_ENTRY(n, const struct item, node);
+		unsigned max_end = it->end;
+		if (n->left && RBTREE_ENTRY(n->left, const struct item, node)->max_end > max_end)
+			max_end = RBTREE_ENTRY(n->left, const struct item, node)->max_end;
+		if (n->right && RBTREE_ENTRY(n->right, const struct item, node)->max_end > max_end)
+			max_end = RBTREE_ENTRY(n->right, const struct item, node)->max_end;
+		if (it->size != 1 + item_size(n->left) + item_size(n->right) || it->max_end != max_end)
+			return -1;
+	}
+	return lh + rbtree_is_black_(n);
+}
+
+static void check_tree(const struct rbtree *const t, const unsigned count)
+{
+	const struct rbtree_node *n, *prev = NULL;
+	unsigned k = 0;
+	CHECK(rbtree_is_black_(t->root));
+	CHECK(check_subtree(t, t->root, NULL) > 0);
+	CHECK(rbtree_is_empty(t) == !count);
+	RBTREE_FOR_EACH(n, t) {
+		CHECK(RBTREE_ENTRY(n, const struct item, node)->inserted);
+		CHECK(rbtree_prev(n) == prev);
+		if (prev)
+			CHECK(item_cmp(&RBTREE_ENTRY(prev, const struct item, node)->key, n) <= 0);
+		prev = n;
+		k++;
+	}
+	CHECK(k == count);
+	CHECK(rbtree_last(t) == prev);
+	if (t->update)
+		CHECK(item_size(t->root) == count);
+}
+
+/* order statistics: get k-th element */
+static const struct item *select_nth(const struct rbtree *const t, unsigned k)
+{
+	const struct rbtree_node *n = t->root;
+	while (n) {
+		const unsigned l = item_size(n->left);
+		if (k == l)
+			return RBTREE_ENTRY(n, const struct item, node);
+		if (k < l)
+			n = n->left;
+		else {
+			k -= l + 1;
+			n = n->right;
+		}
+	}
+	return NULL;
+}
+
+/* interval tree: find any interval containing the point */
+static const struct item *find_interval(const struct rbtree *const t, const unsigned point)
+{
+	const struct rbtree_node *n = t->root;
+	while (n) {
+		const struct item *const it = RBTREE_ENTRY(n, const struct item, node);
+		if (it->key <= point && point <= it->end)
+			return it;
+		if (n->left && RBTREE_ENTRY(n->left, const struct item, node)->max_end >= point)
+			n = n->left;
+		else
+			n = n->right;
+	}
+	return NULL;
+}
+
+static void test_random(const int augmented, const unsigned key_range)
+{
+	struct rbtree t;
+	unsigned k, count = 0;
+
+	if (augmented)
+		rbtree_init_augmented(&t, item_update);
+	else
+		rbtree_init(&t);
+	CHECK(!rbtree_first(&t) && !rbtree_last(&t));
+
+	for (k = 0; k < ITEMS; k++) {
+		items[k].key = rnd() % key_range; /* keys may be equal */
+		items[k].end = items[k].key + rnd() % 100;
+		items[k].inserted = 0;
+	}
+
+	for (k = 0; k < 20000; k++) {
+		struct item *const it = &items[rnd() % ITEMS];
+		if (!it->inserted) {
+			rbtree_insert(&t, &it->node, &it->key, item_cmp);
+			it->inserted = 1;
+			count++;
+		}
+		else if (rnd() % 3) {
+			rbtree_remove(&t, &it->node);
+			it->inserted = 0;
+			count--;
+		}
+		if (k % 500 == 0)
+			check_tree(&t, count);
+	}
+	check_tree(&t, count);
+
+	/* find, lower_bound */
+	for (k = 0; k < ITEMS; k++) {
+		const struct rbtree_node *const f = rbtree_find(&t, &items[k].key, item_cmp);
+		const struct rbtree_node *const lb = rbtree_lower_bound(&t, &items[k].key, item_cmp);
+		if (items[k].inserted) {
+			CHECK(f && !item_cmp(&items[k].key, f));
+			/* the first of equal keys */
+			CHECK(lb && !item_cmp(&items[k].key, lb));
+			CHECK(!rbtree_prev(lb) || item_cmp(&items[k].key, rbtree_prev(lb)) > 0);
+		}
+		else
+			CHECK(!f || !item_cmp(&items[k].key, f));
+	}
+
+	if (augmented) {
+		const struct rbtree_node *n;
+		unsigned p;
+		k = 0;
+		RBTREE_FOR_EACH(n, &t)
+			CHECK(select_nth(&t, k++) == RBTREE_ENTRY(n, const struct item, node));
+		CHECK(!select_nth(&t, k));
+		for (p = 0; p < key_range + 100; p += 7) {
+			const struct item *const it = find_interval(&t, p);
+			int exp = 0;
+			RBTREE_FOR_EACH(n, &t) {
+				const struct item *const i = RBTREE_ENTRY(n, const struct item, node);
+				if (i->key <= p && p <= i->end)
+					exp = 1;
+			}
+			CHECK(it ? (it->inserted && it->key <= p && p <= it->end) : !exp);
+		}
+	}
+
+	/* remove in order, as expired timers */
+	while (!rbtree_is_empty(&t)) {
+		struct rbtree_node *const n = rbtree_first(&t);
+		struct item *const it = RBTREE_ENTRY(n, struct item, node);
+		const struct rbtree_node *const next = rbtree_next(n);
+		rbtree_remove(&t, n);
+		it->inserted = 0;
+		count--;
+		CHECK(rbtree_first(&t) == next);
+		if (count % 100 == 0)
+			check_tree(&t, count);
+	}
+	CHECK(!count);
+	CHECK(!t.root && !t.first);
+}
+
+/* elements with equal keys are kept in order of insertion */
+static void test_equal_keys(void)
+{
+	struct rbtree t;
+	const struct rbtree_node *n;
+	unsigned k;
+	rbtree_init(&t);
+	for (k = 0; k < 50; k++) {
+		items[k].key = 5;
+		items[k].end = k;
+		items[k].inserted = 1;
+		rbtree_insert(&t, &items[k].node, &items[k].key, item_cmp);
+	}
+	k = 0;
+	RBTREE_FOR_EACH(n, &t)
+		CHECK(RBTREE_ENTRY(n, const struct item, node)->end == k++);
+	CHECK(rbtree_lower_bound(&t, &items[0].key, item_cmp) == &items[0].node);
+	CHECK(RBTREE_OPT_ENTRY(rbtree_last(&t), struct item, node) == &items[49]);
+	check_tree(&t, 50);
+}
+
+int main(void)
+{
+	test_random(0, 1000);
+	test_random(1, 1000);
+	test_random(1, 30000);
+	test_equal_keys();
+	return test_result();
+}
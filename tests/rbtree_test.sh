@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./rbtree_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./rbtree_test.c -o ./rbtree_test || Exit
+Step && ./rbtree_test || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./rbtree_test.c -o ./rbtree_test_cxx || Exit
+Step && ./rbtree_test_cxx || Exit
+
+# should not be compiled
+Step && $CC -c rbtree_test.c -o rbtree_test.o -DBAD1 && Exit
+Step && $CXX -x c++ -c rbtree_test.c -o rbtree_test.o -DBAD1 && Exit
+
+echo "=============== all tests OK ==============="
@@ -0,0 +1,200 @@
+/**********************************************************************************
+* Reference counting test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* refcount_test.c */
+
+/* compile with
+  gcc refcount_test.c -o refcount_test
+ or
+  g++ -x c++ refcount_test.c -o refcount_test
+ and run the test:
+  ./refcount_test
+*/
+
+/* should not compile:
+  gcc -c refcount_test.c -DBAD...
+*/
+
+#include <stdio.h>
+#include "../refcount.h"
+#include "test_util.h"
+
+#define OBJECTS 100
+#define THREADS 4
+
+/* threads are simulated by their states */
+static struct refcount_owner threads[THREADS];
+
+struct session {
+	unsigned refs;      /* expected number of references */
+	int alive;
+	unsigned released;
+	struct refcount_biased ref;
+};
+
+static struct session sessions[OBJECTS];
+
+#ifdef BAD1
+/* non-const object cannot be obtained from const counter */
+struct session *bad1(const struct refcount_biased *const r)
+{
+	return REFCOUNT_ENTRY(r, struct session, ref);
+}
+#endif
+
+static void session_release(struct refcount_biased *const r)
+{
+	struct session *const s = REFCOUNT_ENTRY(r, struct session, ref);
+	CHECK(s->alive);
+	CHECK(!s->refs);
+	s->alive = 0;
+	s->released++;
+}
+
+static void test_atomic(void)
+{
+	struct refcount r;
+	refcount_init(&r, 1);
+	refcount_get(&r);
+	CHECK(refcount_read(&r) == 2);
+	CHECK(refcount_get_unless_zero(&r));
+	CHECK(!refcount_put(&r));
+	CHECK(!refcount_put(&r));
+	CHECK(refcount_put(&r));
+	CHECK(!refcount_read(&r));
+	CHECK(!refcount_get_unless_zero(&r));
+}
+
+static void test_biased(void)
+{
+	struct session *const s = &sessions[0];
+	struct refcount_owner *const a = &threads[0];
+	struct refcount_owner *const b = &threads[1];
+	refcount_owner_init(a);
+	refcount_owner_init(b);
+
+	/* only the owner takes references */
+	refcount_biased_init(&s->ref, a);
+	refcount_biased_get(&s->ref, a);
+	CHECK(s->ref.biased == 2 && !s->ref.shared);
+	CHECK(!refcount_biased_put(&s->ref, a));
+	CHECK(refcount_biased_put(&s->ref, a));
+
+	/* other thread releases the last reference after the owner merged the counts */
+	refcount_biased_init(&s->ref, a);
+	refcount_biased_get(&s->ref, b);
+	CHECK(s->ref.biased == 1);
+	CHECK(!refcount_biased_put(&s->ref, a));
+	CHECK(!s->ref.owner);
+	CHECK(refcount_biased_put(&s->ref, b));
+
+	/* reference passed to other thread makes the shared count negative */
+	refcount_biased_init(&s->ref, a);
+	s->alive = 1;
+	s->refs = 2;
+	refcount_biased_get(&s->ref, a);
+	s->refs--;
+	CHECK(!refcount_biased_put(&s->ref, b));
+	CHECK(a->queue == &s->ref);
+	s->refs--;
+	CHECK(!refcount_biased_put(&s->ref, a));
+	CHECK(s->alive);
+	CHECK(refcount_owner_merge(a, session_release) == 1);
+	CHECK(!s->alive);
+	CHECK(!a->queue);
+
+	/* the owner count drops to zero while the counter is queued */
+	refcount_biased_init(&s->ref, a);
+	s->alive = 1;
+	s->refs = 3;
+	refcount_biased_get(&s->ref, a);
+	refcount_biased_get(&s->ref, a);
+	CHECK(!refcount_biased_put(&s->ref, b));
+	CHECK(a->queue == &s->ref);
+	refcount_biased_get(&s->ref, b);
+	CHECK(!refcount_biased_put(&s->ref, a));
+	CHECK(!refcount_biased_put(&s->ref, a));
+	s->refs = 0;
+	CHECK(!refcount_biased_put(&s->ref, a)); /* counts are merged, but the counter is queued */
+	CHECK(!s->ref.owner);
+	CHECK(s->alive);
+	CHECK(refcount_owner_merge(a, session_release) == 1);
+	CHECK(!s->alive);
+	CHECK(!refcount_owner_merge(a, session_release));
+}
+
+/* references are taken and dropped by random threads */
+static void test_random(void)
+{
+	unsigned k, released = 0, created = OBJECTS;
+	for (k = 0; k < THREADS; k++)
+		refcount_owner_init(&threads[k]);
+	for (k = 0; k < OBJECTS; k++) {
+		refcount_biased_init(&sessions[k].ref, &threads[k % THREADS]);
+		sessions[k].refs = 1;
+		sessions[k].alive = 1;
+		sessions[k].released = 0;
+	}
+	for (k = 0; k < 200000; k++) {
+		struct session *const s = &sessions[rnd() % OBJECTS];
+		struct refcount_owner *const t = &threads[rnd() % THREADS];
+		if (!s->alive) {
+			/* the object was freed, create new one */
+			CHECK(s->released == 1);
+			refcount_biased_init(&s->ref, t);
+			s->refs = 1;
+			s->alive = 1;
+			s->released = 0;
+			created++;
+		}
+		else if (!s->refs)
+			continue; /* waits for the owner to merge the counts */
+		else if (rnd() % 2) {
+			refcount_biased_get(&s->ref, t);
+			s->refs++;
+		}
+		else {
+			s->refs--;
+			if (refcount_biased_put(&s->ref, t)) {
+				CHECK(!s->refs);
+				s->alive = 0;
+				s->released++;
+				released++;
+			}
+		}
+		if (rnd() % 16 == 0)
+			released += refcount_owner_merge(&threads[rnd() % THREADS], session_release);
+	}
+
+	/* drop all references */
+	for (k = 0; k < OBJECTS; k++) {
+		struct session *const s = &sessions[k];
+		while (s->alive && s->refs) {
+			s->refs--;
+			if (refcount_biased_put(&s->ref, &threads[rnd() % THREADS])) {
+				CHECK(!s->refs);
+				s->alive = 0;
+				s->released++;
+				released++;
+			}
+		}
+	}
+	for (k = 0; k < THREADS; k++)
+		released += refcount_owner_merge(&threads[k], session_release);
+	for (k = 0; k < OBJECTS; k++) {
+		CHECK(!sessions[k].alive);
+		CHECK(sessions[k].released == 1);
+	}
+	CHECK(released == created);
+}
+
+int main(void)
+{
+	test_atomic();
+	test_biased();
+	test_random();
+	return test_result();
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./refcount_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./refcount_test.c -o ./refcount_test || Exit
+Step && ./refcount_test || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./refcount_test.c -o ./refcount_test_cxx || Exit
+Step && ./refcount_test_cxx || Exit
+
+# should not be compiled
+Step && $CC -c refcount_test.c -o refcount_test.o -DBAD1 && Exit
+Step && $CXX -x c++ -c refcount_test.c -o refcount_test.o -DBAD1 && Exit
+
+echo "=============== all tests OK ==============="
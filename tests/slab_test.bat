@@ -0,0 +1,30 @@
+@echo off
+setlocal
+set step=0
+
+rem 4464: relative include path contains '..'
+rem 4820: '...' bytes padding added after data member '...'
+rem 4514: '...': unreferenced inline function has been removed
+rem 4710: '...': function not inlined
+rem 4711: function '...' selected for automatic inline expansion
+set "WARN=/Wall /wd4464 /wd4820 /wd4514 /wd4710 /wd4711"
+
+call :StepOk "cl /nologo /TC %WARN% slab_test.c /Foslab_test" || exit /b 1
+call :StepOk "slab_test.exe" || exit /b 1
+
+call :StepOk "cl /nologo /TC %WARN% /DSLAB_SIZE=4096 slab_test.c /Foslab_test_4k" || exit /b 1
+call :StepOk "slab_test_4k.exe" || exit /b 1
+
+call :StepOk "cl /nologo /TP %WARN% slab_test.c /Foslab_test_cxx" || exit /b 1
+call :StepOk "slab_test_cxx.exe" || exit /b 1
+
+echo =============== all tests OK ===============
+exit /b 0
+
+:StepOk
+echo step: %step%
+set /a step+=1
+echo %~1
+%~1 && exit /b 0
+echo failed.
+exit /b 1
@@ -0,0 +1,227 @@
+/**********************************************************************************
+* Slab allocator test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* slab_test.c */
+
+/* compile with
+  gcc slab_test.c -o slab_test
+ or
+  gcc -DSLAB_SIZE=4096 slab_test.c -o slab_test
+ or
+  g++ -x c++ slab_test.c -o slab_test
+ and run the test:
+  ./slab_test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+/* count allocated slabs and pools */
+static size_t allocated = 0;
+
+static void *test_aligned_alloc(const size_t size, const size_t align)
+{
+	void *p;
+#ifdef _WIN32
+	p = _aligned_malloc(size, align);
+#else
+	if (posix_memalign(&p, align, size))
+		p = NULL;
+#endif
+	if (p)
+		allocated++;
+	return p;
+}
+
+static void test_aligned_free(void *const p)
+{
+	allocated--;
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+#define SLAB_ALIGNED_ALLOC(size, align) test_aligned_alloc(size, align)
+#define SLAB_ALIGNED_FREE(p) test_aligned_free(p)
+
+#include "../slab.h"
+#include "test_util.h"
+
+#define OBJECTS 5000
+
+struct request {
+	unsigned id;
+	unsigned char data[37];
+};
+
+static struct request *objs[OBJECTS];
+
+static void fill(struct request *const r, const unsigned id)
+{
+	r->id = id;
+	memset(r->data, (int)(id & 0xFF), sizeof(r->data));
+}
+
+static int check_obj(const struct request *const r, const unsigned id)
+{
+	unsigned i;
+	if (r->id != id)
+		return 0;
+	for (i = 0; i < sizeof(r->data); i++) {
+		if (r->data[i] != (id & 0xFF))
+			return 0;
+	}
+	return 1;
+}
+
+static void test_create(void)
+{
+	struct slab_pool *pool;
+	CHECK(slab_pool_create(&pool, 0) == EINVAL);
+	CHECK(slab_pool_create(&pool, SLAB_SIZE) == EINVAL);
+	CHECK(!allocated);
+	CHECK(!slab_pool_create(&pool, 1));
+	CHECK(slab_obj_size(pool) == SLAB_OBJ_ALIGN_);
+	slab_pool_destroy(pool);
+	CHECK(!slab_pool_create(&pool, sizeof(struct request)));
+	CHECK(slab_obj_size(pool) >= sizeof(struct request));
+	CHECK(slab_obj_size(pool) % SLAB_OBJ_ALIGN_ == 0);
+	slab_pool_destroy(pool);
+	CHECK(!allocated);
+}
+
+/* objects allocated by the owner thread */
+static void test_local(void)
+{
+	struct slab_pool *pool;
+	unsigned k;
+	CHECK(!slab_pool_create(&pool, sizeof(struct request)));
+
+	for (k = 0; k < OBJECTS; k++) {
+		objs[k] = (struct request*)slab_alloc(pool);
+		CHECK(objs[k] != NULL);
+		CHECK((size_t)((char*)objs[k] - (char*)slab_of_(objs[k])) % SLAB_OBJ_ALIGN_ == 0);
+		CHECK(slab_of_(objs[k])->pool == pool);
+		fill(objs[k], k);
+	}
+	/* objects do not overlap */
+	for (k = 0; k < OBJECTS; k++)
+		CHECK(check_obj(objs[k], k));
+	CHECK(pool->in_use == OBJECTS);
+	CHECK(allocated > 1);
+
+	/* the last freed object is reused first */
+	slab_free(pool, objs[10]);
+	slab_free(pool, objs[20]);
+	CHECK(slab_alloc(pool) == objs[20]);
+	CHECK(slab_alloc(pool) == objs[10]);
+	fill(objs[10], 10);
+	fill(objs[20], 20);
+
+	/* free and allocate randomly */
+	for (k = 0; k < 100000; k++) {
+		const unsigned i = rnd() % OBJECTS;
+		if (objs[i]) {
+			CHECK(check_obj(objs[i], i));
+			slab_free(pool, objs[i]);
+			objs[i] = NULL;
+		}
+		else {
+			objs[i] = (struct request*)slab_alloc(pool);
+			CHECK(objs[i] != NULL);
+			fill(objs[i], i);
+		}
+	}
+	k = 0;
+	{
+		unsigned i;
+		for (i = 0; i < OBJECTS; i++) {
+			if (objs[i]) {
+				CHECK(check_obj(objs[i], i));
+				slab_free(pool, objs[i]);
+				objs[i] = NULL;
+				k++;
+			}
+		}
+	}
+	CHECK(k > 0);
+	CHECK(!pool->in_use);
+	slab_pool_destroy(pool);
+	CHECK(!allocated);
+}
+
+/* objects freed by "other threads" */
+static void test_remote(void)
+{
+	struct slab_pool *a, *b;
+	unsigned k;
+	CHECK(!slab_pool_create(&a, sizeof(struct request)));
+	CHECK(!slab_pool_create(&b, sizeof(struct request)));
+
+	for (k = 0; k < OBJECTS; k++) {
+		objs[k] = (struct request*)slab_alloc(a);
+		CHECK(objs[k] != NULL);
+		fill(objs[k], k);
+	}
+	/* free some objects via the other pool or without a pool */
+	for (k = 0; k < OBJECTS; k += 2)
+		slab_free(k % 4 ? b : NULL, objs[k]);
+	CHECK(a->in_use == OBJECTS);
+	CHECK(!b->in_use);
+	CHECK(a->remote != NULL);
+	CHECK(!b->slabs);
+
+	/* the owner takes back remotely freed objects before carving new ones */
+	{
+		const struct slab_hdr_ *const slabs = a->slabs;
+		for (k = 0; k < OBJECTS; k += 2) {
+			objs[k] = (struct request*)slab_alloc(a);
+			fill(objs[k], k);
+		}
+		CHECK(a->slabs == slabs);
+		CHECK(!a->remote);
+		CHECK(a->in_use == OBJECTS);
+	}
+	for (k = 0; k < OBJECTS; k++)
+		CHECK(check_obj(objs[k], k));
+
+	/* destroy the pool while objects are in use */
+	for (k = 0; k < OBJECTS/2; k++)
+		slab_free(b, objs[k]);
+	slab_pool_destroy(a);
+	CHECK(allocated > 1);
+	for (; k < OBJECTS - 1; k++) {
+		CHECK(check_obj(objs[k], k));
+		slab_free(b, objs[k]);
+	}
+	CHECK(allocated > 1);
+	/* the last object releases the abandoned pool */
+	slab_free(NULL, objs[k]);
+	CHECK(allocated == 1);
+	slab_pool_destroy(b);
+	CHECK(!allocated);
+
+	/* all objects were freed before the pool was destroyed */
+	CHECK(!slab_pool_create(&a, sizeof(struct request)));
+	objs[0] = (struct request*)slab_alloc(a);
+	slab_free(NULL, objs[0]);
+	slab_pool_destroy(a);
+	CHECK(!allocated);
+}
+
+int main(void)
+{
+	test_create();
+	test_local();
+	test_remote();
+	return test_result();
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./slab_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./slab_test.c -o ./slab_test || Exit
+Step && ./slab_test || Exit
+
+Step && $CC -Wall -pedantic -Wextra -DSLAB_SIZE=4096 ./slab_test.c -o ./slab_test_4k || Exit
+Step && ./slab_test_4k || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./slab_test.c -o ./slab_test_cxx || Exit
+Step && ./slab_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
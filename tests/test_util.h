@@ -0,0 +1,47 @@
+#ifndef TEST_UTIL_H_INCLUDED
+#define TEST_UTIL_H_INCLUDED
+
+/**********************************************************************************
+* Common helpers of tests
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* test_util.h */
+
+/* defines:
+
+  CHECK(expr)       - count and report failed check,
+  test_result()     - report the number of failed checks, returns exit code of the test,
+  rnd()             - pseudo-random number in range [0, 0x7FFF], rnd_state - the state of the generator.
+*/
+
+#include <stdio.h> /* for printf() */
+
+static int failed = 0;
+
+#define CHECK(expr) ((expr) ? (void)0 : (void)(failed++, printf("%d: check failed: %s\n", __LINE__, #expr)))
+
+static int test_result(void)
+{
+	if (failed) {
+		printf("%d checks failed\n", failed);
+		return 1;
+	}
+	return 0;
+}
+
+/* pseudo-random numbers */
+static unsigned long rnd_state = 1;
+
+static unsigned rnd(void)
+{
+	rnd_state = rnd_state*1103515245ul + 12345ul;
+	return (unsigned)(rnd_state >> 16) & 0x7FFFu;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int test_result_unused_[sizeof(&test_result)];
+typedef int rnd_unused_[sizeof(&rnd)];
+
+#endif /* TEST_UTIL_H_INCLUDED */
@@ -0,0 +1,218 @@
+/**********************************************************************************
+* Timer wheel test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* twheel_test.c */
+
+/* compile with
+  gcc twheel_test.c -o twheel_test
+ or
+  gcc -DTWHEEL_LEVELS=2 twheel_test.c -o twheel_test
+ or
+  g++ -x c++ twheel_test.c -o twheel_test
+ and run the test:
+  ./twheel_test
+*/
+
+#include <stdio.h>
+#include "../twheel.h"
+#include "test_util.h"
+
+#define TIMERS 3000
+
+struct conn {
+	unsigned long long due;     /* expected expiration tick */
+	int pending;
+	unsigned fired;
+	struct twheel_timer timer;
+};
+
+static struct conn conns[TIMERS];
+static struct twheel wheel;
+
+/* time of the previous call of twheel_expire() */
+static unsigned long long prev_now;
+static unsigned long long last_due;
+
+static unsigned long long rnd_delay(void)
+{
+	switch (rnd() % 8) {
+		case 0: return 0;
+		case 1: return rnd() % 64;
+		case 2: case 3: return rnd() % 5000;
+		case 4: return (unsigned long long)rnd()*rnd();
+		case 5: return (unsigned long long)rnd()*rnd()*rnd() % (4llu << 6*TWHEEL_LEVELS); /* may be beyond the range of the wheel */
+		default: return rnd() % 300;
+	}
+}
+
+static void conn_add(struct conn *const c, const unsigned long long expires)
+{
+	const unsigned long long now = twheel_now(&wheel);
+	twheel_add(&wheel, &c->timer, expires);
+	c->due = expires > now ? expires : now + 1;
+	c->pending = 1;
+}
+
+static void on_timeout(struct twheel_timer *const t, void *const ctx)
+{
+	struct conn *const c = TWHEEL_ENTRY(t, struct conn, timer);
+	const unsigned long long now = twheel_now(&wheel);
+	CHECK(ctx == &wheel);
+	CHECK(c->pending);
+	CHECK(!twheel_is_pending(t));
+	/* expired exactly at the expected tick, in order of ticks */
+	CHECK(prev_now < c->due && c->due <= now);
+	CHECK(last_due <= c->due);
+	last_due = c->due;
+	c->pending = 0;
+	c->fired++;
+	switch (rnd() % 4) {
+		case 0:
+			/* periodic timer */
+			conn_add(c, now + rnd_delay());
+			break;
+		case 1: {
+			/* cancel another timer, maybe expired in the same batch */
+			struct conn *const o = &conns[rnd() % TIMERS];
+			CHECK(twheel_cancel(&o->timer) == o->pending);
+			o->pending = 0;
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static void check_pending(void)
+{
+	const unsigned long long now = twheel_now(&wheel);
+	const unsigned long long next = twheel_next_tick(&wheel);
+	unsigned long long min_due = ~0llu;
+	unsigned k;
+	for (k = 0; k < TIMERS; k++) {
+		CHECK(twheel_is_pending(&conns[k].timer) == conns[k].pending);
+		if (conns[k].pending) {
+			CHECK(conns[k].due > now);
+			if (conns[k].due < min_due)
+				min_due = conns[k].due;
+		}
+	}
+	CHECK(next > now);
+	CHECK(next <= min_due);
+	if (min_due == ~0llu)
+		CHECK(next == ~0llu);
+}
+
+static void test_random(void)
+{
+	unsigned long long fired = 0;
+	unsigned k;
+
+	twheel_init(&wheel, 1000000007ull); /* not aligned to a slot */
+	for (k = 0; k < TIMERS; k++) {
+		twheel_timer_init(&conns[k].timer);
+		conns[k].pending = 0;
+		conns[k].fired = 0;
+	}
+	check_pending();
+
+	for (k = 0; k < 20000; k++) {
+		struct conn *const c = &conns[rnd() % TIMERS];
+		switch (rnd() % 4) {
+			case 0:
+				if (!c->pending)
+					conn_add(c, twheel_now(&wheel) + rnd_delay());
+				break;
+			case 1:
+				CHECK(twheel_cancel(&c->timer) == c->pending);
+				c->pending = 0;
+				break;
+			case 2: {
+				/* restart the timer, may be in the past */
+				const unsigned long long e = twheel_now(&wheel) + rnd_delay() - 10;
+				twheel_mod(&wheel, &c->timer, e);
+				c->due = e > twheel_now(&wheel) ? e : twheel_now(&wheel) + 1;
+				c->pending = 1;
+				break;
+			}
+			default: {
+				unsigned long long step = rnd() % 4 ? rnd() % 100 : rnd_delay();
+				unsigned long long n;
+				prev_now = twheel_now(&wheel);
+				last_due = 0;
+				n = twheel_expire(&wheel, prev_now + step, on_timeout, &wheel);
+				CHECK(twheel_now(&wheel) == prev_now + step);
+				fired += n;
+				break;
+			}
+		}
+		if (k % 200 == 0)
+			check_pending();
+	}
+
+	/* expire all remaining timers */
+	for (;;) {
+		const unsigned long long next = twheel_next_tick(&wheel);
+		if (next == ~0llu)
+			break;
+		prev_now = twheel_now(&wheel);
+		last_due = 0;
+		fired += twheel_expire(&wheel, next, on_timeout, &wheel);
+		check_pending();
+	}
+	for (k = 0; k < TIMERS; k++)
+		CHECK(!conns[k].pending);
+	{
+		unsigned long long total = 0;
+		for (k = 0; k < TIMERS; k++)
+			total += conns[k].fired;
+		CHECK(total == fired);
+	}
+	CHECK(fired > 1000);
+}
+
+static void on_count(struct twheel_timer *const t, void *const ctx)
+{
+	(void)t;
+	(*(unsigned*)ctx)++;
+}
+
+/* expired timers are moved to the list in a batch */
+static void test_batch(void)
+{
+	struct dlist_entry expired;
+	struct dlist_entry *e;
+	unsigned k;
+	twheel_init(&wheel, 0);
+	dlist_init(&expired);
+	for (k = 0; k < 10; k++) {
+		twheel_timer_init(&conns[k].timer);
+		twheel_add(&wheel, &conns[k].timer, 100 - k*10); /* in reverse order */
+	}
+	twheel_advance(&wheel, 55, &expired);
+	k = 0;
+	DLIST_FOR_EACH(e, &expired) {
+		const struct twheel_timer *const t = TWHEEL_ENTRY(e, const struct twheel_timer, link);
+		CHECK(t->expires == 10 + k*10);
+		k++;
+	}
+	CHECK(k == 5);
+	/* expired timers are pending until unlinked from the list */
+	CHECK(twheel_is_pending(&conns[9].timer));
+	CHECK(twheel_cancel(&conns[9].timer));
+	CHECK(twheel_next_tick(&wheel) == 60);
+	/* the rest 5 timers, expired timers in the list are not affected */
+	CHECK(twheel_expire(&wheel, 1000, on_count, &k) == 5);
+	CHECK(k == 10);
+	CHECK(twheel_next_tick(&wheel) == ~0llu);
+}
+
+int main(void)
+{
+	test_random();
+	test_batch();
+	return test_result();
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./twheel_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra ./twheel_test.c -o ./twheel_test || Exit
+Step && ./twheel_test || Exit
+
+Step && $CC -Wall -pedantic -Wextra -DTWHEEL_LEVELS=2 ./twheel_test.c -o ./twheel_test_l2 || Exit
+Step && ./twheel_test_l2 || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra ./twheel_test.c -o ./twheel_test_cxx || Exit
+Step && ./twheel_test_cxx || Exit
+
+echo "=============== all tests OK ==============="
@@ -0,0 +1,268 @@
+/**********************************************************************************
+* Work-stealing scheduler test
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* wsched_test.c */
+
+/* compile with
+  gcc -pthread wsched_test.c -o wsched_test
+ or
+  g++ -pthread -x c++ wsched_test.c -o wsched_test
+ and run the test:
+  ./wsched_test
+*/
+
+/* should not compile:
+  gcc -c wsched_test.c -DBAD...
+*/
+
+#include <stdio.h>
+#include "../wsched.h"
+#include "test_util.h"
+
+#define WORKERS 4
+#define TASKS 5000
+
+struct fib_task {
+	struct wsched_task task;
+	unsigned n;
+	unsigned long result;
+};
+
+struct item_task {
+	struct wsched_task task;
+	int runs;
+	unsigned worker;
+};
+
+static struct item_task items[TASKS];
+
+/* number of tasks run by each worker, modified only by the worker */
+static unsigned long runs[WORKERS];
+
+#ifdef BAD1
+/* non-const closure cannot be obtained from const task */
+struct fib_task *bad1(const struct wsched_task *const t)
+{
+	return WSCHED_ENTRY(t, struct fib_task, task);
+}
+#endif
+
+static void fib_run(struct wsched_task *const t, struct wsched_worker *const w)
+{
+	struct fib_task *const f = WSCHED_ENTRY(t, struct fib_task, task);
+	runs[wsched_worker_index(w)]++;
+	if (f->n < 2)
+		f->result = f->n;
+	else {
+		struct wsched_join j;
+		struct fib_task a, b;
+		wsched_join_init(&j);
+		wsched_task_init(&a.task, fib_run, &j);
+		a.n = f->n - 1;
+		wsched_spawn(w, &a.task);
+		wsched_task_init(&b.task, fib_run, (struct wsched_join*)0);
+		b.n = f->n - 2;
+		fib_run(&b.task, w);
+		wsched_wait(w->sched, w, &j);
+		f->result = a.result + b.result;
+	}
+}
+
+static void item_run(struct wsched_task *const t, struct wsched_worker *const w)
+{
+	struct item_task *const it = WSCHED_ENTRY(t, struct item_task, task);
+	it->runs++;
+	it->worker = wsched_worker_index(w);
+}
+
+/* spawns all items to the deque of the worker */
+static void spawner_run(struct wsched_task *const t, struct wsched_worker *const w)
+{
+	struct wsched_join j;
+	unsigned k;
+	(void)t;
+	wsched_join_init(&j);
+	for (k = 0; k < TASKS; k++) {
+		wsched_task_init(&items[k].task, item_run, &j);
+		wsched_spawn(w, &items[k].task);
+	}
+	wsched_wait(w->sched, w, &j);
+}
+
+static unsigned long fib(const unsigned n)
+{
+	return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+static unsigned long total_runs(void)
+{
+	unsigned long n = 0;
+	unsigned k;
+	for (k = 0; k < WORKERS; k++)
+		n += runs[k];
+	return n;
+}
+
+static void reset_items(void)
+{
+	unsigned k;
+	for (k = 0; k < TASKS; k++) {
+		items[k].runs = 0;
+		items[k].worker = WORKERS;
+	}
+}
+
+static int check_items(void)
+{
+	unsigned k;
+	for (k = 0; k < TASKS; k++)
+		if (items[k].runs != 1 || items[k].worker >= WORKERS)
+			return 0;
+	return 1;
+}
+
+/* deque operations without worker threads */
+static void test_deque(void)
+{
+	struct wsched s;
+	struct wsched_worker w[2];
+	struct wsched_ring_ *r;
+	unsigned k;
+	int retry = 0;
+	s.workers = w;
+	s.count = 2;
+	s.injected = 0;
+	for (k = 0; k < 2; k++) {
+		w[k].top = 0;
+		w[k].bottom = 0;
+		w[k].sched = &s;
+		w[k].index = k;
+		w[k].rnd = 1;
+		w[k].ring = wsched_ring_alloc_(4);
+		CHECK(w[k].ring != NULL);
+	}
+	CHECK(!wsched_take_(&w[0]));
+	CHECK(!wsched_steal_(&w[0], &retry));
+	CHECK(!retry);
+
+	/* the ring grows */
+	for (k = 0; k < 100; k++)
+		CHECK(wsched_push_(&w[0], &items[k].task));
+	CHECK(w[0].ring->mask == 127);
+
+	/* the owner takes the newest tasks, thieves - the oldest ones */
+	CHECK(wsched_take_(&w[0]) == &items[99].task);
+	CHECK(wsched_steal_(&w[0], &retry) == &items[0].task);
+	CHECK(wsched_find_(&w[1], &retry) == &items[1].task);
+	CHECK(wsched_find_(&w[0], &retry) == &items[98].task);
+	for (k = 2; k < 98; k++)
+		CHECK(wsched_find_(&w[1], &retry) == &items[k].task);
+	CHECK(!wsched_find_(&w[0], &retry));
+	CHECK(!wsched_find_(&w[1], &retry));
+	CHECK(!retry);
+
+	/* the ring wraps around */
+	for (k = 0; k < 1000; k++) {
+		CHECK(wsched_push_(&w[1], &items[k].task));
+		if (k >= 3)
+			CHECK(wsched_steal_(&w[1], &retry) == &items[k - 3].task);
+	}
+	CHECK(wsched_take_(&w[1]) == &items[999].task);
+	CHECK(wsched_steal_(&w[1], &retry) == &items[997].task);
+	CHECK(wsched_take_(&w[1]) == &items[998].task);
+	CHECK(!wsched_take_(&w[1]));
+	CHECK(w[1].ring->mask == 3);
+
+	for (k = 0; k < 2; k++) {
+		for (r = w[k].ring; r;) {
+			struct wsched_ring_ *const prev = r->prev;
+			free(r);
+			r = prev;
+		}
+	}
+}
+
+static void test_start(void)
+{
+	struct wsched s;
+	CHECK(wsched_start(&s, 0) == EINVAL);
+	CHECK(!wsched_start(&s, 1));
+	wsched_stop(&s);
+	CHECK(!wsched_start(&s, WORKERS));
+	wsched_stop(&s);
+}
+
+/* fork-join tasks spawned by workers */
+static void test_fib(void)
+{
+	struct wsched s;
+	struct wsched_join j;
+	struct fib_task f;
+	unsigned k;
+	CHECK(!wsched_start(&s, WORKERS));
+	for (k = 0; k < 25; k += 4) {
+		const unsigned long before = total_runs();
+		wsched_join_init(&j);
+		wsched_task_init(&f.task, fib_run, &j);
+		f.n = k;
+		f.result = 0;
+		wsched_submit(&s, &f.task);
+		wsched_wait(&s, NULL, &j);
+		CHECK(f.result == fib(k));
+		CHECK(total_runs() - before == 2*fib(k + 1) - 1);
+	}
+	wsched_stop(&s);
+}
+
+/* tasks submitted by non-worker thread, workers park between rounds */
+static void test_submit(void)
+{
+	struct wsched s;
+	struct wsched_join j;
+	unsigned k, round;
+	CHECK(!wsched_start(&s, WORKERS));
+	for (round = 0; round < 20; round++) {
+		reset_items();
+		wsched_join_init(&j);
+		for (k = 0; k < TASKS; k++) {
+			wsched_task_init(&items[k].task, item_run, &j);
+			wsched_submit(&s, &items[k].task);
+		}
+		wsched_wait(&s, NULL, &j);
+		CHECK(check_items());
+		CHECK(!j.state);
+	}
+	wsched_stop(&s);
+}
+
+/* many tasks in the deque of one worker are stolen by others */
+static void test_spawn(void)
+{
+	struct wsched s;
+	struct wsched_join j;
+	struct wsched_task spawner;
+	unsigned round;
+	CHECK(!wsched_start(&s, WORKERS));
+	for (round = 0; round < 20; round++) {
+		reset_items();
+		wsched_join_init(&j);
+		wsched_task_init(&spawner, spawner_run, &j);
+		wsched_submit(&s, &spawner);
+		wsched_wait(&s, NULL, &j);
+		CHECK(check_items());
+	}
+	wsched_stop(&s);
+}
+
+int main(void)
+{
+	test_deque();
+	test_start();
+	test_fib();
+	test_submit();
+	test_spawn();
+	return test_result();
+}
@@ -0,0 +1,35 @@
+#!/bin/bash
+
+# to check clang, run as
+# CC=clang CXX="clang++ -Wno-deprecated" ./wsched_test.sh
+
+step=0
+
+test "x$CC" = "x"  && CC=gcc
+test "x$CXX" = "x" && CXX=g++
+
+Step() {
+  echo "step: $step"
+  step=$((step + 1))
+  return 0
+}
+
+Exit() {
+  echo "failed!"
+  exit 1
+}
+
+Step && $CC -Wall -pedantic -Wextra -pthread ./wsched_test.c -o ./wsched_test || Exit
+Step && ./wsched_test || Exit
+
+Step && $CC -Wall -pedantic -Wextra -pthread -DWSCHED_SPINS=1 ./wsched_test.c -o ./wsched_test_park || Exit
+Step && ./wsched_test_park || Exit
+
+Step && $CXX -x c++ -Wall -pedantic -Wextra -pthread ./wsched_test.c -o ./wsched_test_cxx || Exit
+Step && ./wsched_test_cxx || Exit
+
+# should not be compiled
+Step && $CC -pthread -c wsched_test.c -o wsched_test.o -DBAD1 && Exit
+Step && $CXX -x c++ -pthread -c wsched_test.c -o wsched_test.o -DBAD1 && Exit
+
+echo "=============== all tests OK ==============="
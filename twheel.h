@@ -0,0 +1,380 @@
+#ifndef TWHEEL_H_INCLUDED
+#define TWHEEL_H_INCLUDED
+
+/**********************************************************************************
+* Hierarchical timer wheel
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* twheel.h */
+
+/* defines:
+
+  struct twheel_timer                   - timer, embedded in an element,
+  struct twheel                         - timer wheel,
+
+  twheel_init(w, now)                   - initialize timer wheel, now - current time, in ticks,
+  twheel_now(w)                         - current time of the wheel,
+  twheel_timer_init(t)                  - initialize timer, so it is not pending,
+  twheel_is_pending(t)                  - check if timer is added and has not expired nor been cancelled,
+  twheel_add(w, t, expires)             - add not pending timer, O(1),
+  twheel_cancel(t)                      - cancel timer if it is pending, O(1),
+  twheel_mod(w, t, expires)             - change expiration time of (pending?) timer, O(1),
+  twheel_advance(w, now, expired)       - advance the time, move expired timers to the list,
+  twheel_expire(w, now, fn, ctx)        - advance the time, call a callback for each expired timer,
+  twheel_next_tick(w)                   - the earliest time when a timer may expire, to limit the wait of event loop,
+
+  TWHEEL_ENTRY(t, type, member)         - get element containing the timer, CONTAINER_OF() (see "ccasts.h").
+
+  The wheel does not allocate memory: a timer is a link of an intrusive list (see "dlist.h") and
+  its expiration time.
+*/
+
+/* usage:
+
+struct conn {
+	int fd;
+	struct twheel_timer idle; // idle timeout
+};
+
+static void conn_idle_timeout(struct twheel_timer *const t, void *const ctx)
+{
+	struct conn *const c = TWHEEL_ENTRY(t, struct conn, idle);
+	... close connection ...
+}
+
+struct twheel timers;
+twheel_init(&timers, now_ms());
+
+// on new connection
+twheel_timer_init(&c->idle);
+twheel_add(&timers, &c->idle, now_ms() + 30000);
+
+// on activity: restart the timer
+twheel_mod(&timers, &c->idle, now_ms() + 30000);
+
+// on close
+twheel_cancel(&c->idle);
+
+// in the event loop
+for (;;) {
+	const unsigned long long next = twheel_next_tick(&timers);
+	... wait for events at most until next ...
+	(void)twheel_expire(&timers, now_ms(), conn_idle_timeout, NULL);
+}
+*/
+
+/* Implementation notes:
+
+  1) the wheel has TWHEEL_LEVELS levels of 64 slots - lists of timers, a slot of level L covers 64^L ticks:
+    a timer is added to the level by the distance to its expiration time and to the slot by the expiration time,
+  2) when the time reaches the beginning of a slot of a higher level, timers of that slot are re-added
+    (cascaded) to lower levels, so a timer is moved at most TWHEEL_LEVELS - 1 times during its life,
+    most timers (e.g. timeouts which are restarted or cancelled) are never moved,
+  3) timers that expire later than 64^TWHEEL_LEVELS ticks are added to the last slot of the highest level
+    and are re-added when the slot is cascaded,
+  4) each level has a bitmap of non-empty slots, so advancing the time skips empty slots: cancelled timers
+    do not clear the bits - a bit may be set for an empty slot,
+  5) expired timers are moved to a list in a batch, by splicing whole slots, timers expired at the same tick
+    are in the order of adding, timers expired at earlier ticks are before timers expired at later ticks,
+  6) a timer added with the expiration time not later than the current time expires on the next tick. */
+
+#include "dlist.h"  /* for struct dlist_entry */
+#include "static_asserts.h"
+
+#ifdef _MSC_VER
+#include <intrin.h> /* for _BitScanForward() */
+#endif
+
+/* number of levels of the wheel, the range of the wheel is 64^TWHEEL_LEVELS ticks */
+#ifndef TWHEEL_LEVELS
+#define TWHEEL_LEVELS 6
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TWHEEL_SLOTS_  64u
+#define TWHEEL_RANGE_  (1llu << 6*TWHEEL_LEVELS)
+
+/* timers beyond the range are cascaded from the highest level, the range must fit unsigned long long */
+STATIC_ASSERT1(TWHEEL_LEVELS > 1 && TWHEEL_LEVELS < 11, twheel_levels);
+
+struct twheel_timer {
+	struct dlist_entry link;        /* link in a slot of the wheel, empty if timer is not pending */
+	unsigned long long expires;     /* expiration time, in ticks */
+};
+
+struct twheel {
+	unsigned long long now;                                 /* current time, all ticks up to it are processed */
+	unsigned long long bits[TWHEEL_LEVELS];                 /* bitmaps of (maybe) non-empty slots */
+	struct dlist_entry slots[TWHEEL_LEVELS][TWHEEL_SLOTS_];
+};
+
+/* called for expired timer, which is already not pending - it may be added again */
+typedef void twheel_fn_t(struct twheel_timer *t, void *ctx);
+
+/* get element containing the timer, t - pointer to const timer requires const type */
+#define TWHEEL_ENTRY(t, type, member)  CONTAINER_OF(t, type, member)
+
+A_Const_function
+A_Force_inline_function
+static unsigned twheel_ctz_(const unsigned long long v/*!=0*/)
+{
+#if defined __GNUC__ || defined __clang__
+	return (unsigned)__builtin_ctzll(v);
+#elif defined _MSC_VER
+	unsigned long i;
+	if ((unsigned)v) {
+		(void)_BitScanForward(&i, (unsigned)v);
+		return (unsigned)i;
+	}
+	(void)_BitScanForward(&i, (unsigned)(v >> 32));
+	return 32u + (unsigned)i;
+#else
+	unsigned i = 0;
+	unsigned long long x = v;
+	for (; !(x & 1); x >>= 1)
+		i++;
+	return i;
+#endif
+}
+
+/* level of the wheel for the distance to expiration time */
+A_Const_function
+A_Force_inline_function
+static unsigned twheel_level_(unsigned long long delta/*<TWHEEL_RANGE_*/)
+{
+	unsigned l = 0;
+	while (delta >= TWHEEL_SLOTS_) {
+		delta >>= 6;
+		l++;
+	}
+	return l;
+}
+
+static void twheel_init(
+	struct twheel *const w/*!=NULL,out*/,
+	const unsigned long long now)
+{
+	unsigned l = 0;
+	w->now = now;
+	for (; l < TWHEEL_LEVELS; l++) {
+		unsigned s = 0;
+		w->bits[l] = 0;
+		for (; s < TWHEEL_SLOTS_; s++)
+			dlist_init(&w->slots[l][s]);
+	}
+}
+
+A_Force_inline_function
+static unsigned long long twheel_now(const struct twheel *const w/*!=NULL*/)
+{
+	return w->now;
+}
+
+A_Force_inline_function
+static void twheel_timer_init(struct twheel_timer *const t/*!=NULL,out*/)
+{
+	dlist_init(&t->link);
+	t->expires = 0;
+}
+
+A_Force_inline_function
+static int twheel_is_pending(const struct twheel_timer *const t/*!=NULL*/)
+{
+	return !dlist_is_empty(&t->link);
+}
+
+/* link timer to the slot, e - expiration time, not less than the current time */
+A_Force_inline_function
+static void twheel_link_(
+	struct twheel *const w/*!=NULL*/,
+	struct twheel_timer *const t/*!=NULL*/,
+	unsigned long long e)
+{
+	unsigned long long delta = e - w->now;
+	unsigned l, s;
+	if (delta >= TWHEEL_RANGE_) {
+		delta = TWHEEL_RANGE_ - 1;
+		e = w->now + delta;
+	}
+	l = twheel_level_(delta);
+	s = (unsigned)(e >> 6*l) & (TWHEEL_SLOTS_ - 1);
+	w->bits[l] |= 1llu << s;
+	dlist_add_tail(&w->slots[l][s], &t->link);
+}
+
+/* add not pending timer, expires - expiration time, in ticks */
+A_Force_inline_function
+static void twheel_add(
+	struct twheel *const w/*!=NULL*/,
+	struct twheel_timer *const t/*!=NULL,!pending*/,
+	const unsigned long long expires)
+{
+	ASSERT(!twheel_is_pending(t));
+	t->expires = expires;
+	/* the slot of current tick is already processed */
+	twheel_link_(w, t, expires > w->now ? expires : w->now + 1);
+}
+
+/* returns non-zero if timer was pending */
+A_Force_inline_function
+static int twheel_cancel(struct twheel_timer *const t/*!=NULL*/)
+{
+	if (!twheel_is_pending(t))
+		return 0;
+	dlist_remove_init(&t->link);
+	return 1;
+}
+
+A_Force_inline_function
+static void twheel_mod(
+	struct twheel *const w/*!=NULL*/,
+	struct twheel_timer *const t/*!=NULL*/,
+	const unsigned long long expires)
+{
+	(void)twheel_cancel(t);
+	twheel_add(w, t, expires);
+}
+
+/* re-add timers of the slot of higher level to lower levels */
+static void twheel_cascade_(
+	struct twheel *const w/*!=NULL*/,
+	const unsigned l/*>0,<TWHEEL_LEVELS*/,
+	const unsigned s/*<TWHEEL_SLOTS_*/)
+{
+	struct dlist_entry list;
+	struct dlist_entry *e;
+	if (!(w->bits[l] & (1llu << s)))
+		return;
+	w->bits[l] &= ~(1llu << s);
+	dlist_init(&list);
+	dlist_splice_tail(&list, &w->slots[l][s]);
+	while ((e = dlist_first(&list)) != (struct dlist_entry*)0) {
+		struct twheel_timer *const t = TWHEEL_ENTRY(e, struct twheel_timer, link);
+		dlist_remove(e);
+		/* timer may expire at the current tick - its slot is processed after cascading */
+		twheel_link_(w, t, t->expires > w->now ? t->expires : w->now);
+	}
+}
+
+/* get the earliest time after the current one when a (maybe) non-empty slot must be processed:
+  expired, for the first level, or cascaded, for higher levels, returns (unsigned long long)-1 if there are no timers */
+static unsigned long long twheel_next_(const struct twheel *const w/*!=NULL*/)
+{
+	const unsigned long long c = w->now;
+	unsigned long long next = ~0llu;
+	unsigned l = 0;
+	for (; l < TWHEEL_LEVELS; l++) {
+		const unsigned long long b = w->bits[l];
+		if (b) {
+			const unsigned sh = 6*l;
+			const unsigned s = (unsigned)(c >> sh) & (TWHEEL_SLOTS_ - 1);
+			/* start of the round of the level */
+			const unsigned long long base = c & ~((1llu << (sh + 6)) - 1);
+			/* slots after the current one or slots of the next round */
+			const unsigned long long m = b & (~0llu << s << 1);
+			const unsigned long long t = m ? base + ((unsigned long long)twheel_ctz_(m) << sh) :
+				base + ((unsigned long long)(TWHEEL_SLOTS_ + twheel_ctz_(b)) << sh);
+			if (t < next)
+				next = t;
+		}
+	}
+	return next;
+}
+
+/* advance the time of the wheel, now - new current time (not less than the current one),
+  expired timers are moved to the end of the list - they remain pending until unlinked from the list */
+static void twheel_advance(
+	struct twheel *const w/*!=NULL*/,
+	const unsigned long long now,
+	struct dlist_entry *const expired/*!=NULL*/)
+{
+	while (w->now < now) {
+		const unsigned long long next = twheel_next_(w);
+		unsigned s;
+		if (next > now) {
+			w->now = now;
+			break;
+		}
+		w->now = next;
+		if (!(next & (TWHEEL_SLOTS_ - 1))) {
+			/* cascade slots of higher levels, starting from the second one */
+			unsigned l = 1;
+			for (; l < TWHEEL_LEVELS; l++) {
+				const unsigned i = (unsigned)(next >> 6*l) & (TWHEEL_SLOTS_ - 1);
+				twheel_cascade_(w, l, i);
+				if (i)
+					break;
+			}
+		}
+		s = (unsigned)next & (TWHEEL_SLOTS_ - 1);
+		if (w->bits[0] & (1llu << s)) {
+			w->bits[0] &= ~(1llu << s);
+			dlist_splice_tail(expired, &w->slots[0][s]);
+		}
+	}
+}
+
+/* advance the time of the wheel and call the callback for each expired timer,
+  the callback may add or cancel any timers, timers added with expiration time not later than now
+  expire on the next call, returns the number of expired timers */
+static unsigned long long twheel_expire(
+	struct twheel *const w/*!=NULL*/,
+	const unsigned long long now,
+	twheel_fn_t *const fn/*!=NULL*/,
+	void *const ctx)
+{
+	unsigned long long count = 0;
+	struct dlist_entry batch;
+	struct dlist_entry *e;
+	dlist_init(&batch);
+	twheel_advance(w, now, &batch);
+	/* the callback may cancel other expired timers - they are unlinked from the batch */
+	while ((e = dlist_first(&batch)) != (struct dlist_entry*)0) {
+		dlist_remove_init(e);
+		fn(TWHEEL_ENTRY(e, struct twheel_timer, link), ctx);
+		count++;
+	}
+	return count;
+}
+
+/* get the earliest time when a timer may expire - to limit the wait of an event loop,
+  a timer expires at the returned time or later, returns (unsigned long long)-1 if there are no timers */
+A_Force_inline_function
+static unsigned long long twheel_next_tick(const struct twheel *const w/*!=NULL*/)
+{
+	return twheel_next_(w);
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int twheel_init_unused_[sizeof(&twheel_init)];
+typedef int twheel_advance_unused_[sizeof(&twheel_advance)];
+typedef int twheel_expire_unused_[sizeof(&twheel_expire)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* TWHEEL_H_INCLUDED */
@@ -0,0 +1,713 @@
+#ifndef WSCHED_H_INCLUDED
+#define WSCHED_H_INCLUDED
+
+/**********************************************************************************
+* Work-stealing task scheduler
+* Copyright (C) 2022 Michael M. Builov, https://github.com/mbuilov/cmn_headers
+* Licensed under Apache License v2.0, see LICENSE.TXT
+**********************************************************************************/
+
+/* wsched.h */
+
+/* defines:
+
+  struct wsched_task                    - task, embedded in a closure,
+  struct wsched_join                    - counter of spawned, but not yet completed tasks,
+  struct wsched_worker                  - worker thread,
+  struct wsched                         - the scheduler,
+
+  wsched_start(s, workers)              - start worker threads, returns 0, EINVAL, ENOMEM or an error of thread creation,
+  wsched_stop(s)                        - stop worker threads, all tasks must be completed before the call,
+  wsched_task_init(t, run, j)           - initialize the task, j - counter of the task, may be NULL,
+  wsched_join_init(j)                   - initialize the counter,
+  wsched_submit(s, t)                   - add the task to the scheduler, may be called by any thread,
+  wsched_spawn(w, t)                    - add the task to the deque of the worker w, called by a task running in w,
+  wsched_wait(s, w, j)                  - wait until tasks counted by j are completed, w - the worker of the calling
+                                          task, which runs other tasks while waiting, or NULL for a non-worker thread,
+  wsched_worker_index(w)                - index of the worker, in range [0, workers),
+
+  WSCHED_ENTRY(t, type, member)         - get closure containing the task, CONTAINER_OF() (see "ccasts.h").
+*/
+
+/* usage:
+
+struct sum_task {
+	struct wsched_task task;
+	const int *a;
+	size_t n;
+	long long sum;
+};
+
+static void sum_run(struct wsched_task *const t, struct wsched_worker *const w)
+{
+	struct sum_task *const st = WSCHED_ENTRY(t, struct sum_task, task);
+	if (st->n <= 1000)
+		... sum sequentially ...
+	else {
+		struct wsched_join j;
+		struct sum_task left, right;
+		wsched_join_init(&j);
+		wsched_task_init(&left.task, sum_run, &j);
+		left.a = st->a;
+		left.n = st->n/2;
+		wsched_spawn(w, &left.task);     // may be stolen by another worker
+		right.a = st->a + left.n;
+		right.n = st->n - left.n;
+		sum_run(&right.task, w);         // run the other half in place
+		wsched_wait(w->sched, w, &j);    // take back or help thieves
+		st->sum = left.sum + right.sum;
+	}
+}
+
+struct wsched s;
+if (wsched_start(&s, 8))
+	... failed ...
+
+struct wsched_join j;
+struct sum_task root = {...};
+wsched_join_init(&j);
+wsched_task_init(&root.task, sum_run, &j);
+wsched_submit(&s, &root.task);
+wsched_wait(&s, NULL, &j);
+
+wsched_stop(&s);
+*/
+
+/* Implementation notes:
+
+  1) each worker has a Chase-Lev deque of tasks: the worker pushes and takes tasks at the bottom end without
+    atomic read-modify-write operations (only a memory barrier on take), other workers steal tasks from the
+    top end with one CAS - so the most recently spawned (smallest) task is run by its creator, while thieves
+    take the oldest (biggest) ones,
+  2) the deque is a ring buffer, which is doubled when it becomes full: retired rings may be read by thieves,
+    so they are freed only by wsched_stop(), this costs no more memory than the biggest ring,
+  3) an idle worker takes tasks from its deque, then steals from other workers, starting from a random one,
+    then takes tasks submitted by non-worker threads - they are added to the intrusive MPSC queue (see
+    "mpsc_queue.h"), consumed by one worker at a time,
+  4) a worker that found no tasks spins WSCHED_SPINS times, then parks: on Linux - via futex, on Windows
+    (since Windows 8) - via WaitOnAddress(), else via a condition variable,
+  5) to not lose a wakeup, a parking worker increments the number of sleepers and searches for tasks once
+    more, while wsched_submit() and wsched_spawn() add a task, then check the number of sleepers - both sides
+    are separated by full memory barriers, so at least one of them sees the other,
+  6) wsched_wait() called by a worker runs other tasks, possibly not related to the joined ones - this
+    keeps all workers busy, but increases the stack depth of the waiting worker,
+  7) the counter of a join is stored shifted left by 1 bit, the low bit is set by a parked waiter: the task
+    that completes the last counted one wakes the waiter only if it is set. */
+
+#include <stddef.h> /* for size_t, ptrdiff_t, offsetof() */
+#include <stdlib.h> /* for malloc() */
+#include <errno.h>  /* for EINVAL, ENOMEM */
+#include <limits.h> /* for INT_MAX */
+#include "atomics.h"
+#include "ccasts.h"         /* for CONTAINER_OF(), ASSERT() */
+#include "layout_asserts.h" /* for CACHE_LINE_SIZE, STATIC_ASSERT_DIFFERENT_CACHE_LINES() */
+#include "mpsc_queue.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "synchronization.lib") /* for WaitOnAddress() */
+#endif
+#else
+#include <pthread.h>
+#include <unistd.h>
+#if defined __linux__ && (defined _GNU_SOURCE || defined _DEFAULT_SOURCE || defined _BSD_SOURCE)
+#include <sys/syscall.h> /* for SYS_futex */
+#include <linux/futex.h> /* for FUTEX_WAIT_PRIVATE */
+#ifdef SYS_futex
+#define WSCHED_FUTEX_
+#endif
+#endif
+#ifndef WSCHED_FUTEX_
+#define WSCHED_CONDVAR_
+#endif
+#endif
+
+/* initial number of tasks in the deque of a worker, power of 2 */
+#ifndef WSCHED_DEQUE_SIZE
+#define WSCHED_DEQUE_SIZE 256
+#endif
+
+/* number of attempts to find a task before parking */
+#ifndef WSCHED_SPINS
+#define WSCHED_SPINS 1000
+#endif
+
+#ifndef WSCHED_MALLOC
+#define WSCHED_MALLOC(sz) malloc(sz)
+#endif
+
+#ifndef WSCHED_FREE
+#define WSCHED_FREE(p) free(p)
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4505) /* unreferenced local function has been removed */
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunneeded-internal-declaration"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct wsched_task;
+struct wsched_worker;
+
+typedef void wsched_run_t(struct wsched_task *t, struct wsched_worker *w);
+
+struct wsched_join {
+	int state;                      /* number of tasks << 1 | parked waiter */
+};
+
+struct wsched_task {
+	struct mpsc_node node;          /* link in the queue of submitted tasks */
+	wsched_run_t *run;
+	struct wsched_join *join;       /* NULL if the task is not counted */
+};
+
+struct wsched_ring_ {
+	struct wsched_ring_ *prev;      /* retired ring */
+	size_t mask;                    /* size - 1 */
+	struct wsched_task *tasks[1];
+};
+
+#ifdef _WIN32
+typedef HANDLE wsched_thread_t_;
+#else
+typedef pthread_t wsched_thread_t_;
+#endif
+
+struct wsched_worker {
+	ptrdiff_t top;                  /* the end of the deque where tasks are stolen, modified by thieves */
+	char pad1_[CACHE_LINE_SIZE];
+	ptrdiff_t bottom;               /* the end of the deque where tasks are pushed and taken by the worker */
+	struct wsched_ring_ *ring;
+	struct wsched *sched;
+	unsigned index;
+	unsigned rnd;                   /* state of the generator of random victims */
+	wsched_thread_t_ thread;
+	char pad2_[CACHE_LINE_SIZE];
+};
+
+struct wsched {
+	struct wsched_worker *workers;
+	unsigned count;
+	int stop;
+	char pad1_[CACHE_LINE_SIZE];
+	int injected;                   /* number of submitted tasks not yet taken by workers */
+	int inject_lock;                /* held by the worker taking a submitted task */
+	struct mpsc_queue inject;       /* submitted tasks */
+	char pad2_[CACHE_LINE_SIZE];
+	int sleepers;                   /* number of workers that are parked or going to park */
+	int epoch;                      /* parked workers wait for its change */
+	char pad3_[CACHE_LINE_SIZE];
+#ifdef WSCHED_CONDVAR_
+	pthread_mutex_t park_lock;
+	pthread_cond_t park_cond;
+#endif
+};
+
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct wsched_worker, top, bottom);
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct wsched, stop, injected);
+STATIC_ASSERT_DIFFERENT_CACHE_LINES(struct wsched, inject_lock, sleepers);
+
+/* get closure containing the task, t - pointer to const task requires const type */
+#define WSCHED_ENTRY(t, type, member) CONTAINER_OF(t, type, member)
+
+A_Force_inline_function
+static void wsched_join_init(struct wsched_join *const j/*!=NULL,out*/)
+{
+	j->state = 0;
+}
+
+A_Force_inline_function
+static void wsched_task_init(
+	struct wsched_task *const t/*!=NULL,out*/,
+	wsched_run_t *const run/*!=NULL*/,
+	struct wsched_join *const j/*NULL?*/)
+{
+	t->run = run;
+	t->join = j;
+}
+
+A_Force_inline_function
+static unsigned wsched_worker_index(const struct wsched_worker *const w/*!=NULL*/)
+{
+	return w->index;
+}
+
+/* wait while *addr == val, may return spuriously */
+A_Force_inline_function
+static void wsched_park_(
+	struct wsched *const s/*!=NULL*/,
+	int *const addr/*!=NULL*/,
+	int val)
+{
+#if defined WSCHED_FUTEX_
+	(void)s;
+	(void)syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, (void*)0, (void*)0, 0);
+#elif defined _WIN32
+	(void)s;
+	(void)WaitOnAddress(addr, &val, sizeof(val), INFINITE);
+#else
+	(void)pthread_mutex_lock(&s->park_lock);
+	if ((int)ATOMIC_LOAD(addr, ATOMIC_RELAXED) == val)
+		(void)pthread_cond_wait(&s->park_cond, &s->park_lock);
+	(void)pthread_mutex_unlock(&s->park_lock);
+#endif
+}
+
+/* wake threads waiting for a change of *addr, addr may point to freed memory */
+A_Force_inline_function
+static void wsched_unpark_(
+	struct wsched *const s/*!=NULL*/,
+	int *const addr/*!=NULL*/,
+	const int all)
+{
+#if defined WSCHED_FUTEX_
+	(void)s;
+	(void)syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, (void*)0, (void*)0, 0);
+#elif defined _WIN32
+	(void)s;
+	if (all)
+		WakeByAddressAll(addr);
+	else
+		WakeByAddressSingle(addr);
+#else
+	/* all parked threads wait on the same condition variable */
+	(void)addr, (void)all;
+	(void)pthread_mutex_lock(&s->park_lock);
+	(void)pthread_cond_broadcast(&s->park_cond);
+	(void)pthread_mutex_unlock(&s->park_lock);
+#endif
+}
+
+static struct wsched_ring_ *wsched_ring_alloc_(const size_t size/*power of 2*/)
+{
+	struct wsched_ring_ *r;
+	if (size > ((size_t)-1 - offsetof(struct wsched_ring_, tasks))/sizeof(r->tasks[0]))
+		return (struct wsched_ring_*)0;
+	r = (struct wsched_ring_*)WSCHED_MALLOC(offsetof(struct wsched_ring_, tasks) + size*sizeof(r->tasks[0]));
+	if (r) {
+		r->prev = (struct wsched_ring_*)0;
+		r->mask = size - 1;
+	}
+	return r;
+}
+
+/* double the ring, called by the owner of the deque, returns NULL if failed to allocate memory */
+static struct wsched_ring_ *wsched_grow_(
+	struct wsched_worker *const w/*!=NULL*/,
+	ptrdiff_t top,
+	const ptrdiff_t bottom)
+{
+	struct wsched_ring_ *const old = w->ring;
+	struct wsched_ring_ *const r = wsched_ring_alloc_((old->mask + 1)*2);
+	if (r) {
+		for (; top < bottom; top++)
+			r->tasks[(size_t)top & r->mask] = old->tasks[(size_t)top & old->mask];
+		r->prev = old;
+		ATOMIC_STORE_PTR(&w->ring, r, ATOMIC_RELEASE);
+	}
+	return r;
+}
+
+/* push the task to the bottom of the deque, called by the owner,
+  returns 0 if failed to allocate memory */
+A_Force_inline_function
+static int wsched_push_(
+	struct wsched_worker *const w/*!=NULL*/,
+	struct wsched_task *const t/*!=NULL*/)
+{
+	const ptrdiff_t b = w->bottom;
+	const ptrdiff_t top = (ptrdiff_t)ATOMIC_LOAD(&w->top, ATOMIC_ACQUIRE);
+	struct wsched_ring_ *r = w->ring;
+	if ((size_t)(b - top) > r->mask) {
+		r = wsched_grow_(w, top, b);
+		if (!r)
+			return 0;
+	}
+	/* slot may be read by a thief that is going to fail its CAS */
+	ATOMIC_STORE_PTR(&r->tasks[(size_t)b & r->mask], t, ATOMIC_RELAXED);
+	ATOMIC_STORE(&w->bottom, b + 1, ATOMIC_RELEASE);
+	return 1;
+}
+
+/* take the task from the bottom of the deque, called by the owner, returns NULL if the deque is empty */
+A_Force_inline_function
+static struct wsched_task *wsched_take_(struct wsched_worker *const w/*!=NULL*/)
+{
+	const ptrdiff_t b = w->bottom - 1;
+	ptrdiff_t top = (ptrdiff_t)ATOMIC_LOAD(&w->top, ATOMIC_RELAXED);
+	struct wsched_task *t;
+	if (top > b)
+		return (struct wsched_task*)0; /* fast path: top never decreases */
+	ATOMIC_STORE(&w->bottom, b, ATOMIC_RELAXED);
+	ATOMIC_FENCE(ATOMIC_SEQ_CST);
+	top = (ptrdiff_t)ATOMIC_LOAD(&w->top, ATOMIC_RELAXED);
+	if (top > b) {
+		/* thieves have taken the last task */
+		ATOMIC_STORE(&w->bottom, b + 1, ATOMIC_RELAXED);
+		return (struct wsched_task*)0;
+	}
+	t = w->ring->tasks[(size_t)b & w->ring->mask];
+	if (top == b) {
+		/* the last task: race with thieves */
+		if (!ATOMIC_CAS(&w->top, &top, top + 1, ATOMIC_SEQ_CST, ATOMIC_RELAXED))
+			t = (struct wsched_task*)0;
+		ATOMIC_STORE(&w->bottom, b + 1, ATOMIC_RELAXED);
+	}
+	return t;
+}
+
+/* steal the task from the top of the deque of the victim,
+  returns NULL if the deque is empty or another thread has taken the task - then sets *retry */
+static struct wsched_task *wsched_steal_(
+	struct wsched_worker *const v/*!=NULL*/,
+	int *const retry/*!=NULL,out*/)
+{
+	ptrdiff_t top = (ptrdiff_t)ATOMIC_LOAD(&v->top, ATOMIC_ACQUIRE);
+	ptrdiff_t b;
+	ATOMIC_FENCE(ATOMIC_SEQ_CST);
+	b = (ptrdiff_t)ATOMIC_LOAD(&v->bottom, ATOMIC_ACQUIRE);
+	if (top < b) {
+		/* the ring is loaded after the bottom, so it contains the task at the top */
+		const struct wsched_ring_ *const r = ATOMIC_LOAD_PTR(&v->ring, ATOMIC_ACQUIRE);
+		struct wsched_task *const t = ATOMIC_LOAD_PTR(&r->tasks[(size_t)top & r->mask], ATOMIC_RELAXED);
+		if (ATOMIC_CAS(&v->top, &top, top + 1, ATOMIC_SEQ_CST, ATOMIC_RELAXED))
+			return t;
+		*retry = 1;
+	}
+	return (struct wsched_task*)0;
+}
+
+/* take the task submitted by a non-worker thread */
+static struct wsched_task *wsched_take_submitted_(
+	struct wsched *const s/*!=NULL*/,
+	int *const retry/*!=NULL,out*/)
+{
+	struct mpsc_node *n;
+	if (!ATOMIC_LOAD(&s->injected, ATOMIC_RELAXED))
+		return (struct wsched_task*)0;
+	if (ATOMIC_LOAD(&s->inject_lock, ATOMIC_RELAXED) || ATOMIC_EXCHANGE(&s->inject_lock, 1, ATOMIC_ACQUIRE)) {
+		*retry = 1;
+		return (struct wsched_task*)0;
+	}
+	n = mpsc_queue_pop(&s->inject);
+	ATOMIC_STORE(&s->inject_lock, 0, ATOMIC_RELEASE);
+	if (!n) {
+		/* the task is being submitted */
+		*retry = 1;
+		return (struct wsched_task*)0;
+	}
+	(void)ATOMIC_FETCH_SUB(&s->injected, 1, ATOMIC_RELAXED);
+	return MPSC_ENTRY(n, struct wsched_task, node);
+}
+
+/* returns NULL if no tasks were found, sets *retry if there may be tasks that were not taken */
+static struct wsched_task *wsched_find_(
+	struct wsched_worker *const w/*!=NULL*/,
+	int *const retry/*!=NULL,out*/)
+{
+	struct wsched *const s = w->sched;
+	struct wsched_task *t = wsched_take_(w);
+	if (!t && s->count > 1) {
+		/* xorshift */
+		unsigned x = w->rnd, i;
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		w->rnd = x;
+		for (i = 0; i < s->count; i++) {
+			struct wsched_worker *const v = &s->workers[(x + i) % s->count];
+			if (v != w) {
+				t = wsched_steal_(v, retry);
+				if (t)
+					return t;
+			}
+		}
+	}
+	if (!t)
+		t = wsched_take_submitted_(s, retry);
+	return t;
+}
+
+/* wake a parked worker, if any, after a task was added */
+A_Force_inline_function
+static void wsched_notify_(struct wsched *const s/*!=NULL*/)
+{
+	ATOMIC_FENCE(ATOMIC_SEQ_CST);
+	if (ATOMIC_LOAD(&s->sleepers, ATOMIC_RELAXED)) {
+		(void)ATOMIC_FETCH_ADD(&s->epoch, 1, ATOMIC_RELEASE);
+		wsched_unpark_(s, &s->epoch, /*all:*/0);
+	}
+}
+
+A_Force_inline_function
+static void wsched_join_add_(struct wsched_join *const j/*NULL?*/)
+{
+	if (j)
+		(void)ATOMIC_FETCH_ADD(&j->state, 2, ATOMIC_RELAXED);
+}
+
+static void wsched_run_(
+	struct wsched_worker *const w/*!=NULL*/,
+	struct wsched_task *const t/*!=NULL*/)
+{
+	/* the task may be freed by run() */
+	struct wsched_join *const j = t->join;
+	t->run(t, w);
+	if (j && 3 == (int)ATOMIC_FETCH_SUB(&j->state, 2, ATOMIC_SEQ_CST))
+		wsched_unpark_(w->sched, &j->state, /*all:*/1); /* the last task, the waiter is parked */
+}
+
+A_Force_inline_function
+static void wsched_submit(
+	struct wsched *const s/*!=NULL*/,
+	struct wsched_task *const t/*!=NULL*/)
+{
+	wsched_join_add_(t->join);
+	(void)ATOMIC_FETCH_ADD(&s->injected, 1, ATOMIC_RELAXED);
+	mpsc_queue_push(&s->inject, &t->node);
+	wsched_notify_(s);
+}
+
+A_Force_inline_function
+static void wsched_spawn(
+	struct wsched_worker *const w/*!=NULL*/,
+	struct wsched_task *const t/*!=NULL*/)
+{
+	wsched_join_add_(t->join);
+	if (wsched_push_(w, t))
+		wsched_notify_(w->sched);
+	else
+		wsched_run_(w, t); /* out of memory: run the task in place */
+}
+
+static void wsched_wait(
+	struct wsched *const s/*!=NULL*/,
+	struct wsched_worker *const w/*NULL?*/,
+	struct wsched_join *const j/*!=NULL*/)
+{
+	unsigned spins = 0;
+	for (;;) {
+		int state = (int)ATOMIC_LOAD(&j->state, ATOMIC_ACQUIRE);
+		if (state < 2)
+			break;
+		if (w) {
+			int retry = 0;
+			struct wsched_task *const t = wsched_find_(w, &retry);
+			if (t) {
+				wsched_run_(w, t);
+				spins = 0;
+				continue;
+			}
+			if (retry)
+				continue;
+		}
+		if (++spins < WSCHED_SPINS) {
+			CPU_RELAX();
+			continue;
+		}
+		/* park until the last counted task is completed */
+		if (!(state & 1) && !ATOMIC_CAS(&j->state, &state, state | 1, ATOMIC_SEQ_CST, ATOMIC_RELAXED))
+			continue;
+		wsched_park_(s, &j->state, state | 1);
+		spins = 0;
+	}
+	/* clear the flag of parked waiter */
+	if (ATOMIC_LOAD(&j->state, ATOMIC_RELAXED))
+		ATOMIC_STORE(&j->state, 0, ATOMIC_RELAXED);
+}
+
+static void wsched_worker_loop_(struct wsched_worker *const w/*!=NULL*/)
+{
+	struct wsched *const s = w->sched;
+	unsigned spins = 0;
+	for (;;) {
+		int retry = 0;
+		struct wsched_task *t = wsched_find_(w, &retry);
+		if (!t) {
+			int epoch;
+			if (retry || ++spins < WSCHED_SPINS) {
+				CPU_RELAX();
+				continue;
+			}
+			spins = 0;
+			epoch = (int)ATOMIC_LOAD(&s->epoch, ATOMIC_ACQUIRE);
+			(void)ATOMIC_FETCH_ADD(&s->sleepers, 1, ATOMIC_SEQ_CST);
+			ATOMIC_FENCE(ATOMIC_SEQ_CST);
+			if (ATOMIC_LOAD(&s->stop, ATOMIC_RELAXED)) {
+				(void)ATOMIC_FETCH_SUB(&s->sleepers, 1, ATOMIC_RELAXED);
+				break;
+			}
+			/* search again: a task may be added before the number of sleepers was incremented */
+			t = wsched_find_(w, &retry);
+			if (!t && !retry)
+				wsched_park_(s, &s->epoch, epoch);
+			(void)ATOMIC_FETCH_SUB(&s->sleepers, 1, ATOMIC_RELAXED);
+			if (!t)
+				continue;
+		}
+		wsched_run_(w, t);
+		spins = 0;
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI wsched_thread_(LPVOID arg)
+{
+	wsched_worker_loop_((struct wsched_worker*)arg);
+	return 0;
+}
+#else
+static void *wsched_thread_(void *arg)
+{
+	wsched_worker_loop_((struct wsched_worker*)arg);
+	return (void*)0;
+}
+#endif
+
+/* stop started threads, free memory */
+static void wsched_stop_(
+	struct wsched *const s/*!=NULL*/,
+	const unsigned started)
+{
+	unsigned i;
+	ATOMIC_STORE(&s->stop, 1, ATOMIC_SEQ_CST);
+	(void)ATOMIC_FETCH_ADD(&s->epoch, 1, ATOMIC_SEQ_CST);
+	wsched_unpark_(s, &s->epoch, /*all:*/1);
+	for (i = 0; i < started; i++) {
+#ifdef _WIN32
+		(void)WaitForSingleObject(s->workers[i].thread, INFINITE);
+		(void)CloseHandle(s->workers[i].thread);
+#else
+		(void)pthread_join(s->workers[i].thread, (void**)0);
+#endif
+	}
+	for (i = 0; i < s->count; i++) {
+		struct wsched_ring_ *r = s->workers[i].ring;
+		while (r) {
+			struct wsched_ring_ *const prev = r->prev;
+			WSCHED_FREE(r);
+			r = prev;
+		}
+	}
+#ifdef WSCHED_CONDVAR_
+	(void)pthread_cond_destroy(&s->park_cond);
+	(void)pthread_mutex_destroy(&s->park_lock);
+#endif
+	WSCHED_FREE(s->workers);
+}
+
+/* all tasks must be completed */
+A_Force_inline_function
+static void wsched_stop(struct wsched *const s/*!=NULL*/)
+{
+	ASSERT(!ATOMIC_LOAD(&s->injected, ATOMIC_RELAXED));
+	wsched_stop_(s, s->count);
+}
+
+/* returns 0, EINVAL if count is 0 or too big, ENOMEM if failed to allocate memory,
+  or an error code if failed to create a thread */
+static int wsched_start(
+	struct wsched *const s/*!=NULL,out*/,
+	const unsigned count/*>0*/)
+{
+	const size_t size = count*sizeof(struct wsched_worker);
+	unsigned i;
+	if (!count || size/sizeof(struct wsched_worker) != count)
+		return EINVAL;
+	s->workers = (struct wsched_worker*)WSCHED_MALLOC(size);
+	if (!s->workers)
+		return ENOMEM;
+#ifdef WSCHED_CONDVAR_
+	{
+		const int err = pthread_mutex_init(&s->park_lock, (const pthread_mutexattr_t*)0);
+		if (err) {
+			WSCHED_FREE(s->workers);
+			return err;
+		}
+	}
+	{
+		const int err = pthread_cond_init(&s->park_cond, (const pthread_condattr_t*)0);
+		if (err) {
+			(void)pthread_mutex_destroy(&s->park_lock);
+			WSCHED_FREE(s->workers);
+			return err;
+		}
+	}
+#endif
+	s->count = count;
+	s->stop = 0;
+	s->injected = 0;
+	s->inject_lock = 0;
+	mpsc_queue_init(&s->inject);
+	s->sleepers = 0;
+	s->epoch = 0;
+	for (i = 0; i < count; i++) {
+		struct wsched_worker *const w = &s->workers[i];
+		w->top = 0;
+		w->bottom = 0;
+		w->sched = s;
+		w->index = i;
+		w->rnd = i*2654435761u + 1; /* must be non-zero */
+		w->ring = (struct wsched_ring_*)0;
+	}
+	for (i = 0; i < count; i++) {
+		s->workers[i].ring = wsched_ring_alloc_(WSCHED_DEQUE_SIZE);
+		if (!s->workers[i].ring) {
+			wsched_stop_(s, 0);
+			return ENOMEM;
+		}
+	}
+	for (i = 0; i < count; i++) {
+		struct wsched_worker *const w = &s->workers[i];
+#ifdef _WIN32
+		w->thread = CreateThread((LPSECURITY_ATTRIBUTES)0, 0, wsched_thread_, w, 0, (LPDWORD)0);
+		if (!w->thread) {
+			wsched_stop_(s, i);
+			return EAGAIN;
+		}
+#else
+		const int err = pthread_create(&w->thread, (const pthread_attr_t*)0, wsched_thread_, w);
+		if (err) {
+			wsched_stop_(s, i);
+			return err;
+		}
+#endif
+	}
+	return 0;
+}
+
+/* suppress warnings about unreferenced static functions */
+typedef int wsched_ring_alloc_unused_[sizeof(&wsched_ring_alloc_)];
+typedef int wsched_grow_unused_[sizeof(&wsched_grow_)];
+typedef int wsched_steal_unused_[sizeof(&wsched_steal_)];
+typedef int wsched_take_submitted_unused_[sizeof(&wsched_take_submitted_)];
+typedef int wsched_find_unused_[sizeof(&wsched_find_)];
+typedef int wsched_run_unused_[sizeof(&wsched_run_)];
+typedef int wsched_wait_unused_[sizeof(&wsched_wait)];
+typedef int wsched_worker_loop_unused_[sizeof(&wsched_worker_loop_)];
+typedef int wsched_thread_unused_[sizeof(&wsched_thread_)];
+typedef int wsched_stop_unused_[sizeof(&wsched_stop_)];
+typedef int wsched_start_unused_[sizeof(&wsched_start)];
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* WSCHED_H_INCLUDED */